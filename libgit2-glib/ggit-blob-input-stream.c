@@ -0,0 +1,377 @@
+/*
+ * ggit-blob-input-stream.c
+ * This file is part of libgit2-glib
+ *
+ * Copyright (C) 2026 - The libgit2-glib authors
+ *
+ * libgit2-glib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libgit2-glib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ggit-blob-input-stream.h"
+#include "ggit-repository.h"
+#include "ggit-oid.h"
+#include "ggit-error.h"
+
+#include <git2.h>
+#include <string.h>
+
+/**
+ * GgitBlobInputStream:
+ *
+ * Represents a stream reading the contents of a blob.
+ *
+ * When the object database supports it (loose objects), the blob is
+ * inflated incrementally as the stream is read. Packed blobs, and blobs
+ * to which filters need to be applied, are read in full when the stream
+ * is opened and served from memory, so memory use is not bounded for
+ * them.
+ */
+
+typedef struct _GgitBlobInputStreamPrivate
+{
+	GgitRepository *repository;
+
+	git_odb *odb;
+	git_odb_stream *stream;
+
+	/* used when the contents could not be streamed */
+	git_odb_object *object;
+	git_buf filtered;
+	gboolean is_filtered;
+
+	const guchar *data;
+	gsize offset;
+	guint64 size;
+} GgitBlobInputStreamPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GgitBlobInputStream, ggit_blob_input_stream, G_TYPE_INPUT_STREAM)
+
+static void
+free_native (GgitBlobInputStreamPrivate *priv)
+{
+	if (priv->stream != NULL)
+	{
+		git_odb_stream_free (priv->stream);
+		priv->stream = NULL;
+	}
+
+	if (priv->object != NULL)
+	{
+		git_odb_object_free (priv->object);
+		priv->object = NULL;
+	}
+
+	if (priv->odb != NULL)
+	{
+		git_odb_free (priv->odb);
+		priv->odb = NULL;
+	}
+
+#if LIBGIT2_VER_MAJOR > 0 || (LIBGIT2_VER_MAJOR == 0 && LIBGIT2_VER_MINOR >= 28)
+	git_buf_dispose (&priv->filtered);
+#else
+	git_buf_free (&priv->filtered);
+#endif
+
+	priv->data = NULL;
+}
+
+static gssize
+ggit_blob_input_stream_read (GInputStream  *object,
+                             void          *buffer,
+                             gsize          count,
+                             GCancellable  *cancellable,
+                             GError       **error)
+{
+	GgitBlobInputStream *stream = GGIT_BLOB_INPUT_STREAM (object);
+	GgitBlobInputStreamPrivate *priv;
+	gsize n;
+
+	priv = ggit_blob_input_stream_get_instance_private (stream);
+
+	if (g_cancellable_set_error_if_cancelled (cancellable, error))
+	{
+		return -1;
+	}
+
+	if (priv->stream != NULL)
+	{
+		gint ret;
+
+		ret = git_odb_stream_read (priv->stream, buffer, count);
+
+		if (ret < 0)
+		{
+			_ggit_error_set (error, ret);
+			return -1;
+		}
+
+		priv->offset += ret;
+		return ret;
+	}
+
+	if (priv->offset >= priv->size)
+	{
+		return 0;
+	}
+
+	n = MIN (count, priv->size - priv->offset);
+
+	memcpy (buffer, priv->data + priv->offset, n);
+	priv->offset += n;
+
+	return n;
+}
+
+static gboolean
+ggit_blob_input_stream_close (GInputStream  *object,
+                              GCancellable  *cancellable,
+                              GError       **error)
+{
+	GgitBlobInputStream *stream = GGIT_BLOB_INPUT_STREAM (object);
+	GgitBlobInputStreamPrivate *priv;
+
+	priv = ggit_blob_input_stream_get_instance_private (stream);
+
+	free_native (priv);
+
+	return TRUE;
+}
+
+static void
+ggit_blob_input_stream_finalize (GObject *object)
+{
+	GgitBlobInputStream *stream;
+	GgitBlobInputStreamPrivate *priv;
+
+	stream = GGIT_BLOB_INPUT_STREAM (object);
+	priv = ggit_blob_input_stream_get_instance_private (stream);
+
+	free_native (priv);
+	g_clear_object (&priv->repository);
+
+	G_OBJECT_CLASS (ggit_blob_input_stream_parent_class)->finalize (object);
+}
+
+static void
+ggit_blob_input_stream_class_init (GgitBlobInputStreamClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+	GInputStreamClass *stream_class = G_INPUT_STREAM_CLASS (klass);
+
+	object_class->finalize = ggit_blob_input_stream_finalize;
+
+	/* The default read_async runs read_fn in a thread */
+	stream_class->read_fn = ggit_blob_input_stream_read;
+	stream_class->close_fn = ggit_blob_input_stream_close;
+}
+
+static void
+ggit_blob_input_stream_init (GgitBlobInputStream *stream)
+{
+}
+
+static gint
+open_filtered (GgitBlobInputStreamPrivate *priv,
+               const git_oid              *oid,
+               const gchar                *as_path)
+{
+	git_repository *repo;
+	git_filter_list *filters = NULL;
+	git_blob *blob;
+	gint ret;
+
+	repo = _ggit_native_get (priv->repository);
+
+	ret = git_blob_lookup (&blob, repo, oid);
+
+	if (ret != GIT_OK)
+	{
+		return ret;
+	}
+
+	ret = git_filter_list_load (&filters,
+	                            repo,
+	                            blob,
+	                            as_path,
+	                            GIT_FILTER_TO_WORKTREE,
+	                            GIT_FILTER_DEFAULT);
+
+	/* No filters apply to @as_path, stream the raw contents */
+	if (ret == GIT_OK && filters == NULL)
+	{
+		git_blob_free (blob);
+		return GIT_PASSTHROUGH;
+	}
+
+	if (ret == GIT_OK)
+	{
+		ret = git_filter_list_apply_to_blob (&priv->filtered, filters, blob);
+		git_filter_list_free (filters);
+	}
+
+	git_blob_free (blob);
+
+	if (ret == GIT_OK)
+	{
+		priv->is_filtered = TRUE;
+		priv->data = (const guchar *)priv->filtered.ptr;
+		priv->size = priv->filtered.size;
+	}
+
+	return ret;
+}
+
+static gint
+open_raw (GgitBlobInputStreamPrivate *priv,
+          const git_oid              *oid)
+{
+	gint ret;
+	size_t size;
+	git_otype type;
+
+	ret = git_repository_odb (&priv->odb, _ggit_native_get (priv->repository));
+
+	if (ret != GIT_OK)
+	{
+		return ret;
+	}
+
+	ret = git_odb_read_header (&size, &type, priv->odb, oid);
+
+	if (ret != GIT_OK)
+	{
+		return ret;
+	}
+
+	if (type != GIT_OBJ_BLOB)
+	{
+#if (LIBGIT2_VER_MAJOR > 0 && LIBGIT2_VER_MINOR < 8) || (LIBGIT2_VER_MAJOR == 0 && LIBGIT2_VER_MINOR >= 28)
+		git_error_set_str (GIT_ERROR, "the object is not a blob");
+#else
+		giterr_set_str (GIT_ERROR, "the object is not a blob");
+#endif
+		return GIT_EINVALIDSPEC;
+	}
+
+	priv->size = size;
+
+#if LIBGIT2_VER_MAJOR > 0 || (LIBGIT2_VER_MAJOR == 0 && LIBGIT2_VER_MINOR >= 28)
+	ret = git_odb_open_rstream (&priv->stream, &size, &type, priv->odb, oid);
+#else
+	ret = git_odb_open_rstream (&priv->stream, priv->odb, oid);
+#endif
+
+	if (ret == GIT_OK)
+	{
+		return GIT_OK;
+	}
+
+	/* Packed objects cannot be streamed, read them in full */
+	priv->stream = NULL;
+
+	ret = git_odb_read (&priv->object, priv->odb, oid);
+
+	if (ret == GIT_OK)
+	{
+		priv->data = git_odb_object_data (priv->object);
+		priv->size = git_odb_object_size (priv->object);
+	}
+
+	return ret;
+}
+
+GgitBlobInputStream *
+_ggit_blob_input_stream_new (GgitRepository  *repository,
+                             GgitOId         *oid,
+                             const gchar     *as_path,
+                             GError         **error)
+{
+	GgitBlobInputStream *stream;
+	GgitBlobInputStreamPrivate *priv;
+	const git_oid *id;
+	gint ret = GIT_PASSTHROUGH;
+
+	stream = g_object_new (GGIT_TYPE_BLOB_INPUT_STREAM, NULL);
+	priv = ggit_blob_input_stream_get_instance_private (stream);
+
+	priv->repository = g_object_ref (repository);
+	id = _ggit_oid_get_oid (oid);
+
+	if (as_path != NULL)
+	{
+		ret = open_filtered (priv, id, as_path);
+	}
+
+	if (ret == GIT_PASSTHROUGH)
+	{
+		ret = open_raw (priv, id);
+	}
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		g_object_unref (stream);
+
+		return NULL;
+	}
+
+	return stream;
+}
+
+/**
+ * ggit_blob_input_stream_get_size:
+ * @stream: a #GgitBlobInputStream.
+ *
+ * Get the total number of bytes which can be read from @stream. If filters
+ * are applied, this is the size of the filtered contents.
+ *
+ * Returns: the size of the stream contents.
+ *
+ **/
+guint64
+ggit_blob_input_stream_get_size (GgitBlobInputStream *stream)
+{
+	GgitBlobInputStreamPrivate *priv;
+
+	g_return_val_if_fail (GGIT_IS_BLOB_INPUT_STREAM (stream), 0);
+
+	priv = ggit_blob_input_stream_get_instance_private (stream);
+
+	return priv->size;
+}
+
+/**
+ * ggit_blob_input_stream_is_filtered:
+ * @stream: a #GgitBlobInputStream.
+ *
+ * Check whether the contents of @stream have been passed through the
+ * repository filters.
+ *
+ * Returns: %TRUE if filters were applied, %FALSE otherwise.
+ *
+ **/
+gboolean
+ggit_blob_input_stream_is_filtered (GgitBlobInputStream *stream)
+{
+	GgitBlobInputStreamPrivate *priv;
+
+	g_return_val_if_fail (GGIT_IS_BLOB_INPUT_STREAM (stream), FALSE);
+
+	priv = ggit_blob_input_stream_get_instance_private (stream);
+
+	return priv->is_filtered;
+}
+
+/* ex:set ts=8 noet: */
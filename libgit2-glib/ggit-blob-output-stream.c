@@ -39,18 +39,94 @@ typedef struct _GgitBlobOutputStreamPrivate
 	git_writestream *stream;
 	gboolean something_written;
 
+	/* small writes are coalesced before being handed to libgit2 */
+	guint8 *buffer;
+	gsize buffer_size;
+	gsize buffer_len;
+
 	gint ret;
 	GgitOId *oid;
 } GgitBlobOutputStreamPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (GgitBlobOutputStream, ggit_blob_output_stream, G_TYPE_OUTPUT_STREAM)
 
+#define DEFAULT_BUFFER_SIZE (64 * 1024)
+
 enum
 {
 	PROP_0,
-	PROP_REPOSITORY
+	PROP_REPOSITORY,
+	PROP_BUFFER_SIZE
 };
 
+static gboolean
+write_stream (GgitBlobOutputStreamPrivate  *priv,
+              const void                   *buffer,
+              gsize                         count,
+              GError                      **error)
+{
+	if (priv->stream->write (priv->stream, buffer, count) != GIT_OK)
+	{
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+		             "Could not write the blob");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+flush_buffer (GgitBlobOutputStreamPrivate  *priv,
+              GError                      **error)
+{
+	if (priv->buffer_len == 0)
+	{
+		return TRUE;
+	}
+
+	if (!write_stream (priv, priv->buffer, priv->buffer_len, error))
+	{
+		return FALSE;
+	}
+
+	priv->buffer_len = 0;
+	return TRUE;
+}
+
+static gboolean
+write_buffered (GgitBlobOutputStreamPrivate  *priv,
+                const void                   *buffer,
+                gsize                         count,
+                GError                      **error)
+{
+	if (priv->buffer_len + count > priv->buffer_size &&
+	    !flush_buffer (priv, error))
+	{
+		return FALSE;
+	}
+
+	if (count >= priv->buffer_size)
+	{
+		if (!write_stream (priv, buffer, count, error))
+		{
+			return FALSE;
+		}
+	}
+	else
+	{
+		if (priv->buffer == NULL)
+		{
+			priv->buffer = g_malloc (priv->buffer_size);
+		}
+
+		memcpy (priv->buffer + priv->buffer_len, buffer, count);
+		priv->buffer_len += count;
+	}
+
+	priv->something_written = TRUE;
+	return TRUE;
+}
+
 static gboolean
 ggit_blob_output_stream_close (GOutputStream  *object,
                                GCancellable   *cancellable,
@@ -71,6 +147,11 @@ ggit_blob_output_stream_close (GOutputStream  *object,
 		return TRUE;
 	}
 
+	if (!flush_buffer (priv, error))
+	{
+		return FALSE;
+	}
+
 	if (priv->something_written)
 	{
 		git_oid oid;
@@ -100,16 +181,26 @@ ggit_blob_output_stream_close (GOutputStream  *object,
 }
 
 static gboolean
-ggit_blob_output_stream_flush (GOutputStream  *stream,
+ggit_blob_output_stream_flush (GOutputStream  *object,
                                GCancellable   *cancellable,
                                GError        **error)
 {
+	GgitBlobOutputStream *stream = GGIT_BLOB_OUTPUT_STREAM (object);
+	GgitBlobOutputStreamPrivate *priv;
+
+	priv = ggit_blob_output_stream_get_instance_private (stream);
+
 	if (g_cancellable_set_error_if_cancelled (cancellable, error))
 	{
 		return FALSE;
 	}
 
-	return TRUE;
+	if (priv->ret != GIT_OK)
+	{
+		return TRUE;
+	}
+
+	return flush_buffer (priv, error);
 }
 
 static gssize
@@ -141,24 +232,67 @@ ggit_blob_output_stream_write (GOutputStream  *object,
 		return 0;
 	}
 
-	if (count > 0)
+	if (!write_buffered (priv, buffer, count, error))
 	{
-		gint ret = 0;
+		return -1;
+	}
 
-		ret = priv->stream->write (priv->stream, buffer, count);
+	return count;
+}
+
+#if GLIB_CHECK_VERSION (2, 60, 0)
+static gboolean
+ggit_blob_output_stream_writev (GOutputStream        *object,
+                                const GOutputVector  *vectors,
+                                gsize                 n_vectors,
+                                gsize                *bytes_written,
+                                GCancellable         *cancellable,
+                                GError              **error)
+{
+	GgitBlobOutputStream *stream = GGIT_BLOB_OUTPUT_STREAM (object);
+	GgitBlobOutputStreamPrivate *priv;
+	gsize i;
+
+	priv = ggit_blob_output_stream_get_instance_private (stream);
 
-		if (ret == GIT_OK)
+	if (bytes_written != NULL)
+	{
+		*bytes_written = 0;
+	}
+
+	if (g_cancellable_set_error_if_cancelled (cancellable, error))
+	{
+		return FALSE;
+	}
+
+	if (priv->ret != GIT_OK)
+	{
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+		             "Could not create write stream");
+		return FALSE;
+	}
+
+	for (i = 0; i < n_vectors; ++i)
+	{
+		if (vectors[i].size == 0)
 		{
-			priv->something_written = TRUE;
-			return count;
+			continue;
 		}
-	}
 
-	g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
-	             "Could not write the blob");
+		if (!write_buffered (priv, vectors[i].buffer, vectors[i].size, error))
+		{
+			return FALSE;
+		}
 
-	return -1;
+		if (bytes_written != NULL)
+		{
+			*bytes_written += vectors[i].size;
+		}
+	}
+
+	return TRUE;
 }
+#endif
 
 static void
 ggit_blob_output_stream_finalize (GObject *object)
@@ -180,6 +314,7 @@ ggit_blob_output_stream_finalize (GObject *object)
 		priv->stream->free (priv->stream);
 	}
 
+	g_free (priv->buffer);
 	g_clear_object (&priv->repository);
 
 	G_OBJECT_CLASS (ggit_blob_output_stream_parent_class)->finalize (object);
@@ -202,6 +337,9 @@ ggit_blob_output_stream_set_property (GObject      *object,
 		g_clear_object (&priv->repository);
 		priv->repository = g_value_dup_object (value);
 		break;
+	case PROP_BUFFER_SIZE:
+		ggit_blob_output_stream_set_buffer_size (stream, g_value_get_uint (value));
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -214,8 +352,16 @@ ggit_blob_output_stream_get_property (GObject    *object,
                                       GValue     *value,
                                       GParamSpec *pspec)
 {
+	GgitBlobOutputStream *stream = GGIT_BLOB_OUTPUT_STREAM (object);
+	GgitBlobOutputStreamPrivate *priv;
+
+	priv = ggit_blob_output_stream_get_instance_private (stream);
+
 	switch (prop_id)
 	{
+	case PROP_BUFFER_SIZE:
+		g_value_set_uint (value, priv->buffer_size);
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -252,6 +398,14 @@ ggit_blob_output_stream_class_init (GgitBlobOutputStreamClass *klass)
 	stream_class->write_fn = ggit_blob_output_stream_write;
 	stream_class->close_fn = ggit_blob_output_stream_close;
 	stream_class->flush = ggit_blob_output_stream_flush;
+#if GLIB_CHECK_VERSION (2, 60, 0)
+	stream_class->writev_fn = ggit_blob_output_stream_writev;
+#endif
+
+	/* The default write_async, writev_async and close_async implementations
+	 * run the synchronous versions in a thread, which moves compression and
+	 * hashing off the calling thread.
+	 */
 
 	g_object_class_install_property (object_class,
 	                                 PROP_REPOSITORY,
@@ -262,11 +416,27 @@ ggit_blob_output_stream_class_init (GgitBlobOutputStreamClass *klass)
 	                                                      G_PARAM_WRITABLE |
 	                                                      G_PARAM_CONSTRUCT_ONLY |
 	                                                      G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property (object_class,
+	                                 PROP_BUFFER_SIZE,
+	                                 g_param_spec_uint ("buffer-size",
+	                                                    "Buffer size",
+	                                                    "Buffer size",
+	                                                    0,
+	                                                    G_MAXUINT,
+	                                                    DEFAULT_BUFFER_SIZE,
+	                                                    G_PARAM_READWRITE |
+	                                                    G_PARAM_STATIC_STRINGS));
 }
 
 static void
 ggit_blob_output_stream_init (GgitBlobOutputStream *stream)
 {
+	GgitBlobOutputStreamPrivate *priv;
+
+	priv = ggit_blob_output_stream_get_instance_private (stream);
+
+	priv->buffer_size = DEFAULT_BUFFER_SIZE;
 }
 
 GgitBlobOutputStream *
@@ -308,4 +478,57 @@ ggit_blob_output_stream_get_id (GgitBlobOutputStream  *stream,
 	return ggit_oid_copy (priv->oid);
 }
 
+/**
+ * ggit_blob_output_stream_set_buffer_size:
+ * @stream: a #GgitBlobOutputStream.
+ * @size: the size of the write buffer in bytes.
+ *
+ * Set the size of the buffer used to coalesce small writes before they are
+ * compressed. Writes larger than the buffer are passed through directly.
+ * A size of 0 disables buffering. The buffer size can only be changed
+ * before anything has been written to @stream.
+ *
+ **/
+void
+ggit_blob_output_stream_set_buffer_size (GgitBlobOutputStream *stream,
+                                         guint                 size)
+{
+	GgitBlobOutputStreamPrivate *priv;
+
+	g_return_if_fail (GGIT_IS_BLOB_OUTPUT_STREAM (stream));
+
+	priv = ggit_blob_output_stream_get_instance_private (stream);
+
+	g_return_if_fail (priv->buffer_len == 0);
+
+	if (priv->buffer_size != size)
+	{
+		g_clear_pointer (&priv->buffer, g_free);
+		priv->buffer_size = size;
+
+		g_object_notify (G_OBJECT (stream), "buffer-size");
+	}
+}
+
+/**
+ * ggit_blob_output_stream_get_buffer_size:
+ * @stream: a #GgitBlobOutputStream.
+ *
+ * Get the size of the buffer used to coalesce small writes.
+ *
+ * Returns: the size of the write buffer in bytes.
+ *
+ **/
+guint
+ggit_blob_output_stream_get_buffer_size (GgitBlobOutputStream *stream)
+{
+	GgitBlobOutputStreamPrivate *priv;
+
+	g_return_val_if_fail (GGIT_IS_BLOB_OUTPUT_STREAM (stream), 0);
+
+	priv = ggit_blob_output_stream_get_instance_private (stream);
+
+	return priv->buffer_size;
+}
+
 /* ex:set ts=8 noet: */
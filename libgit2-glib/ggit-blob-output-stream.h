@@ -49,6 +49,11 @@ GgitBlobOutputStream *_ggit_blob_output_stream_new              (GgitRepository
 GgitOId               *ggit_blob_output_stream_get_id           (GgitBlobOutputStream  *stream,
                                                                  GError               **error);
 
+void                   ggit_blob_output_stream_set_buffer_size  (GgitBlobOutputStream  *stream,
+                                                                 guint                  size);
+
+guint                  ggit_blob_output_stream_get_buffer_size  (GgitBlobOutputStream  *stream);
+
 G_END_DECLS
 
 #endif /* __GGIT_BLOB_OUTPUT_STREAM_H__ */
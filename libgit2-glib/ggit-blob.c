@@ -96,6 +96,33 @@ ggit_blob_get_raw_content (GgitBlob *blob,
 	return (const guchar *)git_blob_rawcontent (b);
 }
 
+/**
+ * ggit_blob_get_content_bytes:
+ * @blob: a #GgitBlob.
+ *
+ * Gets the raw contents of @blob as a #GBytes. The contents are not copied,
+ * instead the returned #GBytes keeps a reference on @blob for as long as it
+ * is alive. This makes it possible to pass the contents around (for example
+ * to a #GOutputStream or a language binding) without copying them.
+ *
+ * Returns: (transfer full): a #GBytes with the blob content.
+ *
+ **/
+GBytes *
+ggit_blob_get_content_bytes (GgitBlob *blob)
+{
+	git_blob *b;
+
+	g_return_val_if_fail (GGIT_IS_BLOB (blob), NULL);
+
+	b = _ggit_native_get (blob);
+
+	return g_bytes_new_with_free_func (git_blob_rawcontent (b),
+	                                   git_blob_rawsize (b),
+	                                   g_object_unref,
+	                                   g_object_ref (blob));
+}
+
 /**
  * ggit_blob_is_binary:
  * @blob: a #GgitBlob.
@@ -32,7 +32,14 @@ struct _GgitDiffLine {
 	gint new_lineno;
 	gint num_lines;
 	gint64 content_offset;
+
+	/* A borrowed line points into the buffers of libgit2 and does not
+	 * own @content nor @encoding.
+	 */
+	gboolean borrowed;
 	GBytes *content;
+	const guint8 *data;
+	gsize size;
 
 	gchar *text;
 	gchar *encoding;
@@ -41,6 +48,16 @@ struct _GgitDiffLine {
 G_DEFINE_BOXED_TYPE (GgitDiffLine, ggit_diff_line,
                      ggit_diff_line_ref, ggit_diff_line_unref)
 
+static void
+set_line (GgitDiffLine        *gline,
+          const git_diff_line *line)
+{
+	gline->origin = (GgitDiffLineType)line->origin;
+	gline->old_lineno = line->old_lineno;
+	gline->new_lineno = line->new_lineno;
+	gline->num_lines = line->num_lines;
+	gline->content_offset = line->content_offset;
+}
 
 GgitDiffLine *
 _ggit_diff_line_wrap (const git_diff_line *line,
@@ -50,19 +67,75 @@ _ggit_diff_line_wrap (const git_diff_line *line,
 
 	g_return_val_if_fail (line != NULL, NULL);
 
-	gline = g_slice_new (GgitDiffLine);
+	gline = g_slice_new0 (GgitDiffLine);
 	gline->ref_count = 1;
-	gline->origin = (GgitDiffLineType)line->origin;
-	gline->old_lineno = line->old_lineno;
-	gline->new_lineno = line->new_lineno;
-	gline->content_offset = line->content_offset;
+	set_line (gline, line);
+
 	gline->content = g_bytes_new (line->content, line->content_len);
+	gline->data = g_bytes_get_data (gline->content, &gline->size);
 	gline->encoding = g_strdup (encoding);
-	gline->text = NULL;
 
 	return gline;
 }
 
+GgitDiffLine *
+_ggit_diff_line_new_borrowed (void)
+{
+	GgitDiffLine *gline;
+
+	gline = g_slice_new0 (GgitDiffLine);
+	gline->ref_count = 1;
+	gline->borrowed = TRUE;
+
+	return gline;
+}
+
+void
+_ggit_diff_line_set_borrowed (GgitDiffLine        *gline,
+                              const git_diff_line *line,
+                              const gchar         *encoding)
+{
+	g_return_if_fail (gline != NULL && gline->borrowed);
+	g_return_if_fail (line != NULL);
+
+	set_line (gline, line);
+
+	gline->data = (const guint8 *)line->content;
+	gline->size = line->content_len;
+	gline->encoding = (gchar *)encoding;
+
+	g_clear_pointer (&gline->text, g_free);
+}
+
+/* Called after the callback which received the borrowed @gline. If the
+ * callback kept a reference, the line is turned into a regular line owning
+ * its contents so that the reference stays valid, and %FALSE is returned
+ * since @gline can no longer be reused.
+ */
+gboolean
+_ggit_diff_line_release_borrowed (GgitDiffLine *gline)
+{
+	g_return_val_if_fail (gline != NULL && gline->borrowed, FALSE);
+
+	if (g_atomic_int_get (&gline->ref_count) == 1)
+	{
+		gline->data = NULL;
+		gline->size = 0;
+		gline->encoding = NULL;
+
+		return TRUE;
+	}
+
+	gline->content = g_bytes_new (gline->data, gline->size);
+	gline->data = g_bytes_get_data (gline->content, &gline->size);
+	gline->encoding = g_strdup (gline->encoding);
+	gline->borrowed = FALSE;
+
+	ggit_diff_line_unref (gline);
+
+	return FALSE;
+}
+
 /**
  * ggit_diff_line_ref:
  * @line: a #GgitDiffLine.
@@ -96,12 +169,58 @@ ggit_diff_line_unref (GgitDiffLine *line)
 
 	if (g_atomic_int_dec_and_test (&line->ref_count))
 	{
-		g_bytes_unref (line->content);
+		if (!line->borrowed)
+		{
+			g_bytes_unref (line->content);
+			g_free (line->encoding);
+		}
+
 		g_free (line->text);
 		g_slice_free (GgitDiffLine, line);
 	}
 }
 
+/**
+ * ggit_diff_line_copy:
+ * @line: a #GgitDiffLine.
+ *
+ * Copies @line. Lines passed to the line callback of
+ * ggit_diff_foreach_full() with %GGIT_DIFF_FOREACH_BORROW_LINES are only
+ * valid during the callback, use this function to keep them.
+ *
+ * Returns: (transfer full): a newly allocated #GgitDiffLine.
+ **/
+GgitDiffLine *
+ggit_diff_line_copy (GgitDiffLine *line)
+{
+	GgitDiffLine *copy;
+
+	g_return_val_if_fail (line != NULL, NULL);
+
+	copy = g_slice_new0 (GgitDiffLine);
+	copy->ref_count = 1;
+	copy->origin = line->origin;
+	copy->old_lineno = line->old_lineno;
+	copy->new_lineno = line->new_lineno;
+	copy->num_lines = line->num_lines;
+	copy->content_offset = line->content_offset;
+
+	if (line->borrowed)
+	{
+		copy->content = g_bytes_new (line->data, line->size);
+	}
+	else
+	{
+		copy->content = g_bytes_ref (line->content);
+	}
+
+	copy->data = g_bytes_get_data (copy->content, &copy->size);
+	copy->encoding = g_strdup (line->encoding);
+	copy->text = g_strdup (line->text);
+
+	return copy;
+}
+
 /**
  * ggit_diff_line_get_origin:
  * @line: a #GgitDiffLine.
@@ -183,10 +302,10 @@ ggit_diff_line_get_content (GgitDiffLine *line,
 
 	if (length)
 	{
-		*length = g_bytes_get_size (line->content);
+		*length = line->size;
 	}
 
-	return g_bytes_get_data (line->content, NULL);
+	return line->data;
 }
 
 /**
@@ -205,12 +324,8 @@ ggit_diff_line_get_text (GgitDiffLine *line)
 
 	if (line->text == NULL)
 	{
-		const gchar *content;
-		gsize content_len;
-
-		content = g_bytes_get_data (line->content, &content_len);
-		line->text = ggit_convert_utf8 (content,
-		                                content_len,
+		line->text = ggit_convert_utf8 ((const gchar *)line->data,
+		                                line->size,
 		                                line->encoding);
 	}
 
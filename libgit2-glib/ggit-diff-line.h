@@ -35,6 +35,16 @@ GType             ggit_diff_line_get_type           (void) G_GNUC_CONST;
 GgitDiffLine     *_ggit_diff_line_wrap              (const git_diff_line *line,
                                                      const gchar         *encoding);
 
+GgitDiffLine     *_ggit_diff_line_new_borrowed      (void);
+
+void              _ggit_diff_line_set_borrowed      (GgitDiffLine        *gline,
+                                                     const git_diff_line *line,
+                                                     const gchar         *encoding);
+
+gboolean          _ggit_diff_line_release_borrowed  (GgitDiffLine        *gline);
+
+GgitDiffLine     *ggit_diff_line_copy               (GgitDiffLine        *line);
+
 GgitDiffLine     *ggit_diff_line_ref                (GgitDiffLine        *line);
 void              ggit_diff_line_unref              (GgitDiffLine        *line);
 
@@ -54,8 +54,14 @@ typedef struct {
 
 	gpointer user_data;
 
-	GHashTable *cached_deltas;
-	GHashTable *cached_hunks;
+	GPtrArray *deltas;
+	GPtrArray *hunks;
+	const git_diff_delta *current_delta;
+	git_diff_hunk current_hunk;
+	gboolean has_current_hunk;
+
+	gboolean borrow_lines;
+	GgitDiffLine *borrowed_line;
 
 	GgitDiffFileCallback file_cb;
 	GgitDiffBinaryCallback binary_cb;
@@ -76,101 +82,105 @@ wrapper_data_init (CallbackWrapperData *data)
 {
 	if (data != NULL)
 	{
-		data->cached_deltas =
-			g_hash_table_new_full (g_str_hash,
-			                       g_str_equal,
-			                       g_free,
-			                       (GDestroyNotify) ggit_diff_delta_unref);
-
-		data->cached_hunks =
-			g_hash_table_new_full (g_str_hash,
-			                       g_str_equal,
-			                       g_free,
-			                       (GDestroyNotify) ggit_diff_hunk_unref);
+		data->deltas = g_ptr_array_new_with_free_func ((GDestroyNotify) ggit_diff_delta_unref);
+		data->hunks = g_ptr_array_new_with_free_func ((GDestroyNotify) ggit_diff_hunk_unref);
 	}
 }
 
+static void
+wrapper_data_clear (CallbackWrapperData *data)
+{
+	g_ptr_array_unref (data->deltas);
+	g_ptr_array_unref (data->hunks);
+
+	if (data->borrowed_line != NULL)
+	{
+		ggit_diff_line_unref (data->borrowed_line);
+	}
+}
+
+/* libgit2 reports a delta, then its hunks, then the lines of each hunk.
+ * Deltas stay at the same address while they are being reported, so
+ * comparing with the last wrapped delta is enough to reuse its wrapper.
+ * Hunks however are reported from a single slot which is overwritten for
+ * every hunk of a file, so they are compared by value instead.
+ */
 static GgitDiffDelta *
 wrap_diff_delta_cached (CallbackWrapperData  *data,
                         const git_diff_delta *delta)
 {
 	GgitDiffDelta *gdelta;
-	gchar *key;
 
 	if (!delta)
 	{
 		return NULL;
 	}
 
-	if (delta->old_file.path != NULL)
+	if (delta == data->current_delta)
 	{
-		key = g_strdup_printf ("%s%s",
-		                       delta->old_file.path,
-		                       git_oid_tostr_s (&delta->old_file.id));
-	}
-	else
-	{
-		key = g_strdup_printf ("%s%s",
-		                       delta->new_file.path,
-		                       git_oid_tostr_s (&delta->new_file.id));
+		return g_ptr_array_index (data->deltas, data->deltas->len - 1);
 	}
 
-	gdelta = g_hash_table_lookup (data->cached_deltas, key);
+	gdelta = _ggit_diff_delta_wrap (delta);
 
-	if (!gdelta)
-	{
-		gdelta = _ggit_diff_delta_wrap (delta);
-		g_hash_table_insert (data->cached_deltas, key, gdelta);
-	}
-	else
-	{
-		g_free (key);
-	}
+	/* Keep the wrappers alive for the whole iteration, as before */
+	g_ptr_array_add (data->deltas, gdelta);
+
+	data->current_delta = delta;
+	data->has_current_hunk = FALSE;
 
 	return gdelta;
 }
 
+static gboolean
+diff_hunk_equal (const git_diff_hunk *a,
+                 const git_diff_hunk *b)
+{
+	return a->old_start == b->old_start &&
+	       a->old_lines == b->old_lines &&
+	       a->new_start == b->new_start &&
+	       a->new_lines == b->new_lines;
+}
+
 static GgitDiffHunk *
-wrap_diff_hunk_cached (CallbackWrapperData *data,
-                       const git_diff_delta *delta,
-                       const git_diff_hunk *hunk)
+wrap_diff_hunk_new (CallbackWrapperData  *data,
+                    const git_diff_delta *delta,
+                    const git_diff_hunk  *hunk)
 {
 	GgitDiffHunk *ghunk;
-	gchar *key;
 
 	if (!delta || !hunk)
 	{
 		return NULL;
 	}
 
-	if (delta->old_file.path != NULL)
-	{
-		key = g_strdup_printf ("%s%s%s",
-		                       delta->old_file.path,
-		                       git_oid_tostr_s (&delta->old_file.id),
-		                       hunk->header);
-	}
-	else
-	{
-		key = g_strdup_printf ("%s%s%s",
-		                       delta->new_file.path,
-		                       git_oid_tostr_s (&delta->new_file.id),
-		                       hunk->header);
-	}
+	ghunk = _ggit_diff_hunk_wrap (hunk);
+	g_ptr_array_add (data->hunks, ghunk);
 
-	ghunk = g_hash_table_lookup (data->cached_hunks, key);
+	data->current_hunk = *hunk;
+	data->has_current_hunk = TRUE;
 
-	if (!ghunk)
+	return ghunk;
+}
+
+static GgitDiffHunk *
+wrap_diff_hunk_cached (CallbackWrapperData  *data,
+                       const git_diff_delta *delta,
+                       const git_diff_hunk  *hunk)
+{
+	if (!delta || !hunk)
 	{
-		ghunk = _ggit_diff_hunk_wrap (hunk);
-		g_hash_table_insert (data->cached_hunks, g_strdup (key), ghunk);
+		return NULL;
 	}
-	else
+
+	if (delta == data->current_delta &&
+	    data->has_current_hunk &&
+	    diff_hunk_equal (hunk, &data->current_hunk))
 	{
-		g_free (key);
+		return g_ptr_array_index (data->hunks, data->hunks->len - 1);
 	}
 
-	return ghunk;
+	return wrap_diff_hunk_new (data, delta, hunk);
 }
 
 static gint
@@ -258,7 +268,7 @@ ggit_diff_hunk_callback_wrapper (const git_diff_delta *delta,
 	gint ret;
 
 	gdelta = wrap_diff_delta_cached (data, delta);
-	ghunk = wrap_diff_hunk_cached (data, delta, hunk);
+	ghunk = wrap_diff_hunk_new (data, delta, hunk);
 
 	ret = data->hunk_cb (gdelta, ghunk, data->user_data);
 
@@ -293,11 +303,36 @@ ggit_diff_line_callback_wrapper (const git_diff_delta *delta,
 	gdelta = wrap_diff_delta_cached (data, delta);
 	ghunk = wrap_diff_hunk_cached (data, delta, hunk);
 
-	gline = line == NULL ? NULL : _ggit_diff_line_wrap (line, encoding);
+	if (line == NULL)
+	{
+		gline = NULL;
+	}
+	else if (data->borrow_lines)
+	{
+		/* The same line is reused for all the callbacks */
+		if (data->borrowed_line == NULL)
+		{
+			data->borrowed_line = _ggit_diff_line_new_borrowed ();
+		}
+
+		gline = data->borrowed_line;
+		_ggit_diff_line_set_borrowed (gline, line, encoding);
+	}
+	else
+	{
+		gline = _ggit_diff_line_wrap (line, encoding);
+	}
 
 	ret = data->line_cb (gdelta, ghunk, gline, data->user_data);
 
-	if (gline != NULL)
+	if (gline != NULL && gline == data->borrowed_line)
+	{
+		if (!_ggit_diff_line_release_borrowed (gline))
+		{
+			data->borrowed_line = NULL;
+		}
+	}
+	else if (gline != NULL)
 	{
 		ggit_diff_line_unref (gline);
 	}
@@ -661,6 +696,46 @@ ggit_diff_foreach (GgitDiff              *diff,
                    GgitDiffLineCallback   line_cb,
                    gpointer               user_data,
                    GError               **error)
+{
+	ggit_diff_foreach_full (diff,
+	                        GGIT_DIFF_FOREACH_DEFAULT,
+	                        file_cb,
+	                        binary_cb,
+	                        hunk_cb,
+	                        line_cb,
+	                        user_data,
+	                        error);
+}
+
+/**
+ * ggit_diff_foreach_full:
+ * @diff: a #GgitDiff.
+ * @flags: a #GgitDiffForeachFlags.
+ * @file_cb: (allow-none) (scope call) (closure user_data):
+ *  a #GgitDiffFileCallback.
+ * @binary_cb: (allow-none) (scope call) (closure user_data):
+ *  a #GgitDiffBinaryCallback.
+ * @hunk_cb: (allow-none) (scope call) (closure user_data):
+ *  a #GgitDiffHunkCallback.
+ * @line_cb: (allow-none) (scope call) (closure user_data):
+ *  a #GgitDiffLineCallback.
+ * @user_data: callback user data.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Iterates over the diff like ggit_diff_foreach(). With
+ * %GGIT_DIFF_FOREACH_BORROW_LINES, the lines passed to @line_cb point
+ * directly into the diff buffers instead of copying each line, and must
+ * be copied with ggit_diff_line_copy() to be used after @line_cb returns.
+ */
+void
+ggit_diff_foreach_full (GgitDiff               *diff,
+                        GgitDiffForeachFlags    flags,
+                        GgitDiffFileCallback    file_cb,
+                        GgitDiffBinaryCallback  binary_cb,
+                        GgitDiffHunkCallback    hunk_cb,
+                        GgitDiffLineCallback    line_cb,
+                        gpointer                user_data,
+                        GError                **error)
 {
 	gint ret;
 	CallbackWrapperData wrapper_data = { 0 };
@@ -677,7 +752,7 @@ ggit_diff_foreach (GgitDiff              *diff,
 
 	wrapper_data.user_data = user_data;
 	wrapper_data.diff = diff;
-
+	wrapper_data.borrow_lines = (flags & GGIT_DIFF_FOREACH_BORROW_LINES) != 0;
 
 	if (file_cb != NULL)
 	{
@@ -708,8 +783,7 @@ ggit_diff_foreach (GgitDiff              *diff,
 	                        real_hunk_cb, real_line_cb,
 	                        &wrapper_data);
 
-	g_hash_table_destroy (wrapper_data.cached_deltas);
-	g_hash_table_destroy (wrapper_data.cached_hunks);
+	wrapper_data_clear (&wrapper_data);
 
 	if (ret != GIT_OK)
 	{
@@ -752,8 +826,7 @@ ggit_diff_print (GgitDiff              *diff,
 	                      ggit_diff_line_callback_wrapper,
 	                      &wrapper_data);
 
-	g_hash_table_destroy (wrapper_data.cached_deltas);
-	g_hash_table_destroy (wrapper_data.cached_hunks);
+	wrapper_data_clear (&wrapper_data);
 
 	if (ret != GIT_OK)
 	{
@@ -938,8 +1011,7 @@ ggit_diff_blobs (GgitBlob              *old_blob,
 	                      real_hunk_cb, real_line_cb,
 	                      &wrapper_data);
 
-	g_hash_table_destroy (wrapper_data.cached_deltas);
-	g_hash_table_destroy (wrapper_data.cached_hunks);
+	wrapper_data_clear (&wrapper_data);
 
 	if (ret != GIT_OK)
 	{
@@ -1120,8 +1192,7 @@ ggit_diff_blob_to_buffer (GgitBlob                *old_blob,
 	                               real_hunk_cb, real_line_cb,
 	                               &wrapper_data);
 
-	g_hash_table_destroy (wrapper_data.cached_deltas);
-	g_hash_table_destroy (wrapper_data.cached_hunks);
+	wrapper_data_clear (&wrapper_data);
 
 	if (ret != GIT_OK)
 	{
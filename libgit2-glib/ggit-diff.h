@@ -86,6 +86,14 @@ void           ggit_diff_foreach                   (GgitDiff              *diff,
                                                     GgitDiffLineCallback   line_cb,
                                                     gpointer               user_data,
                                                     GError               **error);
+void           ggit_diff_foreach_full              (GgitDiff               *diff,
+                                                    GgitDiffForeachFlags    flags,
+                                                    GgitDiffFileCallback    file_cb,
+                                                    GgitDiffBinaryCallback  binary_cb,
+                                                    GgitDiffHunkCallback    hunk_cb,
+                                                    GgitDiffLineCallback    line_cb,
+                                                    gpointer                user_data,
+                                                    GError                **error);
 void           ggit_diff_print                     (GgitDiff              *diff,
                                                     GgitDiffFormatType     type,
                                                     GgitDiffLineCallback   print_cb,
@@ -0,0 +1,750 @@
+/*
+ * ggit-fetch-scheduler.c
+ * This file is part of libgit2-glib
+ *
+ * Copyright (C) 2026 - The libgit2-glib authors
+ *
+ * libgit2-glib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libgit2-glib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <git2.h>
+#include <gio/gio.h>
+
+#include "ggit-fetch-scheduler.h"
+#include "ggit-error.h"
+#include "ggit-fetch-options.h"
+#include "ggit-native.h"
+#include "ggit-remote-callbacks.h"
+#include "ggit-transfer-progress.h"
+
+/**
+ * GgitFetchScheduler:
+ *
+ * Fetches a set of remotes, possibly belonging to different repositories,
+ * on a bounded pool of worker threads.
+ *
+ * A libgit2 repository must not be used from several threads at the same
+ * time, so all remotes belonging to the same repository are fetched one
+ * after the other on the same worker, while remotes of different
+ * repositories are fetched in parallel.
+ */
+struct _GgitFetchScheduler
+{
+	GObject parent_instance;
+
+	guint max_workers;
+	GPtrArray *jobs;
+
+	gint running;
+};
+
+typedef struct _RunData RunData;
+
+typedef struct
+{
+	GgitRemote *remote;
+	gchar **specs;
+	GgitFetchOptions *fetch_options;
+	gchar *message;
+
+	/* Protected by RunData.mutex */
+	git_transfer_progress progress;
+
+	RunData *run;
+} FetchJob;
+
+struct _RunData
+{
+	gint ref_count;
+
+	GgitFetchScheduler *scheduler;
+	GMainContext *context;
+	GCancellable *cancellable;
+	GPtrArray *jobs;
+
+	GMutex mutex;
+	GError *error;
+	gboolean progress_pending;
+};
+
+typedef struct
+{
+	RunData *run;
+	GgitRemote *remote;
+	GError *error;
+} RemoteFinishedData;
+
+enum
+{
+	PROP_0,
+	PROP_MAX_WORKERS
+};
+
+enum
+{
+	TRANSFER_PROGRESS,
+	REMOTE_FINISHED,
+	NUM_SIGNALS
+};
+
+static guint signals[NUM_SIGNALS] = {0,};
+
+G_DEFINE_TYPE (GgitFetchScheduler, ggit_fetch_scheduler, G_TYPE_OBJECT)
+
+static void
+fetch_job_free (FetchJob *job)
+{
+	g_object_unref (job->remote);
+	g_strfreev (job->specs);
+
+	if (job->fetch_options != NULL)
+	{
+		ggit_fetch_options_free (job->fetch_options);
+	}
+
+	g_free (job->message);
+
+	g_slice_free (FetchJob, job);
+}
+
+static RunData *
+run_data_ref (RunData *run)
+{
+	g_atomic_int_inc (&run->ref_count);
+	return run;
+}
+
+static void
+run_data_unref (RunData *run)
+{
+	if (g_atomic_int_dec_and_test (&run->ref_count))
+	{
+		g_object_unref (run->scheduler);
+		g_main_context_unref (run->context);
+		g_clear_object (&run->cancellable);
+		g_ptr_array_unref (run->jobs);
+
+		g_mutex_clear (&run->mutex);
+		g_clear_error (&run->error);
+
+		g_slice_free (RunData, run);
+	}
+}
+
+static void
+ggit_fetch_scheduler_finalize (GObject *object)
+{
+	GgitFetchScheduler *scheduler = GGIT_FETCH_SCHEDULER (object);
+
+	g_ptr_array_unref (scheduler->jobs);
+
+	G_OBJECT_CLASS (ggit_fetch_scheduler_parent_class)->finalize (object);
+}
+
+static void
+ggit_fetch_scheduler_get_property (GObject    *object,
+                                   guint       prop_id,
+                                   GValue     *value,
+                                   GParamSpec *pspec)
+{
+	GgitFetchScheduler *scheduler = GGIT_FETCH_SCHEDULER (object);
+
+	switch (prop_id)
+	{
+		case PROP_MAX_WORKERS:
+			g_value_set_uint (value, scheduler->max_workers);
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+ggit_fetch_scheduler_set_property (GObject      *object,
+                                   guint         prop_id,
+                                   const GValue *value,
+                                   GParamSpec   *pspec)
+{
+	GgitFetchScheduler *scheduler = GGIT_FETCH_SCHEDULER (object);
+
+	switch (prop_id)
+	{
+		case PROP_MAX_WORKERS:
+			scheduler->max_workers = g_value_get_uint (value);
+
+			if (scheduler->max_workers == 0)
+			{
+				scheduler->max_workers = g_get_num_processors ();
+			}
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+ggit_fetch_scheduler_class_init (GgitFetchSchedulerClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->finalize = ggit_fetch_scheduler_finalize;
+	object_class->get_property = ggit_fetch_scheduler_get_property;
+	object_class->set_property = ggit_fetch_scheduler_set_property;
+
+	g_object_class_install_property (object_class,
+	                                 PROP_MAX_WORKERS,
+	                                 g_param_spec_uint ("max-workers",
+	                                                    "Max workers",
+	                                                    "The maximum number of concurrent fetches, or 0 for the number of processors",
+	                                                    0,
+	                                                    G_MAXINT,
+	                                                    0,
+	                                                    G_PARAM_READWRITE |
+	                                                    G_PARAM_CONSTRUCT_ONLY |
+	                                                    G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * GgitFetchScheduler::transfer-progress:
+	 * @scheduler: a #GgitFetchScheduler.
+	 * @stats: the transfer progress summed over all remotes of the run.
+	 *
+	 * Emitted in the thread-default main context of the thread which
+	 * started the run whenever one of the remotes reports progress.
+	 * Updates are coalesced, so not every individual update of the
+	 * workers results in an emission.
+	 */
+	signals[TRANSFER_PROGRESS] =
+		g_signal_new ("transfer-progress",
+		              G_TYPE_FROM_CLASS (object_class),
+		              G_SIGNAL_RUN_LAST,
+		              0,
+		              NULL, NULL,
+		              NULL,
+		              G_TYPE_NONE,
+		              1,
+		              GGIT_TYPE_TRANSFER_PROGRESS);
+
+	/**
+	 * GgitFetchScheduler::remote-finished:
+	 * @scheduler: a #GgitFetchScheduler.
+	 * @remote: the #GgitRemote which was fetched.
+	 * @error: (allow-none): the error if the fetch failed, or %NULL.
+	 *
+	 * Emitted in the thread-default main context of the thread which
+	 * started the run when fetching @remote has finished.
+	 */
+	signals[REMOTE_FINISHED] =
+		g_signal_new ("remote-finished",
+		              G_TYPE_FROM_CLASS (object_class),
+		              G_SIGNAL_RUN_LAST,
+		              0,
+		              NULL, NULL,
+		              NULL,
+		              G_TYPE_NONE,
+		              2,
+		              GGIT_TYPE_REMOTE,
+		              G_TYPE_ERROR);
+}
+
+static void
+ggit_fetch_scheduler_init (GgitFetchScheduler *scheduler)
+{
+	scheduler->jobs = g_ptr_array_new_with_free_func ((GDestroyNotify)fetch_job_free);
+}
+
+/**
+ * ggit_fetch_scheduler_new:
+ * @max_workers: the maximum number of remotes fetched at the same time,
+ *               or 0 to use the number of processors.
+ *
+ * Creates a new #GgitFetchScheduler.
+ *
+ * Returns: (transfer full): a newly allocated #GgitFetchScheduler.
+ */
+GgitFetchScheduler *
+ggit_fetch_scheduler_new (guint max_workers)
+{
+	return g_object_new (GGIT_TYPE_FETCH_SCHEDULER,
+	                     "max-workers", max_workers,
+	                     NULL);
+}
+
+/**
+ * ggit_fetch_scheduler_get_max_workers:
+ * @scheduler: a #GgitFetchScheduler.
+ *
+ * Gets the maximum number of remotes fetched at the same time.
+ *
+ * Returns: the maximum number of workers.
+ */
+guint
+ggit_fetch_scheduler_get_max_workers (GgitFetchScheduler *scheduler)
+{
+	g_return_val_if_fail (GGIT_IS_FETCH_SCHEDULER (scheduler), 0);
+
+	return scheduler->max_workers;
+}
+
+/**
+ * ggit_fetch_scheduler_add:
+ * @scheduler: a #GgitFetchScheduler.
+ * @remote: a #GgitRemote.
+ * @specs: (array zero-terminated=1) (allow-none): the ref specs to fetch,
+ *         or %NULL to use the base refspecs of @remote.
+ * @fetch_options: (allow-none): a #GgitFetchOptions.
+ * @message: (allow-none): the message to insert into the reflogs, or %NULL
+ *           for the default.
+ *
+ * Adds @remote to the set of remotes fetched by the next run of
+ * @scheduler. Fetching downloads the packfile and updates the tips, just
+ * like `git fetch`.
+ */
+void
+ggit_fetch_scheduler_add (GgitFetchScheduler   *scheduler,
+                          GgitRemote           *remote,
+                          const gchar * const  *specs,
+                          GgitFetchOptions     *fetch_options,
+                          const gchar          *message)
+{
+	FetchJob *job;
+
+	g_return_if_fail (GGIT_IS_FETCH_SCHEDULER (scheduler));
+	g_return_if_fail (GGIT_IS_REMOTE (remote));
+
+	job = g_slice_new0 (FetchJob);
+	job->remote = g_object_ref (remote);
+	job->specs = g_strdupv ((gchar **)specs);
+	job->fetch_options = fetch_options != NULL ? ggit_fetch_options_copy (fetch_options) : NULL;
+	job->message = g_strdup (message);
+
+	g_ptr_array_add (scheduler->jobs, job);
+}
+
+/**
+ * ggit_fetch_scheduler_get_n_pending:
+ * @scheduler: a #GgitFetchScheduler.
+ *
+ * Gets the number of remotes which will be fetched by the next run.
+ *
+ * Returns: the number of pending remotes.
+ */
+guint
+ggit_fetch_scheduler_get_n_pending (GgitFetchScheduler *scheduler)
+{
+	g_return_val_if_fail (GGIT_IS_FETCH_SCHEDULER (scheduler), 0);
+
+	return scheduler->jobs->len;
+}
+
+static gboolean
+emit_transfer_progress (gpointer user_data)
+{
+	RunData *run = user_data;
+	git_transfer_progress total = { 0, };
+	GgitTransferProgress *progress;
+	guint i;
+
+	g_mutex_lock (&run->mutex);
+
+	for (i = 0; i < run->jobs->len; ++i)
+	{
+		FetchJob *job = g_ptr_array_index (run->jobs, i);
+
+		total.total_objects += job->progress.total_objects;
+		total.indexed_objects += job->progress.indexed_objects;
+		total.received_objects += job->progress.received_objects;
+		total.local_objects += job->progress.local_objects;
+		total.total_deltas += job->progress.total_deltas;
+		total.indexed_deltas += job->progress.indexed_deltas;
+		total.received_bytes += job->progress.received_bytes;
+	}
+
+	run->progress_pending = FALSE;
+
+	g_mutex_unlock (&run->mutex);
+
+	progress = _ggit_transfer_progress_wrap (&total);
+	g_signal_emit (run->scheduler, signals[TRANSFER_PROGRESS], 0, progress);
+	ggit_transfer_progress_free (progress);
+
+	return G_SOURCE_REMOVE;
+}
+
+static gint
+job_transfer_progress (const git_transfer_progress *stats,
+                       void                        *payload)
+{
+	FetchJob *job = payload;
+	RunData *run = job->run;
+	gboolean schedule;
+
+	g_mutex_lock (&run->mutex);
+
+	job->progress = *stats;
+
+	schedule = !run->progress_pending;
+	run->progress_pending = TRUE;
+
+	g_mutex_unlock (&run->mutex);
+
+	if (schedule)
+	{
+		g_main_context_invoke_full (run->context,
+		                            G_PRIORITY_DEFAULT,
+		                            emit_transfer_progress,
+		                            run_data_ref (run),
+		                            (GDestroyNotify)run_data_unref);
+	}
+
+	return GIT_OK;
+}
+
+static void
+remote_finished_data_free (RemoteFinishedData *data)
+{
+	run_data_unref (data->run);
+	g_object_unref (data->remote);
+	g_clear_error (&data->error);
+
+	g_slice_free (RemoteFinishedData, data);
+}
+
+static gboolean
+emit_remote_finished (gpointer user_data)
+{
+	RemoteFinishedData *data = user_data;
+
+	g_signal_emit (data->run->scheduler,
+	               signals[REMOTE_FINISHED],
+	               0,
+	               data->remote,
+	               data->error);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+fetch_job (FetchJob *job)
+{
+	RunData *run = job->run;
+	git_fetch_options options = GIT_FETCH_OPTIONS_INIT;
+	git_remote_callbacks *callbacks;
+	git_strarray specs;
+	RemoteFinishedData *data;
+	GError *error = NULL;
+	gint ret;
+
+	if (!g_cancellable_set_error_if_cancelled (run->cancellable, &error))
+	{
+		if (job->fetch_options != NULL)
+		{
+			options = *_ggit_fetch_options_get_fetch_options (job->fetch_options);
+		}
+
+		callbacks = _ggit_remote_callbacks_new_cancellable_full (&options.callbacks,
+		                                                         run->cancellable,
+		                                                         job_transfer_progress,
+		                                                         job);
+		options.callbacks = *callbacks;
+
+		specs.strings = job->specs;
+		specs.count = job->specs != NULL ? g_strv_length (job->specs) : 0;
+
+		ret = git_remote_fetch (_ggit_native_get (job->remote),
+		                        &specs,
+		                        &options,
+		                        job->message);
+
+		_ggit_remote_callbacks_free_cancellable (callbacks);
+
+		if (ret != GIT_OK &&
+		    !g_cancellable_set_error_if_cancelled (run->cancellable, &error))
+		{
+			_ggit_error_set (&error, ret);
+		}
+	}
+
+	if (error != NULL)
+	{
+		g_mutex_lock (&run->mutex);
+
+		if (run->error == NULL)
+		{
+			run->error = g_error_copy (error);
+		}
+
+		g_mutex_unlock (&run->mutex);
+	}
+
+	data = g_slice_new (RemoteFinishedData);
+	data->run = run_data_ref (run);
+	data->remote = g_object_ref (job->remote);
+	data->error = error;
+
+	g_main_context_invoke_full (run->context,
+	                            G_PRIORITY_DEFAULT,
+	                            emit_remote_finished,
+	                            data,
+	                            (GDestroyNotify)remote_finished_data_free);
+}
+
+static void
+fetch_group (gpointer pool_data,
+             gpointer user_data)
+{
+	GPtrArray *group = pool_data;
+	guint i;
+
+	/* All jobs in a group share the same repository and are therefore
+	 * fetched sequentially on this worker.
+	 */
+	for (i = 0; i < group->len; ++i)
+	{
+		fetch_job (g_ptr_array_index (group, i));
+	}
+
+	g_ptr_array_unref (group);
+}
+
+static void
+run_thread (GTask        *task,
+            gpointer      source_object,
+            gpointer      task_data,
+            GCancellable *cancellable)
+{
+	GgitFetchScheduler *scheduler = source_object;
+	RunData *run = task_data;
+	GHashTable *groups;
+	GPtrArray *ordered;
+	GThreadPool *pool;
+	GError *error = NULL;
+	guint i;
+
+	groups = g_hash_table_new (g_direct_hash, g_direct_equal);
+	ordered = g_ptr_array_new ();
+
+	for (i = 0; i < run->jobs->len; ++i)
+	{
+		FetchJob *job = g_ptr_array_index (run->jobs, i);
+		git_repository *repository;
+		GPtrArray *group;
+
+		repository = git_remote_owner (_ggit_native_get (job->remote));
+		group = g_hash_table_lookup (groups, repository);
+
+		if (group == NULL)
+		{
+			group = g_ptr_array_new ();
+			g_hash_table_insert (groups, repository, group);
+			g_ptr_array_add (ordered, group);
+		}
+
+		g_ptr_array_add (group, job);
+	}
+
+	g_hash_table_unref (groups);
+
+	pool = g_thread_pool_new (fetch_group,
+	                          NULL,
+	                          (gint)scheduler->max_workers,
+	                          FALSE,
+	                          &error);
+
+	if (pool == NULL)
+	{
+		g_ptr_array_free (ordered, TRUE);
+		g_atomic_int_set (&scheduler->running, FALSE);
+		g_task_return_error (task, error);
+		return;
+	}
+
+	for (i = 0; i < ordered->len; ++i)
+	{
+		g_thread_pool_push (pool, g_ptr_array_index (ordered, i), NULL);
+	}
+
+	g_ptr_array_free (ordered, TRUE);
+
+	/* Wait for all the groups to be fetched */
+	g_thread_pool_free (pool, FALSE, TRUE);
+
+	g_atomic_int_set (&scheduler->running, FALSE);
+
+	g_mutex_lock (&run->mutex);
+	error = run->error;
+	run->error = NULL;
+	g_mutex_unlock (&run->mutex);
+
+	if (error != NULL)
+	{
+		g_task_return_error (task, error);
+	}
+	else
+	{
+		g_task_return_boolean (task, TRUE);
+	}
+}
+
+/**
+ * ggit_fetch_scheduler_run_async:
+ * @scheduler: a #GgitFetchScheduler.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when all
+ *            remotes have been fetched.
+ * @user_data: the data to pass to @callback.
+ *
+ * Fetches all the remotes added with ggit_fetch_scheduler_add() since the
+ * previous run. At most #GgitFetchScheduler:max-workers remotes are fetched
+ * at the same time, and remotes of the same repository are never fetched
+ * concurrently.
+ *
+ * The repositories of the remotes must not be used from other threads
+ * while the run is in progress. A failing remote does not stop the other
+ * remotes from being fetched; the first error is reported when finishing
+ * the run and each result is reported with
+ * #GgitFetchScheduler::remote-finished. Cancelling @cancellable aborts the
+ * running transfers and skips the remotes which have not been started yet.
+ *
+ * Only one run can be in progress at a time.
+ */
+void
+ggit_fetch_scheduler_run_async (GgitFetchScheduler  *scheduler,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+	GTask *task;
+	RunData *run;
+	guint i;
+
+	g_return_if_fail (GGIT_IS_FETCH_SCHEDULER (scheduler));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	task = g_task_new (scheduler, cancellable, callback, user_data);
+	g_task_set_source_tag (task, ggit_fetch_scheduler_run_async);
+
+	if (!g_atomic_int_compare_and_exchange (&scheduler->running, FALSE, TRUE))
+	{
+		g_task_return_new_error (task,
+		                         G_IO_ERROR,
+		                         G_IO_ERROR_PENDING,
+		                         "A fetch is already in progress");
+		g_object_unref (task);
+		return;
+	}
+
+	run = g_slice_new0 (RunData);
+	run->ref_count = 1;
+	run->scheduler = g_object_ref (scheduler);
+	run->context = g_main_context_ref_thread_default ();
+	run->cancellable = cancellable != NULL ? g_object_ref (cancellable) : NULL;
+	g_mutex_init (&run->mutex);
+
+	/* Take the pending jobs, new ones are queued for the next run */
+	run->jobs = scheduler->jobs;
+	scheduler->jobs = g_ptr_array_new_with_free_func ((GDestroyNotify)fetch_job_free);
+
+	for (i = 0; i < run->jobs->len; ++i)
+	{
+		((FetchJob *)g_ptr_array_index (run->jobs, i))->run = run;
+	}
+
+	g_task_set_task_data (task, run, (GDestroyNotify)run_data_unref);
+	g_task_run_in_thread (task, run_thread);
+	g_object_unref (task);
+}
+
+/**
+ * ggit_fetch_scheduler_run_finish:
+ * @scheduler: a #GgitFetchScheduler.
+ * @result: a #GAsyncResult.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Finishes an operation started with ggit_fetch_scheduler_run_async().
+ *
+ * Returns: %TRUE if all remotes were fetched successfully, %FALSE otherwise.
+ */
+gboolean
+ggit_fetch_scheduler_run_finish (GgitFetchScheduler  *scheduler,
+                                 GAsyncResult        *result,
+                                 GError             **error)
+{
+	g_return_val_if_fail (GGIT_IS_FETCH_SCHEDULER (scheduler), FALSE);
+	g_return_val_if_fail (g_task_is_valid (result, scheduler), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+static void
+run_sync_cb (GObject      *source,
+             GAsyncResult *result,
+             gpointer      user_data)
+{
+	GAsyncResult **ret = user_data;
+
+	*ret = g_object_ref (result);
+}
+
+/**
+ * ggit_fetch_scheduler_run:
+ * @scheduler: a #GgitFetchScheduler.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Synchronous version of ggit_fetch_scheduler_run_async(). The remotes are
+ * still fetched in parallel on the worker threads; the signals of
+ * @scheduler are emitted on the calling thread.
+ *
+ * Returns: %TRUE if all remotes were fetched successfully, %FALSE otherwise.
+ */
+gboolean
+ggit_fetch_scheduler_run (GgitFetchScheduler  *scheduler,
+                          GCancellable        *cancellable,
+                          GError             **error)
+{
+	GMainContext *context;
+	GAsyncResult *result = NULL;
+	gboolean ret;
+
+	g_return_val_if_fail (GGIT_IS_FETCH_SCHEDULER (scheduler), FALSE);
+	g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	context = g_main_context_new ();
+	g_main_context_push_thread_default (context);
+
+	ggit_fetch_scheduler_run_async (scheduler, cancellable, run_sync_cb, &result);
+
+	while (result == NULL)
+	{
+		g_main_context_iteration (context, TRUE);
+	}
+
+	/* Deliver the signals which were queued before the result */
+	while (g_main_context_iteration (context, FALSE));
+
+	g_main_context_pop_thread_default (context);
+
+	ret = ggit_fetch_scheduler_run_finish (scheduler, result, error);
+
+	g_object_unref (result);
+	g_main_context_unref (context);
+
+	return ret;
+}
+
+/* ex:set ts=8 noet: */
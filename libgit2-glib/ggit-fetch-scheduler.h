@@ -0,0 +1,64 @@
+/*
+ * ggit-fetch-scheduler.h
+ * This file is part of libgit2-glib
+ *
+ * Copyright (C) 2026 - The libgit2-glib authors
+ *
+ * libgit2-glib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libgit2-glib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GGIT_FETCH_SCHEDULER_H__
+#define __GGIT_FETCH_SCHEDULER_H__
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include <libgit2-glib/ggit-types.h>
+#include <libgit2-glib/ggit-remote.h>
+
+G_BEGIN_DECLS
+
+#define GGIT_TYPE_FETCH_SCHEDULER (ggit_fetch_scheduler_get_type ())
+G_DECLARE_FINAL_TYPE (GgitFetchScheduler, ggit_fetch_scheduler, GGIT, FETCH_SCHEDULER, GObject)
+
+GgitFetchScheduler *ggit_fetch_scheduler_new             (guint                 max_workers);
+
+guint               ggit_fetch_scheduler_get_max_workers (GgitFetchScheduler   *scheduler);
+
+void                ggit_fetch_scheduler_add             (GgitFetchScheduler   *scheduler,
+                                                          GgitRemote           *remote,
+                                                          const gchar * const  *specs,
+                                                          GgitFetchOptions     *fetch_options,
+                                                          const gchar          *message);
+
+guint               ggit_fetch_scheduler_get_n_pending   (GgitFetchScheduler   *scheduler);
+
+gboolean            ggit_fetch_scheduler_run             (GgitFetchScheduler   *scheduler,
+                                                          GCancellable         *cancellable,
+                                                          GError              **error);
+
+void                ggit_fetch_scheduler_run_async       (GgitFetchScheduler   *scheduler,
+                                                          GCancellable         *cancellable,
+                                                          GAsyncReadyCallback   callback,
+                                                          gpointer              user_data);
+
+gboolean            ggit_fetch_scheduler_run_finish      (GgitFetchScheduler   *scheduler,
+                                                          GAsyncResult         *result,
+                                                          GError              **error);
+
+G_END_DECLS
+
+#endif /* __GGIT_FETCH_SCHEDULER_H__ */
+
+/* ex:set ts=8 noet: */
@@ -718,6 +718,8 @@ ggit_index_entry_stat (GgitIndexEntry  *entry,
 	g_return_val_if_fail (entry->owned, FALSE);
 
 	info = g_file_query_info (file,
+	                          G_FILE_ATTRIBUTE_STANDARD_TYPE ","
+	                          G_FILE_ATTRIBUTE_STANDARD_IS_SYMLINK ","
 	                          G_FILE_ATTRIBUTE_STANDARD_SIZE ","
 	                          G_FILE_ATTRIBUTE_TIME_MODIFIED ","
 	                          G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC ","
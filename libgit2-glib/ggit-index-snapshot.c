@@ -0,0 +1,480 @@
+/*
+ * ggit-index-snapshot.c
+ * This file is part of libgit2-glib
+ *
+ * Copyright (C) 2026 - The libgit2-glib authors
+ *
+ * libgit2-glib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libgit2-glib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "ggit-index-snapshot.h"
+#include "ggit-oid.h"
+
+/* Entries are stored column-wise: all the paths share one string arena and
+ * every other field lives in its own packed array, indexed by entry.
+ */
+struct _GgitIndexSnapshot
+{
+	guint n_entries;
+	gboolean ignore_case;
+
+	gchar *paths;
+	guint32 *path_offsets;
+
+	guint8 *ids;
+	guint32 *modes;
+	guint16 *flags;
+	guint16 *flags_extended;
+	guint8 *stages;
+	goffset *file_sizes;
+
+	gint64 *mtimes;
+	guint32 *mtime_nsecs;
+	gint64 *ctimes;
+	guint32 *ctime_nsecs;
+
+	gint ref_count;
+};
+
+G_DEFINE_BOXED_TYPE (GgitIndexSnapshot, ggit_index_snapshot, ggit_index_snapshot_ref, ggit_index_snapshot_unref)
+
+GgitIndexSnapshot *
+_ggit_index_snapshot_new (git_index *idx)
+{
+	GgitIndexSnapshot *snapshot;
+	GString *paths;
+	guint i;
+
+	g_return_val_if_fail (idx != NULL, NULL);
+
+	snapshot = g_slice_new0 (GgitIndexSnapshot);
+	snapshot->ref_count = 1;
+
+	snapshot->n_entries = git_index_entrycount (idx);
+	snapshot->ignore_case = (git_index_caps (idx) & GIT_INDEXCAP_IGNORE_CASE) != 0;
+
+	snapshot->path_offsets = g_new (guint32, snapshot->n_entries);
+	snapshot->ids = g_new (guint8, snapshot->n_entries * GIT_OID_RAWSZ);
+	snapshot->modes = g_new (guint32, snapshot->n_entries);
+	snapshot->flags = g_new (guint16, snapshot->n_entries);
+	snapshot->flags_extended = g_new (guint16, snapshot->n_entries);
+	snapshot->stages = g_new (guint8, snapshot->n_entries);
+	snapshot->file_sizes = g_new (goffset, snapshot->n_entries);
+	snapshot->mtimes = g_new (gint64, snapshot->n_entries);
+	snapshot->mtime_nsecs = g_new (guint32, snapshot->n_entries);
+	snapshot->ctimes = g_new (gint64, snapshot->n_entries);
+	snapshot->ctime_nsecs = g_new (guint32, snapshot->n_entries);
+
+	paths = g_string_sized_new (snapshot->n_entries * 32);
+
+	for (i = 0; i < snapshot->n_entries; ++i)
+	{
+		const git_index_entry *entry;
+
+		entry = git_index_get_byindex (idx, i);
+
+		snapshot->path_offsets[i] = paths->len;
+		g_string_append_len (paths, entry->path, strlen (entry->path) + 1);
+
+		memcpy (snapshot->ids + i * GIT_OID_RAWSZ, entry->id.id, GIT_OID_RAWSZ);
+		snapshot->modes[i] = entry->mode;
+		snapshot->flags[i] = entry->flags;
+		snapshot->flags_extended[i] = entry->flags_extended;
+		snapshot->stages[i] = git_index_entry_stage (entry);
+		snapshot->file_sizes[i] = entry->file_size;
+		snapshot->mtimes[i] = entry->mtime.seconds;
+		snapshot->mtime_nsecs[i] = entry->mtime.nanoseconds;
+		snapshot->ctimes[i] = entry->ctime.seconds;
+		snapshot->ctime_nsecs[i] = entry->ctime.nanoseconds;
+	}
+
+	snapshot->paths = g_string_free (paths, FALSE);
+
+	return snapshot;
+}
+
+/**
+ * ggit_index_snapshot_ref:
+ * @snapshot: a #GgitIndexSnapshot.
+ *
+ * Atomically increments the reference count of @snapshot by one.
+ * This function is MT-safe and may be called from any thread.
+ *
+ * Returns: (transfer none) (nullable): a #GgitIndexSnapshot or %NULL.
+ *
+ **/
+GgitIndexSnapshot *
+ggit_index_snapshot_ref (GgitIndexSnapshot *snapshot)
+{
+	g_return_val_if_fail (snapshot != NULL, NULL);
+
+	g_atomic_int_inc (&snapshot->ref_count);
+	return snapshot;
+}
+
+/**
+ * ggit_index_snapshot_unref:
+ * @snapshot: a #GgitIndexSnapshot.
+ *
+ * Atomically decrements the reference count of @snapshot by one.
+ * If the reference count drops to 0, @snapshot is freed.
+ *
+ **/
+void
+ggit_index_snapshot_unref (GgitIndexSnapshot *snapshot)
+{
+	g_return_if_fail (snapshot != NULL);
+
+	if (g_atomic_int_dec_and_test (&snapshot->ref_count))
+	{
+		g_free (snapshot->paths);
+		g_free (snapshot->path_offsets);
+		g_free (snapshot->ids);
+		g_free (snapshot->modes);
+		g_free (snapshot->flags);
+		g_free (snapshot->flags_extended);
+		g_free (snapshot->stages);
+		g_free (snapshot->file_sizes);
+		g_free (snapshot->mtimes);
+		g_free (snapshot->mtime_nsecs);
+		g_free (snapshot->ctimes);
+		g_free (snapshot->ctime_nsecs);
+
+		g_slice_free (GgitIndexSnapshot, snapshot);
+	}
+}
+
+/**
+ * ggit_index_snapshot_size:
+ * @snapshot: a #GgitIndexSnapshot.
+ *
+ * Get the number of entries in @snapshot.
+ *
+ * Returns: the number of entries.
+ *
+ **/
+guint
+ggit_index_snapshot_size (GgitIndexSnapshot *snapshot)
+{
+	g_return_val_if_fail (snapshot != NULL, 0);
+
+	return snapshot->n_entries;
+}
+
+static inline const gchar *
+path_at (GgitIndexSnapshot *snapshot,
+         guint              i)
+{
+	return snapshot->paths + snapshot->path_offsets[i];
+}
+
+static inline gint
+stage_at (GgitIndexSnapshot *snapshot,
+          guint              i)
+{
+	return snapshot->stages[i];
+}
+
+/**
+ * ggit_index_snapshot_find:
+ * @snapshot: a #GgitIndexSnapshot.
+ * @path: the path to look for.
+ * @stage: the stage to look for, or -1 for any stage.
+ *
+ * Find the entry for @path using a binary search. Paths are matched the
+ * same way the index they were copied from matches them, which may be
+ * case-insensitively.
+ *
+ * Returns: the position of the entry, or -1 if it was not found.
+ *
+ **/
+gint
+ggit_index_snapshot_find (GgitIndexSnapshot *snapshot,
+                          const gchar       *path,
+                          gint               stage)
+{
+	guint lo = 0;
+	guint hi;
+
+	g_return_val_if_fail (snapshot != NULL, -1);
+	g_return_val_if_fail (path != NULL, -1);
+
+	hi = snapshot->n_entries;
+
+	/* Entries are sorted by path, then by stage */
+	while (lo < hi)
+	{
+		guint mid = lo + (hi - lo) / 2;
+		gint cmp;
+
+		if (snapshot->ignore_case)
+		{
+			cmp = g_ascii_strcasecmp (path_at (snapshot, mid), path);
+		}
+		else
+		{
+			cmp = strcmp (path_at (snapshot, mid), path);
+		}
+
+		if (cmp == 0)
+		{
+			cmp = stage_at (snapshot, mid) - MAX (stage, 0);
+		}
+
+		if (cmp < 0)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	for (; lo < snapshot->n_entries; ++lo)
+	{
+		const gchar *p = path_at (snapshot, lo);
+
+		if ((snapshot->ignore_case ? g_ascii_strcasecmp (p, path) : strcmp (p, path)) != 0)
+		{
+			break;
+		}
+
+		if (stage < 0 || stage_at (snapshot, lo) == stage)
+		{
+			return lo;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * ggit_index_snapshot_get_path:
+ * @snapshot: a #GgitIndexSnapshot.
+ * @i: the position of the entry.
+ *
+ * Get the path of the entry at @i.
+ *
+ * Returns: the path, owned by @snapshot.
+ *
+ **/
+const gchar *
+ggit_index_snapshot_get_path (GgitIndexSnapshot *snapshot,
+                              guint              i)
+{
+	g_return_val_if_fail (snapshot != NULL, NULL);
+	g_return_val_if_fail (i < snapshot->n_entries, NULL);
+
+	return path_at (snapshot, i);
+}
+
+/**
+ * ggit_index_snapshot_get_raw_id:
+ * @snapshot: a #GgitIndexSnapshot.
+ * @i: the position of the entry.
+ *
+ * Get the raw object id of the entry at @i, without allocating.
+ *
+ * Returns: (array fixed-size=20): the raw id, owned by @snapshot.
+ *
+ **/
+const guchar *
+ggit_index_snapshot_get_raw_id (GgitIndexSnapshot *snapshot,
+                                guint              i)
+{
+	g_return_val_if_fail (snapshot != NULL, NULL);
+	g_return_val_if_fail (i < snapshot->n_entries, NULL);
+
+	return snapshot->ids + i * GIT_OID_RAWSZ;
+}
+
+/**
+ * ggit_index_snapshot_get_id:
+ * @snapshot: a #GgitIndexSnapshot.
+ * @i: the position of the entry.
+ *
+ * Get the object id of the entry at @i.
+ *
+ * Returns: (transfer full) (nullable): a #GgitOId.
+ *
+ **/
+GgitOId *
+ggit_index_snapshot_get_id (GgitIndexSnapshot *snapshot,
+                            guint              i)
+{
+	g_return_val_if_fail (snapshot != NULL, NULL);
+	g_return_val_if_fail (i < snapshot->n_entries, NULL);
+
+	return ggit_oid_new_from_raw (snapshot->ids + i * GIT_OID_RAWSZ);
+}
+
+/**
+ * ggit_index_snapshot_get_mode:
+ * @snapshot: a #GgitIndexSnapshot.
+ * @i: the position of the entry.
+ *
+ * Get the mode of the entry at @i.
+ *
+ * Returns: the mode.
+ *
+ **/
+guint
+ggit_index_snapshot_get_mode (GgitIndexSnapshot *snapshot,
+                              guint              i)
+{
+	g_return_val_if_fail (snapshot != NULL, 0);
+	g_return_val_if_fail (i < snapshot->n_entries, 0);
+
+	return snapshot->modes[i];
+}
+
+/**
+ * ggit_index_snapshot_get_stage:
+ * @snapshot: a #GgitIndexSnapshot.
+ * @i: the position of the entry.
+ *
+ * Get the stage of the entry at @i. Entries with a stage other than 0 are
+ * conflicts.
+ *
+ * Returns: the stage.
+ *
+ **/
+gint
+ggit_index_snapshot_get_stage (GgitIndexSnapshot *snapshot,
+                               guint              i)
+{
+	g_return_val_if_fail (snapshot != NULL, 0);
+	g_return_val_if_fail (i < snapshot->n_entries, 0);
+
+	return stage_at (snapshot, i);
+}
+
+/**
+ * ggit_index_snapshot_get_flags:
+ * @snapshot: a #GgitIndexSnapshot.
+ * @i: the position of the entry.
+ *
+ * Get the flags of the entry at @i.
+ *
+ * Returns: the flags.
+ *
+ **/
+guint
+ggit_index_snapshot_get_flags (GgitIndexSnapshot *snapshot,
+                               guint              i)
+{
+	g_return_val_if_fail (snapshot != NULL, 0);
+	g_return_val_if_fail (i < snapshot->n_entries, 0);
+
+	return snapshot->flags[i];
+}
+
+/**
+ * ggit_index_snapshot_get_flags_extended:
+ * @snapshot: a #GgitIndexSnapshot.
+ * @i: the position of the entry.
+ *
+ * Get the extended flags of the entry at @i.
+ *
+ * Returns: the extended flags.
+ *
+ **/
+guint
+ggit_index_snapshot_get_flags_extended (GgitIndexSnapshot *snapshot,
+                                        guint              i)
+{
+	g_return_val_if_fail (snapshot != NULL, 0);
+	g_return_val_if_fail (i < snapshot->n_entries, 0);
+
+	return snapshot->flags_extended[i];
+}
+
+/**
+ * ggit_index_snapshot_get_file_size:
+ * @snapshot: a #GgitIndexSnapshot.
+ * @i: the position of the entry.
+ *
+ * Get the file size recorded for the entry at @i.
+ *
+ * Returns: the file size.
+ *
+ **/
+goffset
+ggit_index_snapshot_get_file_size (GgitIndexSnapshot *snapshot,
+                                   guint              i)
+{
+	g_return_val_if_fail (snapshot != NULL, 0);
+	g_return_val_if_fail (i < snapshot->n_entries, 0);
+
+	return snapshot->file_sizes[i];
+}
+
+/**
+ * ggit_index_snapshot_get_mtime:
+ * @snapshot: a #GgitIndexSnapshot.
+ * @i: the position of the entry.
+ * @nanoseconds: (out) (allow-none): return location for the nanoseconds, or %NULL.
+ *
+ * Get the modification time recorded for the entry at @i.
+ *
+ * Returns: the modification time in seconds since the epoch.
+ *
+ **/
+gint64
+ggit_index_snapshot_get_mtime (GgitIndexSnapshot *snapshot,
+                               guint              i,
+                               guint             *nanoseconds)
+{
+	g_return_val_if_fail (snapshot != NULL, 0);
+	g_return_val_if_fail (i < snapshot->n_entries, 0);
+
+	if (nanoseconds != NULL)
+	{
+		*nanoseconds = snapshot->mtime_nsecs[i];
+	}
+
+	return snapshot->mtimes[i];
+}
+
+/**
+ * ggit_index_snapshot_get_ctime:
+ * @snapshot: a #GgitIndexSnapshot.
+ * @i: the position of the entry.
+ * @nanoseconds: (out) (allow-none): return location for the nanoseconds, or %NULL.
+ *
+ * Get the status change time recorded for the entry at @i.
+ *
+ * Returns: the status change time in seconds since the epoch.
+ *
+ **/
+gint64
+ggit_index_snapshot_get_ctime (GgitIndexSnapshot *snapshot,
+                               guint              i,
+                               guint             *nanoseconds)
+{
+	g_return_val_if_fail (snapshot != NULL, 0);
+	g_return_val_if_fail (i < snapshot->n_entries, 0);
+
+	if (nanoseconds != NULL)
+	{
+		*nanoseconds = snapshot->ctime_nsecs[i];
+	}
+
+	return snapshot->ctimes[i];
+}
+
+/* ex:set ts=8 noet: */
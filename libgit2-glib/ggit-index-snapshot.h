@@ -0,0 +1,84 @@
+/*
+ * ggit-index-snapshot.h
+ * This file is part of libgit2-glib
+ *
+ * Copyright (C) 2026 - The libgit2-glib authors
+ *
+ * libgit2-glib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libgit2-glib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GGIT_INDEX_SNAPSHOT_H__
+#define __GGIT_INDEX_SNAPSHOT_H__
+
+#include <glib-object.h>
+#include <git2.h>
+#include <libgit2-glib/ggit-types.h>
+
+G_BEGIN_DECLS
+
+#define GGIT_TYPE_INDEX_SNAPSHOT       (ggit_index_snapshot_get_type ())
+#define GGIT_INDEX_SNAPSHOT(obj)       ((GgitIndexSnapshot *)obj)
+
+GType              ggit_index_snapshot_get_type           (void) G_GNUC_CONST;
+
+GgitIndexSnapshot *_ggit_index_snapshot_new               (git_index          *idx);
+
+GgitIndexSnapshot *ggit_index_snapshot_ref                (GgitIndexSnapshot  *snapshot);
+void               ggit_index_snapshot_unref              (GgitIndexSnapshot  *snapshot);
+
+guint              ggit_index_snapshot_size               (GgitIndexSnapshot  *snapshot);
+
+gint               ggit_index_snapshot_find               (GgitIndexSnapshot  *snapshot,
+                                                           const gchar        *path,
+                                                           gint                stage);
+
+const gchar       *ggit_index_snapshot_get_path           (GgitIndexSnapshot  *snapshot,
+                                                           guint               i);
+
+const guchar      *ggit_index_snapshot_get_raw_id         (GgitIndexSnapshot  *snapshot,
+                                                           guint               i);
+
+GgitOId           *ggit_index_snapshot_get_id             (GgitIndexSnapshot  *snapshot,
+                                                           guint               i);
+
+guint              ggit_index_snapshot_get_mode           (GgitIndexSnapshot  *snapshot,
+                                                           guint               i);
+
+gint               ggit_index_snapshot_get_stage          (GgitIndexSnapshot  *snapshot,
+                                                           guint               i);
+
+guint              ggit_index_snapshot_get_flags          (GgitIndexSnapshot  *snapshot,
+                                                           guint               i);
+
+guint              ggit_index_snapshot_get_flags_extended (GgitIndexSnapshot  *snapshot,
+                                                           guint               i);
+
+goffset            ggit_index_snapshot_get_file_size      (GgitIndexSnapshot  *snapshot,
+                                                           guint               i);
+
+gint64             ggit_index_snapshot_get_mtime          (GgitIndexSnapshot  *snapshot,
+                                                           guint               i,
+                                                           guint              *nanoseconds);
+
+gint64             ggit_index_snapshot_get_ctime          (GgitIndexSnapshot  *snapshot,
+                                                           guint               i,
+                                                           guint              *nanoseconds);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GgitIndexSnapshot, ggit_index_snapshot_unref)
+
+G_END_DECLS
+
+#endif /* __GGIT_INDEX_SNAPSHOT_H__ */
+
+/* ex:set ts=8 noet: */
@@ -24,6 +24,27 @@
 #include "ggit-repository.h"
 #include "ggit-index-entry.h"
 #include "ggit-index-entry-resolve-undo.h"
+#include "ggit-index-snapshot.h"
+#include "ggit-utils.h"
+
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <string.h>
+
+/* The trailing SHA-1 checksum of the index file */
+#define INDEX_CHECKSUM_SIZE 20
+
+typedef struct
+{
+	gboolean valid;
+	gboolean exists;
+
+	gint64 mtime;
+	gint64 size;
+	guint64 inode;
+
+	guchar checksum[INDEX_CHECKSUM_SIZE];
+} IndexStamp;
 
 /**
  * GgitIndex:
@@ -35,6 +56,9 @@ struct _GgitIndex
 	GgitNative parent_instance;
 
 	GFile *file;
+
+	IndexStamp stamp;
+	guint reloads_avoided;
 };
 
 enum
@@ -112,6 +136,81 @@ ggit_index_get_property (GObject    *object,
 	}
 }
 
+static gboolean
+read_stamp (git_index  *idx,
+            IndexStamp *stamp)
+{
+	const gchar *path;
+	GStatBuf st;
+	FILE *f;
+
+	memset (stamp, 0, sizeof (IndexStamp));
+
+	path = git_index_path (idx);
+
+	/* In-memory index */
+	if (path == NULL)
+	{
+		return FALSE;
+	}
+
+	stamp->valid = TRUE;
+
+	if (g_stat (path, &st) != 0)
+	{
+		return TRUE;
+	}
+
+	stamp->exists = TRUE;
+	stamp->mtime = st.st_mtime;
+	stamp->size = st.st_size;
+	stamp->inode = st.st_ino;
+
+	if (stamp->size < INDEX_CHECKSUM_SIZE)
+	{
+		return TRUE;
+	}
+
+	/* The modification time has a one second resolution, the checksum
+	 * catches rewrites of the same size within that second.
+	 */
+	f = g_fopen (path, "rb");
+
+	if (f == NULL)
+	{
+		return TRUE;
+	}
+
+	if (fseek (f, -INDEX_CHECKSUM_SIZE, SEEK_END) != 0 ||
+	    fread (stamp->checksum, 1, INDEX_CHECKSUM_SIZE, f) != INDEX_CHECKSUM_SIZE)
+	{
+		memset (stamp->checksum, 0, INDEX_CHECKSUM_SIZE);
+	}
+
+	fclose (f);
+	return TRUE;
+}
+
+static gboolean
+stamp_equal (const IndexStamp *a,
+             const IndexStamp *b)
+{
+	if (!a->valid || !b->valid || a->exists != b->exists)
+	{
+		return FALSE;
+	}
+
+	if (!a->exists)
+	{
+		return TRUE;
+	}
+
+	return a->mtime == b->mtime &&
+	       a->size == b->size &&
+	       a->inode == b->inode &&
+	       memcmp (a->checksum, b->checksum, INDEX_CHECKSUM_SIZE) == 0;
+}
+
 static gboolean
 ggit_index_initable_init (GInitable     *initable,
                           GCancellable  *cancellable,
@@ -156,6 +255,8 @@ ggit_index_initable_init (GInitable     *initable,
 	_ggit_native_set (initable, idx,
 		          (GDestroyNotify) git_index_free);
 
+	read_stamp (idx, &index->stamp);
+
 	return TRUE;
 }
 
@@ -195,12 +296,25 @@ ggit_index_init (GgitIndex *index)
 GgitIndex *
 _ggit_index_wrap (git_index *idx)
 {
+	GgitIndex *index;
+
 	if (idx == NULL)
 	{
 		return NULL;
 	}
 
-	return GGIT_INDEX (g_object_new (GGIT_TYPE_INDEX, "native", idx, NULL));
+	index = GGIT_INDEX (g_object_new (GGIT_TYPE_INDEX, "native", idx, NULL));
+
+	/* libgit2 keeps the index of a repository around once it has been
+	 * loaded, so bring it up to date with the file before stamping it.
+	 * Without a stamp, the next reload lets libgit2 decide.
+	 */
+	if (git_index_path (idx) != NULL && git_index_read (idx, FALSE) == GIT_OK)
+	{
+		read_stamp (idx, &index->stamp);
+	}
+
+	return index;
 }
 
 git_index *
@@ -274,9 +388,105 @@ ggit_index_read (GgitIndex  *idx,
 		return FALSE;
 	}
 
+	read_stamp (_ggit_native_get (idx), &idx->stamp);
+
 	return TRUE;
 }
 
+/**
+ * ggit_index_has_changed:
+ * @idx: a #GgitIndex.
+ *
+ * Check whether the index file on disk has changed since @idx was last read
+ * from or written to it. This only compares the modification time, size and
+ * checksum of the file and does not parse it.
+ *
+ * An index which is not backed by a file never changes.
+ *
+ * Returns: %TRUE if the index file has changed, %FALSE otherwise.
+ *
+ **/
+gboolean
+ggit_index_has_changed (GgitIndex *idx)
+{
+	IndexStamp stamp;
+
+	g_return_val_if_fail (GGIT_IS_INDEX (idx), FALSE);
+
+	if (!read_stamp (_ggit_native_get (idx), &stamp))
+	{
+		return FALSE;
+	}
+
+	return !stamp_equal (&stamp, &idx->stamp);
+}
+
+/**
+ * ggit_index_reload:
+ * @idx: a #GgitIndex.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Reload the index from disk if the file has changed, see
+ * ggit_index_has_changed(). When the file did not change, the index is
+ * left untouched without parsing the file and the counter returned by
+ * ggit_index_get_reloads_avoided() is incremented.
+ *
+ * If the file has changed, in-memory changes are discarded.
+ *
+ * Returns: %TRUE if the index is up to date, %FALSE if there was an error.
+ *
+ **/
+gboolean
+ggit_index_reload (GgitIndex  *idx,
+                   GError    **error)
+{
+	IndexStamp stamp;
+	gint ret;
+
+	g_return_val_if_fail (GGIT_IS_INDEX (idx), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	if (!read_stamp (_ggit_native_get (idx), &stamp) ||
+	    stamp_equal (&stamp, &idx->stamp))
+	{
+		idx->reloads_avoided++;
+		return TRUE;
+	}
+
+	/* Without a previous stamp, let libgit2 decide whether the file needs
+	 * to be parsed again so that in-memory changes are kept.
+	 */
+	ret = git_index_read (_ggit_native_get (idx), idx->stamp.valid);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		return FALSE;
+	}
+
+	idx->stamp = stamp;
+
+	return TRUE;
+}
+
+/**
+ * ggit_index_get_reloads_avoided:
+ * @idx: a #GgitIndex.
+ *
+ * Get the number of times ggit_index_reload() did not need to read the index
+ * file because it had not changed.
+ *
+ * Returns: the number of avoided reloads.
+ *
+ **/
+guint
+ggit_index_get_reloads_avoided (GgitIndex *idx)
+{
+	g_return_val_if_fail (GGIT_IS_INDEX (idx), 0);
+
+	return idx->reloads_avoided;
+}
+
 /**
  * ggit_index_write:
  * @idx: a #GgitIndex.
@@ -305,6 +515,8 @@ ggit_index_write (GgitIndex  *idx,
 		return FALSE;
 	}
 
+	read_stamp (_ggit_native_get (idx), &idx->stamp);
+
 	return TRUE;
 }
 
@@ -431,6 +643,26 @@ ggit_index_get_entries_resolve_undo (GgitIndex *idx)
 	return _ggit_index_entries_resolve_undo_wrap (idx);
 }
 
+/**
+ * ggit_index_get_snapshot:
+ * @idx: a #GgitIndex.
+ *
+ * Get an immutable copy of the entries in @idx. Unlike #GgitIndexEntries,
+ * accessing the entries of a snapshot does not allocate, which makes it
+ * suitable for scanning large indexes. The snapshot is not affected by
+ * later changes to @idx.
+ *
+ * Returns: (transfer full): a #GgitIndexSnapshot.
+ *
+ **/
+GgitIndexSnapshot *
+ggit_index_get_snapshot (GgitIndex *idx)
+{
+	g_return_val_if_fail (GGIT_IS_INDEX (idx), NULL);
+
+	return _ggit_index_snapshot_new (_ggit_native_get (idx));
+}
+
 /**
  * ggit_index_add_file:
  * @idx: a #GgitIndex.
@@ -537,6 +769,407 @@ ggit_index_add_path (GgitIndex    *idx,
 	return ret;
 }
 
+typedef struct
+{
+	GgitIndexMatchedPathCallback callback;
+	gpointer user_data;
+
+	/* the paths accepted by @callback, when collecting them */
+	GPtrArray *accepted;
+} MatchedPathWrapperData;
+
+static gint
+matched_path_wrapper (const gchar *path,
+                      const gchar *matched_pathspec,
+                      gpointer     payload)
+{
+	MatchedPathWrapperData *wrapper_data = payload;
+
+	if (wrapper_data->callback == NULL)
+	{
+		return 0;
+	}
+
+	return wrapper_data->callback (path, matched_pathspec, wrapper_data->user_data);
+}
+
+static gint
+prehash_collect (const gchar *path,
+                 const gchar *matched_pathspec,
+                 gpointer     payload)
+{
+	MatchedPathWrapperData *wrapper_data = payload;
+	gint ret;
+
+	ret = matched_path_wrapper (path, matched_pathspec, payload);
+
+	if (ret < 0)
+	{
+		return ret;
+	}
+
+	if (ret == 0)
+	{
+		g_ptr_array_add (wrapper_data->accepted, g_strdup (path));
+	}
+
+	/* Nothing is added in this pass */
+	return 1;
+}
+
+typedef struct
+{
+	const gchar *repo_path;
+	const gchar *workdir;
+	GPtrArray *paths;
+
+	/* one per path, NULL when the worker could not build the entry */
+	GgitIndexEntry **entries;
+	gboolean *removed;
+
+	gint next_path;
+} PrehashData;
+
+static void
+prehash_path (PrehashData    *data,
+              git_repository *repository,
+              guint           i)
+{
+	const gchar *path = g_ptr_array_index (data->paths, i);
+	GgitIndexEntry *entry;
+	GError *error = NULL;
+	GgitOId *id;
+	gchar *filename;
+	GFile *file;
+	git_oid oid;
+	gboolean stat_ok;
+
+	filename = g_build_filename (data->workdir, path, NULL);
+	file = g_file_new_for_path (filename);
+	g_free (filename);
+
+	entry = _ggit_index_entry_new (path, NULL);
+	stat_ok = ggit_index_entry_stat (entry, file, &error);
+	g_object_unref (file);
+
+	if (!stat_ok)
+	{
+		data->removed[i] = g_error_matches (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND);
+		g_error_free (error);
+		ggit_index_entry_unref (entry);
+
+		return;
+	}
+
+	/* Directories are submodules or nested repositories, and files
+	 * which fail to hash report their error when added on the calling
+	 * thread instead.
+	 */
+	if (ggit_index_entry_get_mode (entry) == GIT_FILEMODE_TREE ||
+	    git_blob_create_fromworkdir (&oid, repository, path) != GIT_OK)
+	{
+		ggit_index_entry_unref (entry);
+		return;
+	}
+
+	id = _ggit_oid_wrap (&oid);
+	ggit_index_entry_set_id (entry, id);
+	ggit_oid_free (id);
+
+	data->entries[i] = entry;
+}
+
+static gpointer
+prehash_thread (gpointer user_data)
+{
+	PrehashData *data = user_data;
+	git_repository *repository;
+	gint i;
+
+	/* Without a handle, all the files are added on the calling thread */
+	if (ggit_utils_open_worker_repository (&repository,
+	                                       data->repo_path,
+	                                       data->workdir) != GIT_OK)
+	{
+		return NULL;
+	}
+
+	while ((i = g_atomic_int_add (&data->next_path, 1)) < (gint)data->paths->len)
+	{
+		prehash_path (data, repository, i);
+	}
+
+	git_repository_free (repository);
+
+	return NULL;
+}
+
+/* Add the files matched by git_index_add_all, hashing and writing them on
+ * several threads.
+ *
+ * The files are found with a git_index_add_all pass which skips all of
+ * them, calling the user callback on the way. The accepted files are then
+ * statted, hashed and written by the threads, each using its own handle
+ * on the repository, and their entries are inserted in the index without
+ * reading the files again. Files which no longer exist are removed, as
+ * git_index_add_all does.
+ */
+static gint
+parallel_add_all (git_index              *idx,
+                  git_strarray           *pathspec,
+                  guint                   flags,
+                  MatchedPathWrapperData *wrapper_data)
+{
+	git_repository *repository;
+	PrehashData data = { 0, };
+	GThread **threads;
+	guint n_workers;
+	guint i;
+	gint ret;
+
+	repository = git_index_owner (idx);
+
+	wrapper_data->accepted = g_ptr_array_new_with_free_func (g_free);
+
+	ret = git_index_add_all (idx, pathspec, flags, prehash_collect, wrapper_data);
+
+	if (ret != GIT_OK)
+	{
+		return ret;
+	}
+
+	data.repo_path = git_repository_path (repository);
+	data.workdir = git_repository_workdir (repository);
+	data.paths = wrapper_data->accepted;
+	data.entries = g_new0 (GgitIndexEntry *, data.paths->len);
+	data.removed = g_new0 (gboolean, data.paths->len);
+
+	n_workers = MAX (MIN (g_get_num_processors (), data.paths->len), 1);
+	threads = g_new (GThread *, n_workers);
+
+	for (i = 0; i < n_workers; ++i)
+	{
+		threads[i] = g_thread_new ("ggit-add", prehash_thread, &data);
+	}
+
+	for (i = 0; i < n_workers; ++i)
+	{
+		g_thread_join (threads[i]);
+	}
+
+	g_free (threads);
+
+	for (i = 0; i < data.paths->len; ++i)
+	{
+		const gchar *path = g_ptr_array_index (data.paths, i);
+
+		if (data.entries[i] != NULL)
+		{
+			if (ret == GIT_OK)
+			{
+				ret = git_index_add (idx, _ggit_index_entry_get_native (data.entries[i]));
+			}
+
+			ggit_index_entry_unref (data.entries[i]);
+		}
+		else if (ret == GIT_OK && data.removed[i])
+		{
+			ret = git_index_remove_bypath (idx, path);
+		}
+		else if (ret == GIT_OK)
+		{
+			ret = git_index_add_bypath (idx, path);
+		}
+	}
+
+	g_free (data.entries);
+	g_free (data.removed);
+
+	return ret;
+}
+
+/**
+ * ggit_index_add_all:
+ * @idx: a #GgitIndex.
+ * @pathspec: (array zero-terminated=1) (allow-none): the pathspecs of the
+ *            files to add, or %NULL to add all the files.
+ * @flags: a #GgitIndexAddOption.
+ * @callback: (scope call) (allow-none): a #GgitIndexMatchedPathCallback,
+ *            or %NULL.
+ * @user_data: (closure): callback user data.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Add or update the index entries of all the files in the working directory
+ * matching @pathspec. @callback is called for each matching file before it
+ * is added, which can be used to report progress or to filter the files.
+ *
+ * If @flags contains %GGIT_INDEX_ADD_PARALLEL_HASH, the new and modified
+ * files are statted, hashed and written to the object database on several
+ * threads, and their entries are then inserted without reading the files
+ * again. @callback is then called for all the files before any of them is
+ * written, and files it skips are not written.
+ *
+ * Returns: %TRUE if the files were added or %FALSE if there was an error.
+ *
+ **/
+gboolean
+ggit_index_add_all (GgitIndex                     *idx,
+                    const gchar * const           *pathspec,
+                    GgitIndexAddOption             flags,
+                    GgitIndexMatchedPathCallback   callback,
+                    gpointer                       user_data,
+                    GError                       **error)
+{
+	MatchedPathWrapperData wrapper_data = { 0, };
+	git_repository *owner;
+	git_strarray gpathspec;
+	guint native_flags;
+	gint ret;
+
+	g_return_val_if_fail (GGIT_IS_INDEX (idx), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	ggit_utils_get_git_strarray_from_str_array (pathspec, &gpathspec);
+
+	wrapper_data.callback = callback;
+	wrapper_data.user_data = user_data;
+
+	native_flags = flags & ~GGIT_INDEX_ADD_PARALLEL_HASH;
+	owner = git_index_owner (_ggit_native_get (idx));
+
+	if ((flags & GGIT_INDEX_ADD_PARALLEL_HASH) &&
+	    owner != NULL && !git_repository_is_bare (owner))
+	{
+		ret = parallel_add_all (_ggit_native_get (idx),
+		                        &gpathspec,
+		                        native_flags,
+		                        &wrapper_data);
+
+		g_ptr_array_unref (wrapper_data.accepted);
+	}
+	else
+	{
+		ret = git_index_add_all (_ggit_native_get (idx),
+		                         &gpathspec,
+		                         native_flags,
+		                         callback != NULL ? matched_path_wrapper : NULL,
+		                         &wrapper_data);
+	}
+
+	git_strarray_free (&gpathspec);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * ggit_index_update_all:
+ * @idx: a #GgitIndex.
+ * @pathspec: (array zero-terminated=1) (allow-none): the pathspecs of the
+ *            entries to update, or %NULL to update all the entries.
+ * @callback: (scope call) (allow-none): a #GgitIndexMatchedPathCallback,
+ *            or %NULL.
+ * @user_data: (closure): callback user data.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Update all the index entries matching @pathspec to match the working
+ * directory. Entries of files which no longer exist are removed. No new
+ * files are added. @callback is called for each matching entry.
+ *
+ * Returns: %TRUE if the entries were updated or %FALSE if there was an error.
+ *
+ **/
+gboolean
+ggit_index_update_all (GgitIndex                     *idx,
+                       const gchar * const           *pathspec,
+                       GgitIndexMatchedPathCallback   callback,
+                       gpointer                       user_data,
+                       GError                       **error)
+{
+	MatchedPathWrapperData wrapper_data = { 0, };
+	git_strarray gpathspec;
+	gint ret;
+
+	g_return_val_if_fail (GGIT_IS_INDEX (idx), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	ggit_utils_get_git_strarray_from_str_array (pathspec, &gpathspec);
+
+	wrapper_data.callback = callback;
+	wrapper_data.user_data = user_data;
+
+	ret = git_index_update_all (_ggit_native_get (idx),
+	                            &gpathspec,
+	                            callback != NULL ? matched_path_wrapper : NULL,
+	                            &wrapper_data);
+
+	git_strarray_free (&gpathspec);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * ggit_index_remove_all:
+ * @idx: a #GgitIndex.
+ * @pathspec: (array zero-terminated=1) (allow-none): the pathspecs of the
+ *            entries to remove, or %NULL to remove all the entries.
+ * @callback: (scope call) (allow-none): a #GgitIndexMatchedPathCallback,
+ *            or %NULL.
+ * @user_data: (closure): callback user data.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Remove all the index entries matching @pathspec. @callback is called for
+ * each matching entry before it is removed.
+ *
+ * Returns: %TRUE if the entries were removed or %FALSE if there was an error.
+ *
+ **/
+gboolean
+ggit_index_remove_all (GgitIndex                     *idx,
+                       const gchar * const           *pathspec,
+                       GgitIndexMatchedPathCallback   callback,
+                       gpointer                       user_data,
+                       GError                       **error)
+{
+	MatchedPathWrapperData wrapper_data = { 0, };
+	git_strarray gpathspec;
+	gint ret;
+
+	g_return_val_if_fail (GGIT_IS_INDEX (idx), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	ggit_utils_get_git_strarray_from_str_array (pathspec, &gpathspec);
+
+	wrapper_data.callback = callback;
+	wrapper_data.user_data = user_data;
+
+	ret = git_index_remove_all (_ggit_native_get (idx),
+	                            &gpathspec,
+	                            callback != NULL ? matched_path_wrapper : NULL,
+	                            &wrapper_data);
+
+	git_strarray_free (&gpathspec);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
 /**
  * ggit_index_get_owner:
  * @idx: a #GgitIndex.
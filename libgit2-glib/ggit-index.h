@@ -42,6 +42,13 @@ gboolean                  ggit_index_read                     (GgitIndex  *idx,
                                                                gboolean    force,
                                                                GError    **error);
 
+gboolean                  ggit_index_has_changed              (GgitIndex  *idx);
+
+gboolean                  ggit_index_reload                   (GgitIndex  *idx,
+                                                               GError    **error);
+
+guint                     ggit_index_get_reloads_avoided      (GgitIndex  *idx);
+
 gboolean                  ggit_index_write                    (GgitIndex  *idx,
                                                                GError    **error);
 
@@ -69,6 +76,25 @@ gboolean                  ggit_index_add_path                 (GgitIndex       *
                                                                const gchar     *path,
                                                                GError         **error);
 
+gboolean                  ggit_index_add_all                  (GgitIndex                     *idx,
+                                                               const gchar * const           *pathspec,
+                                                               GgitIndexAddOption             flags,
+                                                               GgitIndexMatchedPathCallback   callback,
+                                                               gpointer                       user_data,
+                                                               GError                       **error);
+
+gboolean                  ggit_index_update_all               (GgitIndex                     *idx,
+                                                               const gchar * const           *pathspec,
+                                                               GgitIndexMatchedPathCallback   callback,
+                                                               gpointer                       user_data,
+                                                               GError                       **error);
+
+gboolean                  ggit_index_remove_all               (GgitIndex                     *idx,
+                                                               const gchar * const           *pathspec,
+                                                               GgitIndexMatchedPathCallback   callback,
+                                                               gpointer                       user_data,
+                                                               GError                       **error);
+
 GgitRepository           *ggit_index_get_owner                (GgitIndex  *idx);
 
 gboolean                  ggit_index_has_conflicts            (GgitIndex  *idx);
@@ -77,6 +103,8 @@ GgitIndexEntries         *ggit_index_get_entries              (GgitIndex  *idx);
 GgitIndexEntriesResolveUndo *
                           ggit_index_get_entries_resolve_undo (GgitIndex  *idx);
 
+GgitIndexSnapshot        *ggit_index_get_snapshot             (GgitIndex  *idx);
+
 G_END_DECLS
 
 #endif /* __GGIT_INDEX_H__ */
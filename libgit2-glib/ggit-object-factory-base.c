@@ -20,6 +20,7 @@
 
 #include "ggit-object-factory-base.h"
 #include "ggit-object-factory.h"
+#include "ggit-utils.h"
 
 /**
  * GgitObjectFactoryBase:
@@ -34,6 +35,16 @@ ggit_object_factory_base_constructor (GType                  type,
                                       guint                  n_construct_properties,
                                       GObjectConstructParam *construct_properties)
 {
+	/* Skip the typemap lookup when nothing can override @type */
+	if (!_ggit_object_factory_has_overrides ())
+	{
+		GObjectClass *parent_class = ggit_object_factory_base_parent_class;
+
+		return parent_class->constructor (type,
+		                                  n_construct_properties,
+		                                  construct_properties);
+	}
+
 	return ggit_object_factory_construct (ggit_object_factory_get_default (),
 	                                      ggit_object_factory_base_parent_class,
 	                                      type,
@@ -20,6 +20,7 @@
 
 #include "ggit-object-factory.h"
 #include "ggit-object-factory-base.h"
+#include "ggit-utils.h"
 
 typedef struct
 {
@@ -43,6 +44,11 @@ G_DEFINE_TYPE (GgitObjectFactory, ggit_object_factory, G_TYPE_OBJECT)
 
 static GgitObjectFactory *the_instance = NULL;
 
+/* Number of registered overrides in the_instance, read without locking by
+ * the object construction fast path.
+ */
+static gint n_overrides = 0;
+
 static TypeWrap *
 type_wrap_new (GType type)
 {
@@ -68,6 +74,7 @@ ggit_object_factory_finalize (GObject *object)
 	factory = GGIT_OBJECT_FACTORY (object);
 
 	g_hash_table_destroy (factory->typemap);
+	g_atomic_int_set (&n_overrides, 0);
 
 	G_OBJECT_CLASS (ggit_object_factory_parent_class)->finalize (object);
 }
@@ -155,6 +162,8 @@ ggit_object_factory_register (GgitObjectFactory *factory,
 	g_hash_table_insert (factory->typemap,
 	                     GINT_TO_POINTER (g_type_qname (basetype)),
 	                     type_wrap_new (subtype));
+
+	g_atomic_int_set (&n_overrides, g_hash_table_size (factory->typemap));
 }
 
 /**
@@ -182,9 +191,20 @@ ggit_object_factory_unregister (GgitObjectFactory *factory,
 	{
 		g_hash_table_remove (factory->typemap,
 		                     GINT_TO_POINTER (g_type_qname (basetype)));
+
+		g_atomic_int_set (&n_overrides, g_hash_table_size (factory->typemap));
 	}
 }
 
+/* Whether any subtype is registered with the default factory. When there
+ * is none, objects can be constructed without ggit_object_factory_construct().
+ */
+gboolean
+_ggit_object_factory_has_overrides (void)
+{
+	return g_atomic_int_get (&n_overrides) != 0;
+}
+
 /**
  * ggit_object_factory_construct:
  * @factory: a #GgitObjectFactory.
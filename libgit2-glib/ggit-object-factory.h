@@ -46,7 +46,6 @@ GObject           *ggit_object_factory_construct   (GgitObjectFactory     *facto
                                                     guint                  n_construct_properties,
                                                     GObjectConstructParam *construct_properties);
 
-
 G_END_DECLS
 
 #endif /* __GGIT_OBJECT_FACTORY_H__ */
@@ -22,6 +22,8 @@
 #if LIBGIT2_VER_MAJOR > 1 || (LIBGIT2_VER_MAJOR == 1 && LIBGIT2_VER_MINOR >= 8)
 #include <git2/sys/errors.h>
 #endif
+#include <gio/gio.h>
+
 #include "ggit-remote-callbacks.h"
 #include "ggit-cred.h"
 #include "ggit-transfer-progress.h"
@@ -50,6 +52,18 @@ enum
 
 static guint signals[NUM_SIGNALS] = {0,};
 
+typedef struct
+{
+	/* Must be the first member, see _ggit_remote_callbacks_free_cancellable */
+	git_remote_callbacks native;
+
+	git_remote_callbacks chained;
+	GCancellable *cancellable;
+
+	git_transfer_progress_cb progress_hook;
+	gpointer progress_hook_data;
+} CancellableCallbacks;
+
 /**
  * GgitRemoteCallbacksClass::credentials:
  * @callbacks: a #GgitRemoteCallbacks.
@@ -281,4 +295,237 @@ _ggit_remote_callbacks_get_native (GgitRemoteCallbacks *callbacks)
 	return &priv->native;
 }
 
+static int
+cancellable_credentials_wrap (git_cred     **cred,
+                              const char    *url,
+                              const char    *username_from_url,
+                              unsigned int   allowed_types,
+                              void          *data)
+{
+	CancellableCallbacks *cc = data;
+
+	if (g_cancellable_is_cancelled (cc->cancellable))
+	{
+		return GIT_EUSER;
+	}
+
+	return cc->chained.credentials (cred,
+	                                url,
+	                                username_from_url,
+	                                allowed_types,
+	                                cc->chained.payload);
+}
+
+static int
+cancellable_progress_wrap (const char *str,
+                           int         len,
+                           void       *data)
+{
+	CancellableCallbacks *cc = data;
+
+	if (g_cancellable_is_cancelled (cc->cancellable))
+	{
+		return GIT_EUSER;
+	}
+
+	if (cc->chained.sideband_progress != NULL)
+	{
+		gint ret;
+
+		ret = cc->chained.sideband_progress (str, len, cc->chained.payload);
+
+		if (ret != GIT_OK)
+		{
+			return ret;
+		}
+	}
+
+	/* The handlers may have cancelled the operation themselves */
+	return g_cancellable_is_cancelled (cc->cancellable) ? GIT_EUSER : GIT_OK;
+}
+
+static int
+cancellable_transfer_progress_wrap (const git_transfer_progress *stats,
+                                    void                        *data)
+{
+	CancellableCallbacks *cc = data;
+
+	if (g_cancellable_is_cancelled (cc->cancellable))
+	{
+		return GIT_EUSER;
+	}
+
+	if (cc->progress_hook != NULL)
+	{
+		gint ret;
+
+		ret = cc->progress_hook (stats, cc->progress_hook_data);
+
+		if (ret != GIT_OK)
+		{
+			return ret;
+		}
+	}
+
+	if (cc->chained.transfer_progress != NULL)
+	{
+		gint ret;
+
+		ret = cc->chained.transfer_progress (stats, cc->chained.payload);
+
+		if (ret != GIT_OK)
+		{
+			return ret;
+		}
+	}
+
+	/* The handlers may have cancelled the operation themselves */
+	return g_cancellable_is_cancelled (cc->cancellable) ? GIT_EUSER : GIT_OK;
+}
+
+static int
+cancellable_update_tips_wrap (const char    *refname,
+                              const git_oid *a,
+                              const git_oid *b,
+                              void          *data)
+{
+	CancellableCallbacks *cc = data;
+
+	if (cc->chained.update_tips == NULL)
+	{
+		return GIT_OK;
+	}
+
+	return cc->chained.update_tips (refname, a, b, cc->chained.payload);
+}
+
+static int
+cancellable_completion_wrap (git_remote_completion_type  type,
+                             void                       *data)
+{
+	CancellableCallbacks *cc = data;
+
+	if (cc->chained.completion == NULL)
+	{
+		return GIT_OK;
+	}
+
+	return cc->chained.completion (type, cc->chained.payload);
+}
+
+static int
+cancellable_pack_progress_wrap (int       stage,
+                                uint32_t  current,
+                                uint32_t  total,
+                                void     *data)
+{
+	CancellableCallbacks *cc = data;
+
+	return g_cancellable_is_cancelled (cc->cancellable) ? GIT_EUSER : GIT_OK;
+}
+
+static int
+cancellable_push_transfer_progress_wrap (unsigned int  current,
+                                         unsigned int  total,
+                                         size_t        bytes,
+                                         void         *data)
+{
+	CancellableCallbacks *cc = data;
+
+	return g_cancellable_is_cancelled (cc->cancellable) ? GIT_EUSER : GIT_OK;
+}
+
+/*
+ * _ggit_remote_callbacks_new_cancellable:
+ * @callbacks: (allow-none): the native callbacks to chain up to, or %NULL.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ *
+ * Creates native remote callbacks which forward to @callbacks but abort
+ * the running remote operation with %GIT_EUSER as soon as @cancellable
+ * is cancelled. The progress callbacks (including the push and pack
+ * builder progress) are invoked continuously during transfers, so
+ * cancellation is noticed almost immediately.
+ *
+ * Only the callbacks installed by #GgitRemoteCallbacks are chained up to.
+ *
+ * Returns: newly allocated callbacks, free with
+ *          _ggit_remote_callbacks_free_cancellable().
+ */
+git_remote_callbacks *
+_ggit_remote_callbacks_new_cancellable (const git_remote_callbacks *callbacks,
+                                        GCancellable               *cancellable)
+{
+	return _ggit_remote_callbacks_new_cancellable_full (callbacks,
+	                                                    cancellable,
+	                                                    NULL,
+	                                                    NULL);
+}
+
+/*
+ * _ggit_remote_callbacks_new_cancellable_full:
+ * @callbacks: (allow-none): the native callbacks to chain up to, or %NULL.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @progress_hook: (allow-none): called for every transfer progress update.
+ * @progress_hook_data: user data for @progress_hook.
+ *
+ * Like _ggit_remote_callbacks_new_cancellable(), but additionally calls
+ * @progress_hook (before chaining up) whenever transfer progress is
+ * reported. A non-zero return value of @progress_hook aborts the transfer.
+ *
+ * Returns: newly allocated callbacks, free with
+ *          _ggit_remote_callbacks_free_cancellable().
+ */
+git_remote_callbacks *
+_ggit_remote_callbacks_new_cancellable_full (const git_remote_callbacks *callbacks,
+                                             GCancellable               *cancellable,
+                                             git_transfer_progress_cb    progress_hook,
+                                             gpointer                    progress_hook_data)
+{
+	git_remote_callbacks gcallbacks = GIT_REMOTE_CALLBACKS_INIT;
+	CancellableCallbacks *cc;
+
+	cc = g_slice_new0 (CancellableCallbacks);
+
+	cc->native = gcallbacks;
+	cc->chained = callbacks != NULL ? *callbacks : gcallbacks;
+
+	if (cancellable != NULL)
+	{
+		cc->cancellable = g_object_ref (cancellable);
+	}
+
+	cc->progress_hook = progress_hook;
+	cc->progress_hook_data = progress_hook_data;
+
+	cc->native.sideband_progress = cancellable_progress_wrap;
+	cc->native.transfer_progress = cancellable_transfer_progress_wrap;
+	cc->native.update_tips = cancellable_update_tips_wrap;
+	cc->native.completion = cancellable_completion_wrap;
+	cc->native.pack_progress = cancellable_pack_progress_wrap;
+	cc->native.push_transfer_progress = cancellable_push_transfer_progress_wrap;
+
+	if (cc->chained.credentials != NULL)
+	{
+		cc->native.credentials = cancellable_credentials_wrap;
+	}
+
+	cc->native.payload = cc;
+
+	return &cc->native;
+}
+
+void
+_ggit_remote_callbacks_free_cancellable (git_remote_callbacks *callbacks)
+{
+	CancellableCallbacks *cc = (CancellableCallbacks *)callbacks;
+
+	if (cc == NULL)
+	{
+		return;
+	}
+
+	g_clear_object (&cc->cancellable);
+	g_slice_free (CancellableCallbacks, cc);
+}
+
 /* ex:set ts=8 noet: */
@@ -23,6 +23,7 @@
 #define __GGIT_REMOTE_CALLBACKS_H__
 
 #include <glib-object.h>
+#include <gio/gio.h>
 #include <git2.h>
 #include <libgit2-glib/ggit-cred.h>
 
@@ -62,6 +63,15 @@ struct _GgitRemoteCallbacksClass
 
 git_remote_callbacks *_ggit_remote_callbacks_get_native (GgitRemoteCallbacks *remote_cbs);
 
+git_remote_callbacks *_ggit_remote_callbacks_new_cancellable  (const git_remote_callbacks *callbacks,
+                                                               GCancellable               *cancellable);
+git_remote_callbacks *_ggit_remote_callbacks_new_cancellable_full
+                                                              (const git_remote_callbacks *callbacks,
+                                                               GCancellable               *cancellable,
+                                                               git_transfer_progress_cb    progress_hook,
+                                                               gpointer                    progress_hook_data);
+void                  _ggit_remote_callbacks_free_cancellable (git_remote_callbacks       *callbacks);
+
 G_END_DECLS
 
 #endif /* __GGIT_REMOTE_CALLBACKS_H__ */
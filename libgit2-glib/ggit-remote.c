@@ -19,6 +19,7 @@
  */
 
 #include <git2.h>
+#include <gio/gio.h>
 
 #include "ggit-remote.h"
 #include "ggit-error.h"
@@ -41,9 +42,46 @@ struct _GgitRemoteHead
 	gint ref_count;
 };
 
+typedef enum
+{
+	REMOTE_OPERATION_CONNECT,
+	REMOTE_OPERATION_DOWNLOAD,
+	REMOTE_OPERATION_UPDATE_TIPS,
+	REMOTE_OPERATION_PUSH
+} RemoteOperation;
+
+typedef struct
+{
+	RemoteOperation operation;
+
+	GgitDirection direction;
+	GgitRemoteCallbacks *callbacks;
+	GgitProxyOptions *proxy_options;
+	gchar **custom_headers;
+
+	gchar **specs;
+	GgitFetchOptions *fetch_options;
+	GgitPushOptions *push_options;
+
+	gboolean update_fetch_head;
+	GgitRemoteDownloadTagsType tags_type;
+	gchar *message;
+} AsyncData;
+
 G_DEFINE_TYPE (GgitRemote, ggit_remote, GGIT_TYPE_NATIVE)
 G_DEFINE_BOXED_TYPE (GgitRemoteHead, ggit_remote_head, ggit_remote_head_ref, ggit_remote_head_unref)
 
+/* All asynchronous remote operations are run on a single shared pool so
+ * that the number of concurrent transfers can be bounded process wide.
+ * A repository must not be used by two operations at the same time, so
+ * operations are serialized per owning repository: while one is running,
+ * the next ones for the same repository wait in its queue in async_owners.
+ */
+G_LOCK_DEFINE_STATIC (async_pool);
+static GThreadPool *async_pool = NULL;
+static guint max_async_operations = 0;
+static GHashTable *async_owners = NULL;
+
 static GgitRemoteHead *
 _ggit_remote_head_wrap (const git_remote_head *remote_head)
 {
@@ -290,6 +328,62 @@ ggit_remote_get_url (GgitRemote *remote)
 	return git_remote_url (_ggit_native_get (remote));
 }
 
+static void
+set_remote_error (gint           ret,
+                  GCancellable  *cancellable,
+                  GError       **error)
+{
+	if (!g_cancellable_set_error_if_cancelled (cancellable, error))
+	{
+		_ggit_error_set (error, ret);
+	}
+}
+
+static gboolean
+remote_connect (GgitRemote           *remote,
+                GgitDirection         direction,
+                GgitRemoteCallbacks  *callbacks,
+                GgitProxyOptions     *proxy_options,
+                const gchar * const  *custom_headers,
+                GCancellable         *cancellable,
+                GError              **error)
+{
+	gint ret;
+	git_strarray headers;
+	const git_remote_callbacks *native_callbacks = NULL;
+	git_remote_callbacks *cancellable_callbacks = NULL;
+
+	if (callbacks != NULL)
+	{
+		native_callbacks = _ggit_remote_callbacks_get_native (callbacks);
+	}
+
+	if (cancellable != NULL)
+	{
+		cancellable_callbacks = _ggit_remote_callbacks_new_cancellable (native_callbacks,
+		                                                                cancellable);
+		native_callbacks = cancellable_callbacks;
+	}
+
+	ggit_utils_get_git_strarray_from_str_array (custom_headers, &headers);
+
+	ret = git_remote_connect (_ggit_native_get (remote),
+	                          (git_direction)direction,
+	                          native_callbacks,
+	                          proxy_options != NULL ? _ggit_proxy_options_get_proxy_options (proxy_options) : NULL,
+	                          &headers);
+
+	_ggit_remote_callbacks_free_cancellable (cancellable_callbacks);
+
+	if (ret != GIT_OK)
+	{
+		set_remote_error (ret, cancellable, error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
 /**
  * ggit_remote_connect:
  * @remote: a #GgitRemote.
@@ -312,24 +406,16 @@ ggit_remote_connect (GgitRemote           *remote,
                      const gchar * const  *custom_headers,
                      GError              **error)
 {
-	gint ret;
-	git_strarray headers;
-
 	g_return_if_fail (GGIT_IS_REMOTE (remote));
 	g_return_if_fail (error == NULL || *error == NULL);
 
-	ggit_utils_get_git_strarray_from_str_array (custom_headers, &headers);
-
-	ret = git_remote_connect (_ggit_native_get (remote),
-	                          (git_direction)direction,
-	                          _ggit_remote_callbacks_get_native (callbacks),
-	                          proxy_options != NULL ? _ggit_proxy_options_get_proxy_options (proxy_options) : NULL,
-	                          &headers);
-
-	if (ret != GIT_OK)
-	{
-		_ggit_error_set (error, ret);
-	}
+	remote_connect (remote,
+	                direction,
+	                callbacks,
+	                proxy_options,
+	                custom_headers,
+	                NULL,
+	                error);
 }
 
 /**
@@ -364,6 +450,50 @@ ggit_remote_disconnect (GgitRemote *remote)
 }
 
 
+static gboolean
+remote_push (GgitRemote           *remote,
+             const gchar * const  *specs,
+             GgitPushOptions      *push_options,
+             GCancellable         *cancellable,
+             GError              **error)
+{
+	gint ret;
+	git_strarray gspecs;
+	git_push_options options = GIT_PUSH_OPTIONS_INIT;
+	const git_push_options *native_options;
+	git_remote_callbacks *cancellable_callbacks = NULL;
+
+	native_options = _ggit_push_options_get_push_options (push_options);
+
+	if (cancellable != NULL)
+	{
+		if (native_options != NULL)
+		{
+			options = *native_options;
+		}
+
+		cancellable_callbacks = _ggit_remote_callbacks_new_cancellable (&options.callbacks,
+		                                                                cancellable);
+		options.callbacks = *cancellable_callbacks;
+		native_options = &options;
+	}
+
+	ggit_utils_get_git_strarray_from_str_array (specs, &gspecs);
+
+	ret = git_remote_push (_ggit_native_get (remote), &gspecs,
+	                       native_options);
+
+	_ggit_remote_callbacks_free_cancellable (cancellable_callbacks);
+
+	if (ret != GIT_OK)
+	{
+		set_remote_error (ret, cancellable, error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
 /**
  * ggit_remote_push:
  * @remote: a #GgitRemote.
@@ -382,21 +512,51 @@ ggit_remote_push (GgitRemote          *remote,
                   const gchar * const *specs,
                   GgitPushOptions     *push_options,
                   GError             **error)
+{
+	g_return_val_if_fail (GGIT_IS_REMOTE (remote), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	return remote_push (remote, specs, push_options, NULL, error);
+}
+
+static gboolean
+remote_download (GgitRemote           *remote,
+                 const gchar * const  *specs,
+                 GgitFetchOptions     *fetch_options,
+                 GCancellable         *cancellable,
+                 GError              **error)
 {
 	gint ret;
 	git_strarray gspecs;
+	git_fetch_options options = GIT_FETCH_OPTIONS_INIT;
+	const git_fetch_options *native_options;
+	git_remote_callbacks *cancellable_callbacks = NULL;
 
-	g_return_val_if_fail (GGIT_IS_REMOTE (remote), FALSE);
-	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+	native_options = _ggit_fetch_options_get_fetch_options (fetch_options);
+
+	if (cancellable != NULL)
+	{
+		if (native_options != NULL)
+		{
+			options = *native_options;
+		}
+
+		cancellable_callbacks = _ggit_remote_callbacks_new_cancellable (&options.callbacks,
+		                                                                cancellable);
+		options.callbacks = *cancellable_callbacks;
+		native_options = &options;
+	}
 
 	ggit_utils_get_git_strarray_from_str_array (specs, &gspecs);
 
-	ret = git_remote_push (_ggit_native_get (remote), &gspecs,
-	                       _ggit_push_options_get_push_options (push_options));
+	ret = git_remote_download (_ggit_native_get (remote), &gspecs,
+	                           native_options);
+
+	_ggit_remote_callbacks_free_cancellable (cancellable_callbacks);
 
 	if (ret != GIT_OK)
 	{
-		_ggit_error_set (error, ret);
+		set_remote_error (ret, cancellable, error);
 		return FALSE;
 	}
 
@@ -422,16 +582,39 @@ ggit_remote_download (GgitRemote           *remote,
                       GgitFetchOptions     *fetch_options,
                       GError              **error)
 {
-	gint ret;
-	git_strarray gspecs;
-
 	g_return_val_if_fail (GGIT_IS_REMOTE (remote), FALSE);
 	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-	ggit_utils_get_git_strarray_from_str_array (specs, &gspecs);
+	return remote_download (remote, specs, fetch_options, NULL, error);
+}
 
-	ret = git_remote_download (_ggit_native_get (remote), &gspecs,
-	                           _ggit_fetch_options_get_fetch_options (fetch_options));
+static gboolean
+remote_update_tips (GgitRemote                  *remote,
+                    GgitRemoteCallbacks         *callbacks,
+                    gboolean                     update_fetch_head,
+                    GgitRemoteDownloadTagsType   tags_type,
+                    const gchar                 *message,
+                    GCancellable                *cancellable,
+                    GError                     **error)
+{
+	gint ret;
+	const git_remote_callbacks *native_callbacks = NULL;
+
+	if (g_cancellable_set_error_if_cancelled (cancellable, error))
+	{
+		return FALSE;
+	}
+
+	if (callbacks != NULL)
+	{
+		native_callbacks = _ggit_remote_callbacks_get_native (callbacks);
+	}
+
+	ret = git_remote_update_tips (_ggit_native_get (remote),
+	                              native_callbacks,
+	                              update_fetch_head,
+	                              (git_remote_autotag_option_t)tags_type,
+	                              message);
 
 	if (ret != GIT_OK)
 	{
@@ -468,24 +651,510 @@ ggit_remote_update_tips (GgitRemote                  *remote,
                          const gchar                 *message,
                          GError                     **error)
 {
-	gint ret;
-
 	g_return_val_if_fail (GGIT_IS_REMOTE (remote), FALSE);
 	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-	ret = git_remote_update_tips (_ggit_native_get (remote),
-	                              _ggit_remote_callbacks_get_native (callbacks),
-	                              update_fetch_head,
-	                              (git_remote_autotag_option_t)tags_type,
-	                              message);
+	return remote_update_tips (remote,
+	                           callbacks,
+	                           update_fetch_head,
+	                           tags_type,
+	                           message,
+	                           NULL,
+	                           error);
+}
 
-	if (ret != GIT_OK)
+static void
+async_data_free (AsyncData *data)
+{
+	g_clear_object (&data->callbacks);
+	g_clear_object (&data->proxy_options);
+	g_strfreev (data->custom_headers);
+
+	g_strfreev (data->specs);
+
+	if (data->fetch_options != NULL)
 	{
-		_ggit_error_set (error, ret);
-		return FALSE;
+		ggit_fetch_options_free (data->fetch_options);
 	}
 
-	return TRUE;
+	g_clear_object (&data->push_options);
+	g_free (data->message);
+
+	g_slice_free (AsyncData, data);
+}
+
+static void
+async_owner_next (git_repository *owner)
+{
+	GQueue *pending;
+	GTask *next;
+
+	if (owner == NULL)
+	{
+		return;
+	}
+
+	G_LOCK (async_pool);
+
+	pending = g_hash_table_lookup (async_owners, owner);
+	next = g_queue_pop_head (pending);
+
+	if (next != NULL)
+	{
+		g_thread_pool_push (async_pool, next, NULL);
+	}
+	else
+	{
+		g_hash_table_remove (async_owners, owner);
+		g_queue_free (pending);
+	}
+
+	G_UNLOCK (async_pool);
+}
+
+static void
+async_pool_func (gpointer pool_data,
+                 gpointer user_data)
+{
+	GTask *task = pool_data;
+	GgitRemote *remote;
+	git_repository *owner;
+	AsyncData *data;
+	GCancellable *cancellable;
+	GError *error = NULL;
+	gboolean ret = FALSE;
+
+	remote = g_task_get_source_object (task);
+	data = g_task_get_task_data (task);
+	cancellable = g_task_get_cancellable (task);
+	owner = git_remote_owner (_ggit_native_get (remote));
+
+	switch (data->operation)
+	{
+		case REMOTE_OPERATION_CONNECT:
+			ret = remote_connect (remote,
+			                      data->direction,
+			                      data->callbacks,
+			                      data->proxy_options,
+			                      (const gchar * const *)data->custom_headers,
+			                      cancellable,
+			                      &error);
+			break;
+		case REMOTE_OPERATION_DOWNLOAD:
+			ret = remote_download (remote,
+			                       (const gchar * const *)data->specs,
+			                       data->fetch_options,
+			                       cancellable,
+			                       &error);
+			break;
+		case REMOTE_OPERATION_UPDATE_TIPS:
+			ret = remote_update_tips (remote,
+			                          data->callbacks,
+			                          data->update_fetch_head,
+			                          data->tags_type,
+			                          data->message,
+			                          cancellable,
+			                          &error);
+			break;
+		case REMOTE_OPERATION_PUSH:
+			ret = remote_push (remote,
+			                   (const gchar * const *)data->specs,
+			                   data->push_options,
+			                   cancellable,
+			                   &error);
+			break;
+	}
+
+	if (ret)
+	{
+		g_task_return_boolean (task, TRUE);
+	}
+	else
+	{
+		g_task_return_error (task, error);
+	}
+
+	g_object_unref (task);
+
+	/* Only start the next operation once the result has been returned,
+	 * so that results are delivered in order */
+	async_owner_next (owner);
+}
+
+static void
+run_async (GgitRemote          *remote,
+           AsyncData           *data,
+           GCancellable        *cancellable,
+           GAsyncReadyCallback  callback,
+           gpointer             user_data,
+           gpointer             source_tag)
+{
+	GTask *task;
+	git_repository *owner;
+	GQueue *pending = NULL;
+
+	task = g_task_new (remote, cancellable, callback, user_data);
+	g_task_set_source_tag (task, source_tag);
+	g_task_set_task_data (task, data, (GDestroyNotify)async_data_free);
+
+	owner = git_remote_owner (_ggit_native_get (remote));
+
+	G_LOCK (async_pool);
+
+	if (async_pool == NULL)
+	{
+		if (max_async_operations == 0)
+		{
+			max_async_operations = g_get_num_processors ();
+		}
+
+		async_pool = g_thread_pool_new (async_pool_func,
+		                                NULL,
+		                                (gint)max_async_operations,
+		                                FALSE,
+		                                NULL);
+
+		async_owners = g_hash_table_new (g_direct_hash, g_direct_equal);
+	}
+
+	if (owner != NULL)
+	{
+		pending = g_hash_table_lookup (async_owners, owner);
+	}
+
+	if (pending != NULL)
+	{
+		/* Wait for the running operation on the same repository */
+		g_queue_push_tail (pending, task);
+	}
+	else
+	{
+		if (owner != NULL)
+		{
+			g_hash_table_insert (async_owners, owner, g_queue_new ());
+		}
+
+		g_thread_pool_push (async_pool, task, NULL);
+	}
+
+	G_UNLOCK (async_pool);
+}
+
+/**
+ * ggit_remote_set_max_async_operations:
+ * @max_operations: the maximum number of concurrent operations, or 0 to
+ *                  use the default.
+ *
+ * Sets the maximum number of asynchronous remote operations (such as
+ * ggit_remote_download_async()) which are run concurrently in this process.
+ * Operations exceeding this limit are queued until a running one finishes.
+ * Operations on remotes of the same repository never run concurrently,
+ * they are run one after the other in the order they were started.
+ *
+ * The default is the number of available processors.
+ */
+void
+ggit_remote_set_max_async_operations (guint max_operations)
+{
+	G_LOCK (async_pool);
+
+	max_async_operations = max_operations != 0 ? max_operations : g_get_num_processors ();
+
+	if (async_pool != NULL)
+	{
+		g_thread_pool_set_max_threads (async_pool,
+		                               (gint)max_async_operations,
+		                               NULL);
+	}
+
+	G_UNLOCK (async_pool);
+}
+
+/**
+ * ggit_remote_get_max_async_operations:
+ *
+ * Gets the maximum number of asynchronous remote operations which are run
+ * concurrently in this process. See ggit_remote_set_max_async_operations().
+ *
+ * Returns: the maximum number of concurrent operations.
+ */
+guint
+ggit_remote_get_max_async_operations (void)
+{
+	guint ret;
+
+	G_LOCK (async_pool);
+
+	ret = max_async_operations != 0 ? max_async_operations : g_get_num_processors ();
+
+	G_UNLOCK (async_pool);
+
+	return ret;
+}
+
+/**
+ * ggit_remote_connect_async:
+ * @remote: a #GgitRemote.
+ * @direction: whether you want to receive or send data.
+ * @callbacks: (allow-none): the callbacks to use for this connection.
+ * @proxy_options: (allow-none): the proxy options.
+ * @custom_headers: (allow-none): extra HTTP headers to use in this connection.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the
+ *            connection has been made.
+ * @user_data: the data to pass to @callback.
+ *
+ * Asynchronously opens a connection to a remote on a worker thread. See
+ * ggit_remote_connect() for more information.
+ *
+ * @remote (and its repository) must not be used from other threads until
+ * the operation has finished, other asynchronous operations on the same
+ * repository are queued until then. Signals of @callbacks are emitted on
+ * the worker thread.
+ */
+void
+ggit_remote_connect_async (GgitRemote           *remote,
+                           GgitDirection         direction,
+                           GgitRemoteCallbacks  *callbacks,
+                           GgitProxyOptions     *proxy_options,
+                           const gchar * const  *custom_headers,
+                           GCancellable         *cancellable,
+                           GAsyncReadyCallback   callback,
+                           gpointer              user_data)
+{
+	AsyncData *data;
+
+	g_return_if_fail (GGIT_IS_REMOTE (remote));
+	g_return_if_fail (callbacks == NULL || GGIT_IS_REMOTE_CALLBACKS (callbacks));
+	g_return_if_fail (proxy_options == NULL || GGIT_IS_PROXY_OPTIONS (proxy_options));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	data = g_slice_new0 (AsyncData);
+	data->operation = REMOTE_OPERATION_CONNECT;
+	data->direction = direction;
+	data->callbacks = callbacks != NULL ? g_object_ref (callbacks) : NULL;
+	data->proxy_options = proxy_options != NULL ? g_object_ref (proxy_options) : NULL;
+	data->custom_headers = g_strdupv ((gchar **)custom_headers);
+
+	run_async (remote, data, cancellable, callback, user_data,
+	           ggit_remote_connect_async);
+}
+
+/**
+ * ggit_remote_connect_finish:
+ * @remote: a #GgitRemote.
+ * @result: a #GAsyncResult.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Finishes an operation started with ggit_remote_connect_async().
+ *
+ * Returns: %TRUE if successful, %FALSE otherwise.
+ */
+gboolean
+ggit_remote_connect_finish (GgitRemote    *remote,
+                            GAsyncResult  *result,
+                            GError       **error)
+{
+	g_return_val_if_fail (GGIT_IS_REMOTE (remote), FALSE);
+	g_return_val_if_fail (g_task_is_valid (result, remote), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * ggit_remote_download_async:
+ * @remote: a #GgitRemote.
+ * @specs: (array zero-terminated=1) (allow-none): the ref specs.
+ * @fetch_options: (allow-none): a #GgitFetchOptions.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the
+ *            download has finished.
+ * @user_data: the data to pass to @callback.
+ *
+ * Asynchronously downloads the packfile from the remote on a worker
+ * thread. See ggit_remote_download() for more information.
+ *
+ * Cancelling @cancellable aborts the transfer from within the transfer
+ * progress callbacks, after which the operation finishes with
+ * %G_IO_ERROR_CANCELLED.
+ *
+ * @remote (and its repository) must not be used from other threads until
+ * the operation has finished, other asynchronous operations on the same
+ * repository are queued until then. The number of operations running at
+ * the same time is bounded by ggit_remote_set_max_async_operations().
+ */
+void
+ggit_remote_download_async (GgitRemote           *remote,
+                            const gchar * const  *specs,
+                            GgitFetchOptions     *fetch_options,
+                            GCancellable         *cancellable,
+                            GAsyncReadyCallback   callback,
+                            gpointer              user_data)
+{
+	AsyncData *data;
+
+	g_return_if_fail (GGIT_IS_REMOTE (remote));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	data = g_slice_new0 (AsyncData);
+	data->operation = REMOTE_OPERATION_DOWNLOAD;
+	data->specs = g_strdupv ((gchar **)specs);
+	data->fetch_options = fetch_options != NULL ? ggit_fetch_options_copy (fetch_options) : NULL;
+
+	run_async (remote, data, cancellable, callback, user_data,
+	           ggit_remote_download_async);
+}
+
+/**
+ * ggit_remote_download_finish:
+ * @remote: a #GgitRemote.
+ * @result: a #GAsyncResult.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Finishes an operation started with ggit_remote_download_async().
+ *
+ * Returns: %TRUE if successful, %FALSE otherwise.
+ */
+gboolean
+ggit_remote_download_finish (GgitRemote    *remote,
+                             GAsyncResult  *result,
+                             GError       **error)
+{
+	g_return_val_if_fail (GGIT_IS_REMOTE (remote), FALSE);
+	g_return_val_if_fail (g_task_is_valid (result, remote), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * ggit_remote_update_tips_async:
+ * @remote: a #GgitRemote.
+ * @callbacks: (allow-none): a #GgitRemoteCallbacks.
+ * @update_fetch_head: whether to write to FETCH_HEAD. %TRUE to behave like git.
+ * @tags_type: what the behaviour for downloading tags is for this fetch.
+ * @message: (allow-none): the message to insert into the reflogs.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the
+ *            tips have been updated.
+ * @user_data: the data to pass to @callback.
+ *
+ * Asynchronously updates the tips to the new state on a worker thread.
+ * See ggit_remote_update_tips() for more information.
+ *
+ * Updating the tips is not interrupted once started, @cancellable is only
+ * checked before the operation runs.
+ */
+void
+ggit_remote_update_tips_async (GgitRemote                  *remote,
+                               GgitRemoteCallbacks         *callbacks,
+                               gboolean                     update_fetch_head,
+                               GgitRemoteDownloadTagsType   tags_type,
+                               const gchar                 *message,
+                               GCancellable                *cancellable,
+                               GAsyncReadyCallback          callback,
+                               gpointer                     user_data)
+{
+	AsyncData *data;
+
+	g_return_if_fail (GGIT_IS_REMOTE (remote));
+	g_return_if_fail (callbacks == NULL || GGIT_IS_REMOTE_CALLBACKS (callbacks));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	data = g_slice_new0 (AsyncData);
+	data->operation = REMOTE_OPERATION_UPDATE_TIPS;
+	data->callbacks = callbacks != NULL ? g_object_ref (callbacks) : NULL;
+	data->update_fetch_head = update_fetch_head;
+	data->tags_type = tags_type;
+	data->message = g_strdup (message);
+
+	run_async (remote, data, cancellable, callback, user_data,
+	           ggit_remote_update_tips_async);
+}
+
+/**
+ * ggit_remote_update_tips_finish:
+ * @remote: a #GgitRemote.
+ * @result: a #GAsyncResult.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Finishes an operation started with ggit_remote_update_tips_async().
+ *
+ * Returns: %TRUE if successful, %FALSE otherwise.
+ */
+gboolean
+ggit_remote_update_tips_finish (GgitRemote    *remote,
+                                GAsyncResult  *result,
+                                GError       **error)
+{
+	g_return_val_if_fail (GGIT_IS_REMOTE (remote), FALSE);
+	g_return_val_if_fail (g_task_is_valid (result, remote), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * ggit_remote_push_async:
+ * @remote: a #GgitRemote.
+ * @specs: (array zero-terminated=1) (allow-none): the ref specs.
+ * @push_options: (allow-none): a #GgitPushOptions.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the
+ *            push has finished.
+ * @user_data: the data to pass to @callback.
+ *
+ * Asynchronously pushes to the remote on a worker thread. See
+ * ggit_remote_push() for more information.
+ *
+ * Cancelling @cancellable aborts packing and the transfer from within the
+ * progress callbacks, after which the operation finishes with
+ * %G_IO_ERROR_CANCELLED.
+ */
+void
+ggit_remote_push_async (GgitRemote           *remote,
+                        const gchar * const  *specs,
+                        GgitPushOptions      *push_options,
+                        GCancellable         *cancellable,
+                        GAsyncReadyCallback   callback,
+                        gpointer              user_data)
+{
+	AsyncData *data;
+
+	g_return_if_fail (GGIT_IS_REMOTE (remote));
+	g_return_if_fail (push_options == NULL || GGIT_IS_PUSH_OPTIONS (push_options));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	data = g_slice_new0 (AsyncData);
+	data->operation = REMOTE_OPERATION_PUSH;
+	data->specs = g_strdupv ((gchar **)specs);
+	data->push_options = push_options != NULL ? g_object_ref (push_options) : NULL;
+
+	run_async (remote, data, cancellable, callback, user_data,
+	           ggit_remote_push_async);
+}
+
+/**
+ * ggit_remote_push_finish:
+ * @remote: a #GgitRemote.
+ * @result: a #GAsyncResult.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Finishes an operation started with ggit_remote_push_async().
+ *
+ * Returns: %TRUE if successful, %FALSE otherwise.
+ */
+gboolean
+ggit_remote_push_finish (GgitRemote    *remote,
+                         GAsyncResult  *result,
+                         GError       **error)
+{
+	g_return_val_if_fail (GGIT_IS_REMOTE (remote), FALSE);
+	g_return_val_if_fail (g_task_is_valid (result, remote), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
 }
 
 /**
@@ -22,6 +22,7 @@
 #define __GGIT_REMOTE_H__
 
 #include <glib-object.h>
+#include <gio/gio.h>
 #include <git2.h>
 
 #include <libgit2-glib/ggit-types.h>
@@ -101,6 +102,58 @@ gboolean           ggit_remote_update_tips              (GgitRemote
                                                          const gchar                 *message,
                                                          GError                     **error);
 
+void               ggit_remote_set_max_async_operations (guint                max_operations);
+
+guint              ggit_remote_get_max_async_operations (void);
+
+void               ggit_remote_connect_async            (GgitRemote           *remote,
+                                                         GgitDirection         direction,
+                                                         GgitRemoteCallbacks  *callbacks,
+                                                         GgitProxyOptions     *proxy_options,
+                                                         const gchar * const  *custom_headers,
+                                                         GCancellable         *cancellable,
+                                                         GAsyncReadyCallback   callback,
+                                                         gpointer              user_data);
+
+gboolean           ggit_remote_connect_finish           (GgitRemote           *remote,
+                                                         GAsyncResult         *result,
+                                                         GError              **error);
+
+void               ggit_remote_download_async           (GgitRemote           *remote,
+                                                         const gchar * const  *specs,
+                                                         GgitFetchOptions     *fetch_options,
+                                                         GCancellable         *cancellable,
+                                                         GAsyncReadyCallback   callback,
+                                                         gpointer              user_data);
+
+gboolean           ggit_remote_download_finish          (GgitRemote           *remote,
+                                                         GAsyncResult         *result,
+                                                         GError              **error);
+
+void               ggit_remote_update_tips_async        (GgitRemote                  *remote,
+                                                         GgitRemoteCallbacks         *callbacks,
+                                                         gboolean                     update_fetch_head,
+                                                         GgitRemoteDownloadTagsType   tags_type,
+                                                         const gchar                 *message,
+                                                         GCancellable                *cancellable,
+                                                         GAsyncReadyCallback          callback,
+                                                         gpointer                     user_data);
+
+gboolean           ggit_remote_update_tips_finish       (GgitRemote           *remote,
+                                                         GAsyncResult         *result,
+                                                         GError              **error);
+
+void               ggit_remote_push_async               (GgitRemote           *remote,
+                                                         const gchar * const  *specs,
+                                                         GgitPushOptions      *push_options,
+                                                         GCancellable         *cancellable,
+                                                         GAsyncReadyCallback   callback,
+                                                         gpointer              user_data);
+
+gboolean           ggit_remote_push_finish              (GgitRemote           *remote,
+                                                         GAsyncResult         *result,
+                                                         GError              **error);
+
 gchar            **ggit_remote_get_fetch_specs          (GgitRemote       *remote,
                                                          GError          **error);
 
@@ -18,6 +18,7 @@
  * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include <gio/gio.h>
 #include <git2.h>
 #include <git2/sys/commit.h>
@@ -28,6 +29,7 @@
 #include "ggit-repository.h"
 #include "ggit-utils.h"
 #include "ggit-remote.h"
+#include "ggit-remote-callbacks.h"
 #include "ggit-submodule.h"
 #include "ggit-signature.h"
 #include "ggit-clone-options.h"
@@ -47,6 +49,8 @@
 #include "ggit-tag.h"
 
 
+typedef struct _ObjectCache ObjectCache;
+
 typedef struct _GgitRepositoryPrivate
 {
 	gchar *url;
@@ -54,6 +58,7 @@ typedef struct _GgitRepositoryPrivate
 	GFile *workdir;
 
 	GgitCloneOptions *clone_options;
+	ObjectCache *object_cache;
 
 	guint is_bare : 1;
 	guint init : 1;
@@ -72,53 +77,252 @@ enum
 };
 
 static void ggit_repository_initable_iface_init (GInitableIface  *iface);
+static void ggit_repository_async_initable_iface_init (GAsyncInitableIface *iface);
 
 G_DEFINE_TYPE_EXTENDED (GgitRepository, ggit_repository, GGIT_TYPE_NATIVE,
                         0,
                         G_ADD_PRIVATE (GgitRepository)
                         G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE,
-                                               ggit_repository_initable_iface_init))
+                                               ggit_repository_initable_iface_init)
+                        G_IMPLEMENT_INTERFACE (G_TYPE_ASYNC_INITABLE,
+                                               ggit_repository_async_initable_iface_init))
 
+/* Repositories can be opened and cloned on worker threads (see
+ * #GAsyncInitable), so access to the registry needs to be serialized.
+ */
+G_LOCK_DEFINE_STATIC (registry);
 static GHashTable *registry = NULL;
 
 static GgitRepository *
 repository_from_registry (git_repository *repository)
 {
-	if (registry == NULL)
+	GgitRepository *ret = NULL;
+
+	G_LOCK (registry);
+
+	if (registry != NULL)
 	{
-		return NULL;
+		ret = g_hash_table_lookup (registry, repository);
 	}
 
-	return g_hash_table_lookup (registry, repository);
+	G_UNLOCK (registry);
+
+	return ret;
 }
 
 static void
 register_repository (git_repository *repository,
                      GgitRepository *wrapper)
 {
+	G_LOCK (registry);
+
 	if (registry == NULL)
 	{
 		registry = g_hash_table_new (g_direct_hash, g_direct_equal);
 	}
 
 	g_hash_table_insert (registry, repository, wrapper);
+
+	G_UNLOCK (registry);
 }
 
 static void
 unregister_repository (git_repository *repository)
 {
-	if (registry == NULL)
+	G_LOCK (registry);
+
+	if (registry != NULL)
 	{
-		return;
+		g_hash_table_remove (registry, repository);
+
+		if (g_hash_table_size (registry) == 0)
+		{
+			g_hash_table_destroy (registry);
+			registry = NULL;
+		}
+	}
+
+	G_UNLOCK (registry);
+}
+
+/* The object cache maps raw object ids to the live #GgitObject wrappers
+ * created by the lookup functions. Entries only hold a weak reference to
+ * the wrapper and remove themselves when the wrapper is finalized. The
+ * cache itself is reference counted since wrappers may outlive the
+ * repository wrapper.
+ */
+struct _ObjectCache
+{
+	gint ref_count;
+
+	GMutex lock;
+	GHashTable *entries;
+	gboolean enabled;
+
+	guint hits;
+	guint misses;
+};
+
+typedef struct
+{
+	ObjectCache *cache;
+	git_oid oid;
+	GWeakRef object;
+} ObjectCacheEntry;
+
+static guint
+object_cache_hash (gconstpointer key)
+{
+	const git_oid *oid = key;
+	guint ret;
+
+	/* object ids are uniformly distributed already */
+	memcpy (&ret, oid->id, sizeof (ret));
+
+	return ret;
+}
+
+static gboolean
+object_cache_equal (gconstpointer a,
+                    gconstpointer b)
+{
+	return git_oid_cmp (a, b) == 0;
+}
+
+static ObjectCache *
+object_cache_new (void)
+{
+	ObjectCache *cache;
+
+	cache = g_slice_new0 (ObjectCache);
+	cache->ref_count = 1;
+
+	g_mutex_init (&cache->lock);
+	cache->entries = g_hash_table_new (object_cache_hash, object_cache_equal);
+
+	return cache;
+}
+
+static ObjectCache *
+object_cache_ref (ObjectCache *cache)
+{
+	g_atomic_int_inc (&cache->ref_count);
+	return cache;
+}
+
+static void
+object_cache_unref (ObjectCache *cache)
+{
+	if (g_atomic_int_dec_and_test (&cache->ref_count))
+	{
+		g_hash_table_destroy (cache->entries);
+		g_mutex_clear (&cache->lock);
+
+		g_slice_free (ObjectCache, cache);
+	}
+}
+
+static void
+object_cache_entry_notify (gpointer  data,
+                           GObject  *where_the_object_was)
+{
+	ObjectCacheEntry *entry = data;
+	ObjectCache *cache = entry->cache;
+
+	g_mutex_lock (&cache->lock);
+
+	/* The entry may already have been replaced or dropped */
+	if (g_hash_table_lookup (cache->entries, &entry->oid) == entry)
+	{
+		g_hash_table_remove (cache->entries, &entry->oid);
+	}
+
+	g_mutex_unlock (&cache->lock);
+
+	g_weak_ref_clear (&entry->object);
+	g_slice_free (ObjectCacheEntry, entry);
+
+	object_cache_unref (cache);
+}
+
+static GgitObject *
+object_cache_lookup (ObjectCache   *cache,
+                     const git_oid *oid,
+                     git_otype      otype)
+{
+	ObjectCacheEntry *entry;
+	GgitObject *ret = NULL;
+	gboolean mismatch = FALSE;
+
+	g_mutex_lock (&cache->lock);
+
+	if (!cache->enabled)
+	{
+		g_mutex_unlock (&cache->lock);
+		return NULL;
+	}
+
+	entry = g_hash_table_lookup (cache->entries, oid);
+
+	if (entry != NULL)
+	{
+		ret = g_weak_ref_get (&entry->object);
+	}
+
+	/* Apply the same type rules as git_object_lookup, a mismatch is left
+	 * to the regular lookup to report. */
+	if (ret != NULL && otype != GIT_OBJ_ANY &&
+	    git_object_type (_ggit_native_get (ret)) != otype)
+	{
+		mismatch = TRUE;
+	}
+
+	if (ret != NULL && !mismatch)
+	{
+		cache->hits++;
+	}
+	else
+	{
+		cache->misses++;
+	}
+
+	g_mutex_unlock (&cache->lock);
+
+	/* Dropping the reference may finalize the object, whose weak notify
+	 * takes the cache lock again. */
+	if (mismatch)
+	{
+		g_clear_object (&ret);
 	}
 
-	g_hash_table_remove (registry, repository);
+	return ret;
+}
+
+static void
+object_cache_insert (ObjectCache *cache,
+                     GgitObject  *object)
+{
+	ObjectCacheEntry *entry;
 
-	if (g_hash_table_size (registry) == 0)
+	g_mutex_lock (&cache->lock);
+
+	if (!cache->enabled)
 	{
-		g_hash_table_destroy (registry);
-		registry = NULL;
+		g_mutex_unlock (&cache->lock);
+		return;
 	}
+
+	entry = g_slice_new (ObjectCacheEntry);
+	entry->cache = object_cache_ref (cache);
+	git_oid_cpy (&entry->oid, git_object_id (_ggit_native_get (object)));
+	g_weak_ref_init (&entry->object, object);
+
+	g_object_weak_ref (G_OBJECT (object), object_cache_entry_notify, entry);
+
+	/* Replaces a stale entry, which frees itself once notified */
+	g_hash_table_replace (cache->entries, &entry->oid, entry);
+
+	g_mutex_unlock (&cache->lock);
 }
 
 /**
@@ -170,6 +374,13 @@ ggit_repository_finalize (GObject *object)
 	g_clear_object (&priv->workdir);
 	g_clear_object (&priv->clone_options);
 
+	g_mutex_lock (&priv->object_cache->lock);
+	priv->object_cache->enabled = FALSE;
+	g_hash_table_remove_all (priv->object_cache->entries);
+	g_mutex_unlock (&priv->object_cache->lock);
+
+	object_cache_unref (priv->object_cache);
+
 	repo = _ggit_native_get (object);
 
 	if (repo != NULL)
@@ -384,6 +595,11 @@ ggit_repository_class_init (GgitRepositoryClass *klass)
 static void
 ggit_repository_init (GgitRepository *repository)
 {
+	GgitRepositoryPrivate *priv;
+
+	priv = ggit_repository_get_instance_private (repository);
+
+	priv->object_cache = object_cache_new ();
 }
 
 static gboolean
@@ -398,10 +614,8 @@ ggit_repository_initable_init (GInitable    *initable,
 	gchar *path = NULL;
 	git_repository *repo = NULL;
 
-	if (cancellable != NULL)
+	if (g_cancellable_set_error_if_cancelled (cancellable, error))
 	{
-		g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
-		                     "Cancellable initialization not supported");
 		return FALSE;
 	}
 
@@ -422,6 +636,30 @@ ggit_repository_initable_init (GInitable    *initable,
 		                           path,
 		                           priv->is_bare);
 	}
+	else if (priv->url != NULL && cancellable != NULL)
+	{
+		git_clone_options options = GIT_CLONE_OPTIONS_INIT;
+		git_remote_callbacks *callbacks;
+
+		if (priv->clone_options != NULL)
+		{
+			options = *_ggit_clone_options_get_native (priv->clone_options);
+		}
+
+		/* Abort the transfer from the progress callbacks as soon as
+		 * the operation gets cancelled.
+		 */
+		callbacks = _ggit_remote_callbacks_new_cancellable (&options.fetch_opts.callbacks,
+		                                                    cancellable);
+		options.fetch_opts.callbacks = *callbacks;
+
+		err = git_clone (&repo,
+		                 priv->url,
+		                 path,
+		                 &options);
+
+		_ggit_remote_callbacks_free_cancellable (callbacks);
+	}
 	else if (priv->url != NULL)
 	{
 		err = git_clone (&repo,
@@ -439,7 +677,10 @@ ggit_repository_initable_init (GInitable    *initable,
 
 	if (err != GIT_OK)
 	{
-		_ggit_error_set (error, err);
+		if (!g_cancellable_set_error_if_cancelled (cancellable, error))
+		{
+			_ggit_error_set (error, err);
+		}
 
 		success = FALSE;
 	}
@@ -474,6 +715,15 @@ ggit_repository_initable_iface_init (GInitableIface *iface)
 	iface->init = ggit_repository_initable_init;
 }
 
+static void
+ggit_repository_async_initable_iface_init (GAsyncInitableIface *iface)
+{
+	/* The default implementation runs ggit_repository_initable_init
+	 * in a worker thread, which is exactly what we want since all
+	 * of libgit2 is blocking.
+	 */
+}
+
 GgitRepository *
 _ggit_repository_wrap (git_repository *repository,
                        gboolean        owned)
@@ -609,91 +859,669 @@ ggit_repository_clone (const gchar       *url,
 	                       NULL);
 }
 
+static GgitRepository *
+repository_new_finish (GAsyncResult  *result,
+                       GError       **error)
+{
+	GObject *source;
+	GObject *ret;
+
+	source = g_async_result_get_source_object (result);
+	ret = g_async_initable_new_finish (G_ASYNC_INITABLE (source),
+	                                   result,
+	                                   error);
+	g_object_unref (source);
+
+	return ret != NULL ? GGIT_REPOSITORY (ret) : NULL;
+}
+
 /**
- * ggit_repository_lookup:
- * @repository: a #GgitRepository.
- * @oid: a #GgitOId.
- * @gtype: a #GType.
+ * ggit_repository_open_async:
+ * @location: the location of the repository.
+ * @io_priority: the I/O priority of the request.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the
+ *            repository has been opened.
+ * @user_data: the data to pass to @callback.
+ *
+ * Asynchronously opens a git repository on a worker thread. See
+ * ggit_repository_open() for more information.
+ *
+ * When the operation is finished, @callback will be called. You can then
+ * call ggit_repository_open_finish() to get the result of the operation.
+ */
+void
+ggit_repository_open_async (GFile               *location,
+                            gint                 io_priority,
+                            GCancellable        *cancellable,
+                            GAsyncReadyCallback  callback,
+                            gpointer             user_data)
+{
+	g_return_if_fail (G_IS_FILE (location));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	g_async_initable_new_async (GGIT_TYPE_REPOSITORY,
+	                            io_priority,
+	                            cancellable,
+	                            callback,
+	                            user_data,
+	                            "location", location,
+	                            NULL);
+}
+
+/**
+ * ggit_repository_open_finish:
+ * @result: a #GAsyncResult.
  * @error: a #GError for error reporting, or %NULL.
  *
- * Lookups a reference to one of the objects in the @repository.
+ * Finishes an operation started with ggit_repository_open_async().
  *
- * The generated reference must be freed with g_object_unref().
+ * Returns: (transfer full) (nullable): a newly created #GgitRepository or
+ *          %NULL in case of an error.
+ */
+GgitRepository *
+ggit_repository_open_finish (GAsyncResult  *result,
+                             GError       **error)
+{
+	g_return_val_if_fail (G_IS_ASYNC_RESULT (result), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	return repository_new_finish (result, error);
+}
+
+/**
+ * ggit_repository_init_repository_async:
+ * @location: the location of the repository.
+ * @is_bare: whether to create a bare repository.
+ * @io_priority: the I/O priority of the request.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the
+ *            repository has been created.
+ * @user_data: the data to pass to @callback.
+ *
+ * Asynchronously creates a new git repository in the given folder on a
+ * worker thread. See ggit_repository_init_repository() for more information.
+ *
+ * When the operation is finished, @callback will be called. You can then
+ * call ggit_repository_init_repository_finish() to get the result of the
+ * operation.
+ */
+void
+ggit_repository_init_repository_async (GFile               *location,
+                                       gboolean             is_bare,
+                                       gint                 io_priority,
+                                       GCancellable        *cancellable,
+                                       GAsyncReadyCallback  callback,
+                                       gpointer             user_data)
+{
+	g_return_if_fail (G_IS_FILE (location));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	g_async_initable_new_async (GGIT_TYPE_REPOSITORY,
+	                            io_priority,
+	                            cancellable,
+	                            callback,
+	                            user_data,
+	                            "location", location,
+	                            "is-bare", is_bare,
+	                            "init", TRUE,
+	                            NULL);
+}
+
+/**
+ * ggit_repository_init_repository_finish:
+ * @result: a #GAsyncResult.
+ * @error: a #GError for error reporting, or %NULL.
  *
- * The @gtype must match the type of the object
- * in the odb; the method will fail otherwise.
- * The special value %G_TYPE_NONE may be passed to let
- * the method guess the object's type.
+ * Finishes an operation started with ggit_repository_init_repository_async().
  *
- * Returns: (transfer full) (nullable): the found #GgitObject, or %NULL on error.
+ * Returns: (transfer full) (nullable): a newly created #GgitRepository or
+ *          %NULL in case of an error.
  */
-GgitObject *
-ggit_repository_lookup (GgitRepository  *repository,
-                        GgitOId         *oid,
-                        GType            gtype,
-                        GError         **error)
+GgitRepository *
+ggit_repository_init_repository_finish (GAsyncResult  *result,
+                                        GError       **error)
 {
-	GgitObject *object = NULL;
+	g_return_val_if_fail (G_IS_ASYNC_RESULT (result), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	return repository_new_finish (result, error);
+}
+
+/**
+ * ggit_repository_clone_async:
+ * @url: url to fetch the repository from.
+ * @location: the location of the repository.
+ * @options: (allow-none): a #GgitCloneOptions.
+ * @io_priority: the I/O priority of the request.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the
+ *            repository has been cloned.
+ * @user_data: the data to pass to @callback.
+ *
+ * Asynchronously clones a new git repository in the given folder on a
+ * worker thread. See ggit_repository_clone() for more information.
+ *
+ * Cancelling @cancellable aborts the transfer from within the transfer
+ * progress callbacks, so a running clone stops almost immediately and
+ * finishes with %G_IO_ERROR_CANCELLED. Note that the signals of the
+ * #GgitRemoteCallbacks set on @options are emitted on the worker thread.
+ *
+ * When the operation is finished, @callback will be called. You can then
+ * call ggit_repository_clone_finish() to get the result of the operation.
+ */
+void
+ggit_repository_clone_async (const gchar         *url,
+                             GFile               *location,
+                             GgitCloneOptions    *options,
+                             gint                 io_priority,
+                             GCancellable        *cancellable,
+                             GAsyncReadyCallback  callback,
+                             gpointer             user_data)
+{
+	g_return_if_fail (url != NULL);
+	g_return_if_fail (G_IS_FILE (location));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	g_async_initable_new_async (GGIT_TYPE_REPOSITORY,
+	                            io_priority,
+	                            cancellable,
+	                            callback,
+	                            user_data,
+	                            "url", url,
+	                            "location", location,
+	                            "clone-options", options,
+	                            NULL);
+}
+
+/**
+ * ggit_repository_clone_finish:
+ * @result: a #GAsyncResult.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Finishes an operation started with ggit_repository_clone_async().
+ *
+ * Returns: (transfer full) (nullable): a newly created #GgitRepository or
+ *          %NULL in case of an error.
+ */
+GgitRepository *
+ggit_repository_clone_finish (GAsyncResult  *result,
+                              GError       **error)
+{
+	g_return_val_if_fail (G_IS_ASYNC_RESULT (result), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	return repository_new_finish (result, error);
+}
+
+static GgitObject *
+lookup_object (GgitRepository  *repository,
+               GgitOId         *oid,
+               GType            gtype,
+               GError         **error)
+{
+	GgitRepositoryPrivate *priv;
+	GgitObject *object;
 	git_object *obj;
 	const git_oid *id;
 	git_otype otype;
 	gint ret;
 
-	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
+	priv = ggit_repository_get_instance_private (repository);
 
 	id = (const git_oid *)_ggit_oid_get_oid (oid);
+
 	otype = ggit_utils_get_otype_from_gtype (gtype);
 
+	if (otype != GIT_OBJ_BAD)
+	{
+		object = object_cache_lookup (priv->object_cache, id, otype);
+
+		if (object != NULL)
+		{
+			return object;
+		}
+	}
+
 	ret = git_object_lookup (&obj,
 	                         _ggit_native_get (repository),
 	                         id,
 	                         otype);
 
-	if (ret == GIT_OK)
+	if (ret != GIT_OK)
 	{
-		object = ggit_utils_create_real_object (obj, TRUE);
+		_ggit_error_set (error, ret);
+		return NULL;
 	}
-	else
+
+	object = ggit_utils_create_real_object (obj, TRUE);
+
+	if (object != NULL)
 	{
-		_ggit_error_set (error, ret);
+		object_cache_insert (priv->object_cache, object);
 	}
 
 	return object;
 }
 
 /**
- * ggit_repository_revparse:
+ * ggit_repository_lookup:
  * @repository: a #GgitRepository.
- * @spec: the revision specification.
+ * @oid: a #GgitOId.
+ * @gtype: a #GType.
  * @error: a #GError for error reporting, or %NULL.
  *
- * Find an object, as specified by a revision string. See `man gitrevisions`,
- * or the documentation for `git rev-parse` for information on the syntax
- * accepted.
+ * Lookups a reference to one of the objects in the @repository.
  *
- * Returns: (transfer full) (nullable): a #GgitObject or %NULL if the revision could not be found.
+ * The generated reference must be freed with g_object_unref().
  *
- **/
+ * The @gtype must match the type of the object
+ * in the odb; the method will fail otherwise.
+ * The special value %G_TYPE_NONE may be passed to let
+ * the method guess the object's type.
+ *
+ * Returns: (transfer full) (nullable): the found #GgitObject, or %NULL on error.
+ */
 GgitObject *
-ggit_repository_revparse (GgitRepository  *repository,
-                          const gchar     *spec,
-                          GError         **error)
+ggit_repository_lookup (GgitRepository  *repository,
+                        GgitOId         *oid,
+                        GType            gtype,
+                        GError         **error)
 {
-	GgitObject *object = NULL;
-	git_object *obj = NULL;
-	gint ret;
-
 	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
-	g_return_val_if_fail (spec != NULL, NULL);
 
-	ret = git_revparse_single (&obj, _ggit_native_get (repository), spec);
+	return lookup_object (repository, oid, gtype, error);
+}
 
-	if (ret == GIT_OK)
-	{
-		object = ggit_utils_create_real_object (obj, TRUE);
-	}
-	else
-	{
+/**
+ * ggit_repository_set_object_cache_enabled:
+ * @repository: a #GgitRepository.
+ * @enabled: whether to enable the object cache.
+ *
+ * Sets whether @repository keeps track of the objects returned by its
+ * lookup functions, such as ggit_repository_lookup() and
+ * ggit_repository_lookup_commit(). When enabled, looking up an object
+ * which is still alive returns the existing #GgitObject (with a new
+ * reference) instead of creating a new wrapper.
+ *
+ * The cache only holds weak references, so it never keeps objects alive.
+ * It is disabled by default.
+ */
+void
+ggit_repository_set_object_cache_enabled (GgitRepository *repository,
+                                          gboolean        enabled)
+{
+	GgitRepositoryPrivate *priv;
+	ObjectCache *cache;
+
+	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
+
+	priv = ggit_repository_get_instance_private (repository);
+	cache = priv->object_cache;
+
+	g_mutex_lock (&cache->lock);
+
+	cache->enabled = enabled ? TRUE : FALSE;
+
+	if (!cache->enabled)
+	{
+		g_hash_table_remove_all (cache->entries);
+	}
+
+	g_mutex_unlock (&cache->lock);
+}
+
+/**
+ * ggit_repository_get_object_cache_enabled:
+ * @repository: a #GgitRepository.
+ *
+ * Gets whether the object cache of @repository is enabled. See
+ * ggit_repository_set_object_cache_enabled().
+ *
+ * Returns: %TRUE if the object cache is enabled.
+ */
+gboolean
+ggit_repository_get_object_cache_enabled (GgitRepository *repository)
+{
+	GgitRepositoryPrivate *priv;
+	gboolean ret;
+
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), FALSE);
+
+	priv = ggit_repository_get_instance_private (repository);
+
+	g_mutex_lock (&priv->object_cache->lock);
+	ret = priv->object_cache->enabled;
+	g_mutex_unlock (&priv->object_cache->lock);
+
+	return ret;
+}
+
+/**
+ * ggit_repository_get_object_cache_stats:
+ * @repository: a #GgitRepository.
+ * @hits: (out) (allow-none): return location for the number of lookups
+ *        which returned an existing object, or %NULL.
+ * @misses: (out) (allow-none): return location for the number of lookups
+ *          which created a new object, or %NULL.
+ *
+ * Gets the hit and miss counters of the object cache of @repository. The
+ * counters are only updated while the cache is enabled.
+ */
+void
+ggit_repository_get_object_cache_stats (GgitRepository *repository,
+                                        guint          *hits,
+                                        guint          *misses)
+{
+	GgitRepositoryPrivate *priv;
+
+	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
+
+	priv = ggit_repository_get_instance_private (repository);
+
+	g_mutex_lock (&priv->object_cache->lock);
+
+	if (hits != NULL)
+	{
+		*hits = priv->object_cache->hits;
+	}
+
+	if (misses != NULL)
+	{
+		*misses = priv->object_cache->misses;
+	}
+
+	g_mutex_unlock (&priv->object_cache->lock);
+}
+
+/**
+ * ggit_repository_reset_object_cache_stats:
+ * @repository: a #GgitRepository.
+ *
+ * Resets the hit and miss counters of the object cache of @repository.
+ */
+void
+ggit_repository_reset_object_cache_stats (GgitRepository *repository)
+{
+	GgitRepositoryPrivate *priv;
+
+	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
+
+	priv = ggit_repository_get_instance_private (repository);
+
+	g_mutex_lock (&priv->object_cache->lock);
+	priv->object_cache->hits = 0;
+	priv->object_cache->misses = 0;
+	g_mutex_unlock (&priv->object_cache->lock);
+}
+
+static gint
+compare_oid_index (gconstpointer a,
+                   gconstpointer b,
+                   gpointer      user_data)
+{
+	GgitOId **oids = user_data;
+
+	return ggit_oid_compare (oids[*(const guint *)a], oids[*(const guint *)b]);
+}
+
+/**
+ * ggit_repository_lookup_many:
+ * @repository: a #GgitRepository.
+ * @oids: (array length=n_oids): the object ids to look up.
+ * @n_oids: the number of object ids in @oids.
+ * @gtype: the type of the objects, or %G_TYPE_NONE for any type.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Looks up many objects at once. The ids are resolved in sorted order so
+ * that the pack indices are walked sequentially. Objects are returned in
+ * the same order as @oids, ids appearing more than once resolve to the
+ * same object.
+ *
+ * The objects are owned by @repository, so they are all looked up on the
+ * calling thread.
+ *
+ * If any of the objects cannot be found, %NULL is returned and @error is
+ * set.
+ *
+ * Returns: (transfer full) (element-type GgitObject) (nullable): the
+ *          objects, or %NULL in case of an error.
+ */
+GPtrArray *
+ggit_repository_lookup_many (GgitRepository  *repository,
+                             GgitOId        **oids,
+                             guint            n_oids,
+                             GType            gtype,
+                             GError         **error)
+{
+	GgitObject **objects;
+	GPtrArray *ret;
+	guint *order;
+	guint i;
+
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
+	g_return_val_if_fail (oids != NULL || n_oids == 0, NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	order = g_new (guint, n_oids);
+	objects = g_new0 (GgitObject *, n_oids);
+
+	for (i = 0; i < n_oids; ++i)
+	{
+		order[i] = i;
+	}
+
+	g_qsort_with_data (order,
+	                   n_oids,
+	                   sizeof (guint),
+	                   compare_oid_index,
+	                   oids);
+
+	for (i = 0; i < n_oids; ++i)
+	{
+		guint idx = order[i];
+
+		/* Duplicates are adjacent once sorted */
+		if (i > 0 && ggit_oid_equal (oids[idx], oids[order[i - 1]]))
+		{
+			objects[idx] = g_object_ref (objects[order[i - 1]]);
+			continue;
+		}
+
+		objects[idx] = lookup_object (repository, oids[idx], gtype, error);
+
+		if (objects[idx] == NULL)
+		{
+			break;
+		}
+	}
+
+	g_free (order);
+
+	if (i < n_oids)
+	{
+		for (i = 0; i < n_oids; ++i)
+		{
+			g_clear_object (&objects[i]);
+		}
+
+		g_free (objects);
+
+		return NULL;
+	}
+
+	ret = g_ptr_array_new_full (n_oids, g_object_unref);
+
+	for (i = 0; i < n_oids; ++i)
+	{
+		g_ptr_array_add (ret, objects[i]);
+	}
+
+	g_free (objects);
+
+	return ret;
+}
+
+/**
+ * ggit_repository_read_object_header:
+ * @repository: a #GgitRepository.
+ * @oid: a #GgitOId.
+ * @gtype: (out) (allow-none): return location for the object type, or %NULL.
+ * @size: (out) (allow-none): return location for the object size, or %NULL.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Reads the type and size of the object identified by @oid without
+ * reading its contents. For packed objects this only requires a pack
+ * index lookup, which is much cheaper than inflating a large blob.
+ *
+ * Returns: %TRUE if the header was read, %FALSE otherwise.
+ */
+gboolean
+ggit_repository_read_object_header (GgitRepository  *repository,
+                                    GgitOId         *oid,
+                                    GType           *gtype,
+                                    gsize           *size,
+                                    GError         **error)
+{
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), FALSE);
+	g_return_val_if_fail (oid != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	return ggit_repository_read_object_headers (repository,
+	                                            &oid,
+	                                            1,
+	                                            gtype,
+	                                            size,
+	                                            error);
+}
+
+/**
+ * ggit_repository_read_object_headers:
+ * @repository: a #GgitRepository.
+ * @oids: (array length=n_oids): the object ids.
+ * @n_oids: the number of object ids in @oids.
+ * @gtypes: (array length=n_oids) (allow-none): an array of @n_oids
+ *          elements receiving the object types, or %NULL.
+ * @sizes: (array length=n_oids) (allow-none): an array of @n_oids
+ *         elements receiving the object sizes, or %NULL.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Reads the types and sizes of many objects at once, see
+ * ggit_repository_read_object_header(). The object database is only
+ * opened once and the headers are read in object id order.
+ *
+ * Returns: %TRUE if all the headers were read, %FALSE otherwise.
+ */
+gboolean
+ggit_repository_read_object_headers (GgitRepository  *repository,
+                                     GgitOId        **oids,
+                                     guint            n_oids,
+                                     GType           *gtypes,
+                                     gsize           *sizes,
+                                     GError         **error)
+{
+	git_odb *odb;
+	guint *order;
+	guint i;
+	gint ret;
+
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), FALSE);
+	g_return_val_if_fail (oids != NULL || n_oids == 0, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	ret = git_repository_odb (&odb, _ggit_native_get (repository));
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		return FALSE;
+	}
+
+	order = g_new (guint, n_oids);
+
+	for (i = 0; i < n_oids; ++i)
+	{
+		order[i] = i;
+	}
+
+	g_qsort_with_data (order,
+	                   n_oids,
+	                   sizeof (guint),
+	                   compare_oid_index,
+	                   oids);
+
+	for (i = 0; i < n_oids; ++i)
+	{
+		guint idx = order[i];
+		git_otype otype;
+		size_t len;
+
+		ret = git_odb_read_header (&len,
+		                           &otype,
+		                           odb,
+		                           _ggit_oid_get_oid (oids[idx]));
+
+		if (ret != GIT_OK)
+		{
+			break;
+		}
+
+		if (gtypes != NULL)
+		{
+			gtypes[idx] = ggit_utils_get_gtype_from_otype (otype);
+		}
+
+		if (sizes != NULL)
+		{
+			sizes[idx] = len;
+		}
+	}
+
+	g_free (order);
+	git_odb_free (odb);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * ggit_repository_revparse:
+ * @repository: a #GgitRepository.
+ * @spec: the revision specification.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Find an object, as specified by a revision string. See `man gitrevisions`,
+ * or the documentation for `git rev-parse` for information on the syntax
+ * accepted.
+ *
+ * Returns: (transfer full) (nullable): a #GgitObject or %NULL if the revision could not be found.
+ *
+ **/
+GgitObject *
+ggit_repository_revparse (GgitRepository  *repository,
+                          const gchar     *spec,
+                          GError         **error)
+{
+	GgitObject *object = NULL;
+	git_object *obj = NULL;
+	gint ret;
+
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
+	g_return_val_if_fail (spec != NULL, NULL);
+
+	ret = git_revparse_single (&obj, _ggit_native_get (repository), spec);
+
+	if (ret == GIT_OK)
+	{
+		object = ggit_utils_create_real_object (obj, TRUE);
+	}
+	else
+	{
 		_ggit_error_set (error, ret);
 	}
 
@@ -1320,39 +2148,727 @@ ggit_repository_file_status_foreach (GgitRepository     *repository,
 
 typedef struct
 {
-	GgitReferencesCallback callback;
-	gpointer user_data;
-} ReferenceForeachInfo;
+	const gchar *path;
+	guint flags;
+} StatusShardEntry;
 
-static gint
-references_foreach_wrapper (git_reference *reference,
-                            gpointer       payload)
+typedef struct
 {
-	ReferenceForeachInfo *info = (ReferenceForeachInfo *)payload;
+	const gchar *repo_path;
+	const gchar *workdir;
+	git_status_options options;
+	gboolean ignore_case;
+
+	gchar ***shards;
+	guint n_shards;
+	git_status_list **results;
+	gint next_shard;
+
+	GMutex lock;
+	GError *error;
+	gint failed;
+} StatusShardsData;
+
+static gpointer
+status_shards_thread (gpointer user_data)
+{
+	StatusShardsData *data = user_data;
+	git_repository *repo = NULL;
+	GError *error = NULL;
+	gint ret;
 
-	return info->callback(_ggit_ref_wrap (reference, TRUE), info->user_data);
-}
+	ret = ggit_utils_open_worker_repository (&repo,
+	                                         data->repo_path,
+	                                         data->workdir);
 
-/**
- * ggit_repository_references_foreach:
- * @repository: a #GgitRepository.
- * @callback: (scope call): a #GgitReferencesCallback.
- * @user_data: callback user data.
- * @error: a #GError for error reporting, or %NULL.
- *
- * Gathers references and run a callback for each one.
- *
- * To the callback is passed the reference and the data pointer
- * passed to this function. If the callback returns something other than
- * 0, the iteration will stop and @error will be set.
- *
- * Returns: %TRUE if there was no error, %FALSE otherwise
- *
- */
-gboolean
-ggit_repository_references_foreach (GgitRepository          *repository,
-                                    GgitReferencesCallback   callback,
-                                    gpointer                 user_data,
+	while (ret == GIT_OK && !g_atomic_int_get (&data->failed))
+	{
+		git_status_options options;
+		gint i;
+
+		i = g_atomic_int_add (&data->next_shard, 1);
+
+		if (i >= (gint)data->n_shards)
+		{
+			break;
+		}
+
+		options = data->options;
+		options.pathspec.strings = data->shards[i];
+		options.pathspec.count = g_strv_length (data->shards[i]);
+
+		ret = git_status_list_new (&data->results[i], repo, &options);
+	}
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (&error, ret);
+
+		g_mutex_lock (&data->lock);
+
+		if (data->error == NULL)
+		{
+			data->error = error;
+			error = NULL;
+		}
+
+		g_mutex_unlock (&data->lock);
+
+		g_clear_error (&error);
+		g_atomic_int_set (&data->failed, 1);
+	}
+
+	if (repo != NULL)
+	{
+		git_repository_free (repo);
+	}
+
+	return NULL;
+}
+
+static guint
+str_case_hash (gconstpointer key)
+{
+	const gchar *p;
+	guint h = 5381;
+
+	for (p = key; *p != '\0'; ++p)
+	{
+		h = (h << 5) + h + g_ascii_tolower (*p);
+	}
+
+	return h;
+}
+
+static gboolean
+str_case_equal (gconstpointer a,
+                gconstpointer b)
+{
+	return g_ascii_strcasecmp (a, b) == 0;
+}
+
+/* Whether the index of @repo has no changes which were not written to
+ * disk, so that the workers, which read the index from disk, see the same
+ * entries as a status computed with @repo itself.
+ */
+static gboolean
+index_is_written (git_repository *repo)
+{
+	git_index *index;
+	git_index *on_disk = NULL;
+	gboolean ret = FALSE;
+	size_t i;
+
+	if (git_repository_index (&index, repo) != GIT_OK)
+	{
+		return FALSE;
+	}
+
+	/* Pick up changes made on disk, as git_status_list_new() does */
+	if (git_index_read (index, FALSE) != GIT_OK ||
+	    git_index_path (index) == NULL ||
+	    git_index_open (&on_disk, git_index_path (index)) != GIT_OK ||
+	    git_index_set_caps (on_disk, git_index_caps (index)) != GIT_OK ||
+	    git_index_entrycount (index) != git_index_entrycount (on_disk))
+	{
+		goto out;
+	}
+
+	for (i = 0; i < git_index_entrycount (index); ++i)
+	{
+		const git_index_entry *a = git_index_get_byindex (index, i);
+		const git_index_entry *b = git_index_get_byindex (on_disk, i);
+
+		if (strcmp (a->path, b->path) != 0 ||
+		    git_oid_cmp (&a->id, &b->id) != 0 ||
+		    a->mode != b->mode ||
+		    a->flags != b->flags ||
+		    a->file_size != b->file_size ||
+		    a->mtime.seconds != b->mtime.seconds ||
+		    a->mtime.nanoseconds != b->mtime.nanoseconds)
+		{
+			goto out;
+		}
+	}
+
+	ret = TRUE;
+
+out:
+	if (on_disk != NULL)
+	{
+		git_index_free (on_disk);
+	}
+
+	git_index_free (index);
+
+	return ret;
+}
+
+static void
+add_top_level_name (GHashTable  *names,
+                    const gchar *path,
+                    gboolean     is_dir)
+{
+	const gchar *sep;
+	gchar *name;
+
+	sep = strchr (path, '/');
+
+	if (sep != NULL)
+	{
+		name = g_strndup (path, sep - path);
+		is_dir = TRUE;
+	}
+	else
+	{
+		name = g_strdup (path);
+	}
+
+	/* A name is a directory shard if it is a directory anywhere */
+	if (is_dir || !g_hash_table_contains (names, name))
+	{
+		g_hash_table_replace (names, name, GINT_TO_POINTER (is_dir));
+	}
+	else
+	{
+		g_free (name);
+	}
+}
+
+/* Split the working directory into one shard per top-level directory and
+ * one shard for all the top-level files. The names are collected from the
+ * working directory, the index and HEAD so that deleted files are covered.
+ * When @ignore_case is set, names differing only in case are the same
+ * shard, since the literal pathspec then matches them all.
+ */
+static GPtrArray *
+collect_status_shards (git_repository *repo,
+                       gboolean        ignore_case)
+{
+	GHashTable *names;
+	GHashTableIter iter;
+	GPtrArray *shards;
+	GPtrArray *files;
+	git_index *index;
+	git_object *head_tree;
+	gpointer key;
+	gpointer value;
+	GDir *dir;
+
+	names = g_hash_table_new_full (ignore_case ? str_case_hash : g_str_hash,
+	                               ignore_case ? str_case_equal : g_str_equal,
+	                               g_free,
+	                               NULL);
+
+	dir = g_dir_open (git_repository_workdir (repo), 0, NULL);
+
+	if (dir != NULL)
+	{
+		const gchar *name;
+
+		while ((name = g_dir_read_name (dir)) != NULL)
+		{
+			gchar *path;
+
+			if (strcmp (name, ".git") == 0)
+			{
+				continue;
+			}
+
+			path = g_build_filename (git_repository_workdir (repo), name, NULL);
+			add_top_level_name (names,
+			                    name,
+			                    g_file_test (path, G_FILE_TEST_IS_DIR) &&
+			                    !g_file_test (path, G_FILE_TEST_IS_SYMLINK));
+			g_free (path);
+		}
+
+		g_dir_close (dir);
+	}
+
+	if (git_repository_index (&index, repo) == GIT_OK)
+	{
+		size_t i;
+
+		for (i = 0; i < git_index_entrycount (index); ++i)
+		{
+			add_top_level_name (names, git_index_get_byindex (index, i)->path, FALSE);
+		}
+
+		git_index_free (index);
+	}
+
+	if (git_revparse_single (&head_tree, repo, "HEAD^{tree}") == GIT_OK)
+	{
+		git_tree *tree = (git_tree *)head_tree;
+		size_t i;
+
+		for (i = 0; i < git_tree_entrycount (tree); ++i)
+		{
+			const git_tree_entry *entry;
+
+			entry = git_tree_entry_byindex (tree, i);
+			add_top_level_name (names,
+			                    git_tree_entry_name (entry),
+			                    git_tree_entry_type (entry) == GIT_OBJ_TREE);
+		}
+
+		git_object_free (head_tree);
+	}
+
+	shards = g_ptr_array_new_with_free_func ((GDestroyNotify)g_strfreev);
+	files = g_ptr_array_new ();
+
+	g_hash_table_iter_init (&iter, names);
+
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		if (GPOINTER_TO_INT (value))
+		{
+			gchar **shard;
+
+			shard = g_new (gchar *, 2);
+			shard[0] = g_strdup (key);
+			shard[1] = NULL;
+
+			g_ptr_array_add (shards, shard);
+		}
+		else
+		{
+			g_ptr_array_add (files, g_strdup (key));
+		}
+	}
+
+	if (files->len > 0)
+	{
+		g_ptr_array_add (files, NULL);
+		g_ptr_array_add (shards, g_ptr_array_free (files, FALSE));
+	}
+	else
+	{
+		g_ptr_array_free (files, TRUE);
+	}
+
+	g_hash_table_unref (names);
+
+	return shards;
+}
+
+static gint
+compare_status_shard_entries (gconstpointer a,
+                              gconstpointer b,
+                              gpointer      user_data)
+{
+	const StatusShardEntry *ea = a;
+	const StatusShardEntry *eb = b;
+
+	if (GPOINTER_TO_INT (user_data))
+	{
+		return g_ascii_strcasecmp (ea->path, eb->path);
+	}
+
+	return strcmp (ea->path, eb->path);
+}
+
+/**
+ * ggit_repository_file_status_foreach_parallel:
+ * @repository: a #GgitRepository.
+ * @options: (allow-none): status options, or %NULL.
+ * @n_workers: the number of threads to use, or 0 to use the number of
+ *             processors.
+ * @callback: (scope call): a #GgitStatusCallback.
+ * @user_data: callback user data.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Like ggit_repository_file_status_foreach(), but the working directory is
+ * split by top-level directory and the parts are scanned in parallel on
+ * @n_workers threads, each using its own repository handle. @callback is
+ * called from the calling thread, in path order, once all the parts have
+ * been scanned.
+ *
+ * The workers read the index from disk. If the index of @repository has
+ * changes which were not written yet, or if @options has a pathspec,
+ * enables rename detection or updates the index, none of which can be
+ * split, the status is computed on the calling thread instead.
+ *
+ * Returns: %TRUE if there was no error, %FALSE otherwise
+ *
+ */
+gboolean
+ggit_repository_file_status_foreach_parallel (GgitRepository     *repository,
+                                              GgitStatusOptions  *options,
+                                              guint               n_workers,
+                                              GgitStatusCallback  callback,
+                                              gpointer            user_data,
+                                              GError            **error)
+{
+	git_repository *repo;
+	const git_status_options *native_options;
+	StatusShardsData data = { 0, };
+	GPtrArray *shards;
+	GArray *entries;
+	GThread **threads;
+	gboolean ret = TRUE;
+	guint i;
+
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), FALSE);
+	g_return_val_if_fail (callback != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	repo = _ggit_native_get (repository);
+	native_options = _ggit_status_options_get_status_options (options);
+
+	if (native_options != NULL)
+	{
+		data.options = *native_options;
+	}
+	else
+	{
+		git_status_options defaults = GIT_STATUS_OPTIONS_INIT;
+
+		data.options = defaults;
+		data.options.flags = GIT_STATUS_OPT_DEFAULTS;
+	}
+
+	if (n_workers == 0)
+	{
+		n_workers = g_get_num_processors ();
+	}
+
+	if (n_workers <= 1 ||
+	    git_repository_is_bare (repo) ||
+	    data.options.pathspec.count > 0 ||
+	    (data.options.flags & (GIT_STATUS_OPT_RENAMES_HEAD_TO_INDEX |
+	                           GIT_STATUS_OPT_RENAMES_INDEX_TO_WORKDIR |
+	                           GIT_STATUS_OPT_RENAMES_FROM_REWRITES |
+	                           GIT_STATUS_OPT_UPDATE_INDEX)) != 0 ||
+	    !index_is_written (repo))
+	{
+		return ggit_repository_file_status_foreach (repository,
+		                                            options,
+		                                            callback,
+		                                            user_data,
+		                                            error);
+	}
+
+	if (data.options.flags & GIT_STATUS_OPT_SORT_CASE_INSENSITIVELY)
+	{
+		data.ignore_case = TRUE;
+	}
+	else if (!(data.options.flags & GIT_STATUS_OPT_SORT_CASE_SENSITIVELY))
+	{
+		git_index *index;
+
+		if (git_repository_index (&index, repo) == GIT_OK)
+		{
+			data.ignore_case = (git_index_caps (index) & GIT_INDEXCAP_IGNORE_CASE) != 0;
+			git_index_free (index);
+		}
+	}
+
+	/* Shards are literal paths */
+	data.options.flags |= GIT_STATUS_OPT_DISABLE_PATHSPEC_MATCH;
+
+	shards = collect_status_shards (repo, data.ignore_case);
+
+	data.repo_path = git_repository_path (repo);
+	data.workdir = git_repository_workdir (repo);
+	data.shards = (gchar ***)shards->pdata;
+	data.n_shards = shards->len;
+	data.results = g_new0 (git_status_list *, shards->len);
+	g_mutex_init (&data.lock);
+
+	n_workers = MAX (MIN (n_workers, shards->len), 1);
+	threads = g_new (GThread *, n_workers);
+
+	for (i = 0; i < n_workers; ++i)
+	{
+		threads[i] = g_thread_new ("ggit-status", status_shards_thread, &data);
+	}
+
+	for (i = 0; i < n_workers; ++i)
+	{
+		g_thread_join (threads[i]);
+	}
+
+	g_free (threads);
+	g_mutex_clear (&data.lock);
+
+	entries = g_array_new (FALSE, FALSE, sizeof (StatusShardEntry));
+
+	if (data.error != NULL)
+	{
+		g_propagate_error (error, data.error);
+		ret = FALSE;
+	}
+	else
+	{
+		/* Each shard is sorted, but the top-level files interleave with
+		 * the directories, so sort the merged entries again.
+		 */
+		for (i = 0; i < data.n_shards; ++i)
+		{
+			size_t j;
+
+			for (j = 0; j < git_status_list_entrycount (data.results[i]); ++j)
+			{
+				const git_status_entry *entry;
+				StatusShardEntry e;
+
+				entry = git_status_byindex (data.results[i], j);
+
+				e.path = entry->head_to_index != NULL ?
+				         entry->head_to_index->old_file.path :
+				         entry->index_to_workdir->old_file.path;
+				e.flags = entry->status;
+
+				g_array_append_val (entries, e);
+			}
+		}
+
+		g_qsort_with_data (entries->data,
+		                   entries->len,
+		                   sizeof (StatusShardEntry),
+		                   compare_status_shard_entries,
+		                   GINT_TO_POINTER (data.ignore_case));
+
+		for (i = 0; i < entries->len; ++i)
+		{
+			StatusShardEntry *e;
+			gint cret;
+
+			e = &g_array_index (entries, StatusShardEntry, i);
+			cret = callback (e->path, e->flags, user_data);
+
+			if (cret != 0)
+			{
+				g_set_error (error,
+				             GGIT_ERROR,
+				             cret < 0 ? cret : GIT_EUSER,
+				             "The status callback returned %d",
+				             cret);
+				ret = FALSE;
+				break;
+			}
+		}
+	}
+
+	g_array_unref (entries);
+
+	for (i = 0; i < data.n_shards; ++i)
+	{
+		if (data.results[i] != NULL)
+		{
+			git_status_list_free (data.results[i]);
+		}
+	}
+
+	g_free (data.results);
+	g_ptr_array_unref (shards);
+
+	return ret;
+}
+
+static gint
+is_dirty_notify (const git_diff       *diff_so_far,
+                 const git_diff_delta *delta_to_add,
+                 const char           *matched_pathspec,
+                 void                 *payload)
+{
+	gboolean *dirty = payload;
+
+	*dirty = TRUE;
+
+	/* The first difference is enough */
+	return GIT_EUSER;
+}
+
+/**
+ * ggit_repository_is_dirty:
+ * @repository: a #GgitRepository.
+ * @flags: a #GgitDirtyFlags.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Check whether the index or the working directory of @repository contain
+ * any changes. Unlike ggit_repository_file_status_foreach(), this stops
+ * at the first change found. HEAD is first compared to the index, which
+ * does not access the working directory, and then the index is compared to
+ * the working directory.
+ *
+ * Returns: %TRUE if there are changes, %FALSE if there are no changes or
+ *          if there was an error.
+ *
+ */
+gboolean
+ggit_repository_is_dirty (GgitRepository  *repository,
+                          GgitDirtyFlags   flags,
+                          GError         **error)
+{
+	git_repository *repo;
+	git_diff_options options = GIT_DIFF_OPTIONS_INIT;
+	git_object *head_tree = NULL;
+	git_index *index = NULL;
+	git_diff *diff = NULL;
+	gboolean dirty = FALSE;
+	gint ret;
+
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	repo = _ggit_native_get (repository);
+
+	ret = git_revparse_single (&head_tree, repo, "HEAD^{tree}");
+
+	/* An unborn branch is compared to the empty tree */
+	if (ret == GIT_ENOTFOUND || ret == GIT_EUNBORNBRANCH)
+	{
+		head_tree = NULL;
+		ret = GIT_OK;
+	}
+
+	if (ret == GIT_OK)
+	{
+		ret = git_repository_index (&index, repo);
+	}
+
+	/* The repository keeps its index loaded, pick up outside writes */
+	if (ret == GIT_OK)
+	{
+		ret = git_index_read (index, FALSE);
+	}
+
+	options.notify_cb = is_dirty_notify;
+	options.payload = &dirty;
+
+	if (flags & GGIT_DIRTY_IGNORE_SUBMODULES)
+	{
+		options.ignore_submodules = GIT_SUBMODULE_IGNORE_ALL;
+	}
+
+	if (ret == GIT_OK)
+	{
+		ret = git_diff_tree_to_index (&diff,
+		                              repo,
+		                              (git_tree *)head_tree,
+		                              index,
+		                              &options);
+
+		git_diff_free (diff);
+		diff = NULL;
+	}
+
+	if (ret == GIT_OK && !dirty && !git_repository_is_bare (repo))
+	{
+		/* A single untracked directory is enough, no need to recurse */
+		if (!(flags & GGIT_DIRTY_IGNORE_UNTRACKED))
+		{
+			options.flags |= GIT_DIFF_INCLUDE_UNTRACKED;
+		}
+
+		ret = git_diff_index_to_workdir (&diff, repo, index, &options);
+
+		git_diff_free (diff);
+	}
+
+	if (head_tree != NULL)
+	{
+		git_object_free (head_tree);
+	}
+
+	if (index != NULL)
+	{
+		git_index_free (index);
+	}
+
+	if (dirty)
+	{
+		return TRUE;
+	}
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+	}
+
+	return FALSE;
+}
+
+/**
+ * ggit_repository_get_status_list:
+ * @repository: a #GgitRepository.
+ * @options: (allow-none): status options, or %NULL.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Gathers the status of all the files in @repository into a list which can
+ * be accessed by index, see #GgitStatusList. Unlike
+ * ggit_repository_file_status_foreach(), this also gives access to the
+ * differences in the index and the working directory, including renames.
+ *
+ * Set @options to %NULL to get the default status options.
+ *
+ * Returns: (transfer full) (nullable): a #GgitStatusList or %NULL in case
+ *          of an error.
+ *
+ */
+GgitStatusList *
+ggit_repository_get_status_list (GgitRepository     *repository,
+                                 GgitStatusOptions  *options,
+                                 GError            **error)
+{
+	git_status_list *status_list;
+	gint ret;
+
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	ret = git_status_list_new (&status_list,
+	                           _ggit_native_get (repository),
+	                           _ggit_status_options_get_status_options (options));
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		return NULL;
+	}
+
+	return _ggit_status_list_wrap (status_list);
+}
+
+typedef struct
+{
+	GgitReferencesCallback callback;
+	gpointer user_data;
+} ReferenceForeachInfo;
+
+static gint
+references_foreach_wrapper (git_reference *reference,
+                            gpointer       payload)
+{
+	ReferenceForeachInfo *info = (ReferenceForeachInfo *)payload;
+
+	return info->callback(_ggit_ref_wrap (reference, TRUE), info->user_data);
+}
+
+/**
+ * ggit_repository_references_foreach:
+ * @repository: a #GgitRepository.
+ * @callback: (scope call): a #GgitReferencesCallback.
+ * @user_data: callback user data.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Gathers references and run a callback for each one.
+ *
+ * To the callback is passed the reference and the data pointer
+ * passed to this function. If the callback returns something other than
+ * 0, the iteration will stop and @error will be set.
+ *
+ * Returns: %TRUE if there was no error, %FALSE otherwise
+ *
+ */
+gboolean
+ggit_repository_references_foreach (GgitRepository          *repository,
+                                    GgitReferencesCallback   callback,
+                                    gpointer                 user_data,
                                     GError                 **error)
 {
 	gint ret;
@@ -1988,25 +3504,10 @@ ggit_repository_lookup_blob (GgitRepository *repository,
                              GgitOId        *oid,
                              GError         **error)
 {
-	gint ret;
-	git_blob *blob;
-	const git_oid *id;
-
 	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	id = (const git_oid *)_ggit_oid_get_oid (oid);
-	ret = git_blob_lookup (&blob,
-	                       _ggit_native_get (repository),
-	                       id);
-
-	if (ret != GIT_OK)
-	{
-		_ggit_error_set (error, ret);
-		return NULL;
-	}
-
-	return _ggit_blob_wrap (blob, TRUE);
+	return GGIT_BLOB (lookup_object (repository, oid, GGIT_TYPE_BLOB, error));
 }
 
 /**
@@ -2024,25 +3525,10 @@ ggit_repository_lookup_commit (GgitRepository *repository,
                                GgitOId        *oid,
                                GError         **error)
 {
-	gint ret;
-	git_commit *commit;
-	const git_oid *id;
-
 	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	id = (const git_oid *)_ggit_oid_get_oid (oid);
-	ret = git_commit_lookup (&commit,
-	                         _ggit_native_get (repository),
-	                         id);
-
-	if (ret != GIT_OK)
-	{
-		_ggit_error_set (error, ret);
-		return NULL;
-	}
-
-	return _ggit_commit_wrap (commit, TRUE);
+	return GGIT_COMMIT (lookup_object (repository, oid, GGIT_TYPE_COMMIT, error));
 }
 
 /**
@@ -2060,25 +3546,10 @@ ggit_repository_lookup_tag (GgitRepository *repository,
                             GgitOId        *oid,
                             GError         **error)
 {
-	gint ret;
-	git_tag *tag;
-	const git_oid *id;
-
 	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	id = (const git_oid *)_ggit_oid_get_oid (oid);
-	ret = git_tag_lookup (&tag,
-	                      _ggit_native_get (repository),
-	                      id);
-
-	if (ret != GIT_OK)
-	{
-		_ggit_error_set (error, ret);
-		return NULL;
-	}
-
-	return _ggit_tag_wrap (tag, TRUE);
+	return GGIT_TAG (lookup_object (repository, oid, GGIT_TYPE_TAG, error));
 }
 
 /**
@@ -2096,25 +3567,10 @@ ggit_repository_lookup_tree (GgitRepository *repository,
                              GgitOId        *oid,
                              GError         **error)
 {
-	gint ret;
-	git_tree *tree;
-	const git_oid *id;
-
 	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	id = (const git_oid *)_ggit_oid_get_oid (oid);
-	ret = git_tree_lookup (&tree,
-	                       _ggit_native_get (repository),
-	                       id);
-
-	if (ret != GIT_OK)
-	{
-		_ggit_error_set (error, ret);
-		return NULL;
-	}
-
-	return _ggit_tree_wrap (tree, TRUE);
+	return GGIT_TREE (lookup_object (repository, oid, GGIT_TYPE_TREE, error));
 }
 
 /**
@@ -2500,44 +3956,220 @@ ggit_repository_submodule_foreach (GgitRepository        *repository,
 	wrapper_data.user_data = user_data;
 	wrapper_data.callback = callback;
 
-	ret = git_submodule_foreach (_ggit_native_get (repository),
-	                             submodule_wrapper_callback,
-	                             &wrapper_data);
+	ret = git_submodule_foreach (_ggit_native_get (repository),
+	                             submodule_wrapper_callback,
+	                             &wrapper_data);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * ggit_repository_set_submodule_ignore:
+ * @repository: a #GgitRepository.
+ * @name: the name of the submodule.
+ * @ignore: a #GgitSubmoduleIgnore.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Sets the ignore rule for the submodule in the configuration.
+ * This does not affect any currently-loaded instances..
+ */
+void
+ggit_repository_set_submodule_ignore (GgitRepository       *repository,
+                                      const gchar          *name,
+                                      GgitSubmoduleIgnore   ignore,
+                                      GError              **error)
+{
+	gint ret;
+
+	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
+	g_return_if_fail (name != NULL);
+	g_return_if_fail (error == NULL || *error == NULL);
+
+	ret = git_submodule_set_ignore (_ggit_native_get (repository),
+	                                name,
+	                                (git_submodule_ignore_t)ignore);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+	}
+}
+
+/**
+ * ggit_repository_set_submodule_update:
+ * @repository: a #GgitRepository.
+ * @name: the name of the submodule.
+ * @update: a #GgitSubmoduleUpdate.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Sets the update rule for the submodule in the configuration.
+ * This setting won't affect any existing instances.
+ */
+void
+ggit_repository_set_submodule_update (GgitRepository       *repository,
+                                      const gchar          *name,
+                                      GgitSubmoduleUpdate   update,
+                                      GError              **error)
+{
+	gint ret;
+
+	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
+	g_return_if_fail (name != NULL);
+	g_return_if_fail (error == NULL || *error == NULL);
+
+	ret = git_submodule_set_update (_ggit_native_get (repository),
+	                                name,
+	                                (git_submodule_update_t)update);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+	}
+}
+
+/**
+ * ggit_repository_set_submodule_url:
+ * @repository: a #GgitRepository.
+ * @name: the name of the submodule to configure.
+ * @url: URL that should be used for the submodule.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Sets the URL for the submodule in the configuration.
+ *
+ * After calling this, you may wish to call ggit_submodule_sync() to
+ * write the changes to the checked out submodule repository.
+ */
+void
+ggit_repository_set_submodule_url (GgitRepository  *repository,
+                                   const gchar     *name,
+                                   const gchar     *url,
+                                   GError         **error)
+{
+	gint ret;
+
+	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
+	g_return_if_fail (name != NULL);
+	g_return_if_fail (url != NULL);
+	g_return_if_fail (error == NULL || *error == NULL);
+
+	ret = git_submodule_set_url (_ggit_native_get (repository),
+	                             name,
+	                             url);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+	}
+}
+
+/**
+ * ggit_repository_set_submodule_fetch_recurse:
+ * @repository: a #GgitRepository.
+ * @name: the name of the submodule.
+ * @fetch_recurse_submodules: a #GgitSubmoduleRecurse.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Sets the submodule.'name'.fetchRecurseSubmodules value for
+ * the submodule. This setting won't affect any existing instances..
+ */
+void
+ggit_repository_set_submodule_fetch_recurse (GgitRepository        *repository,
+                                             const gchar           *name,
+                                             GgitSubmoduleRecurse   fetch_recurse_submodules,
+                                             GError               **error)
+{
+	gint ret;
+
+	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
+	g_return_if_fail (name != NULL);
+	g_return_if_fail (error == NULL || *error == NULL);
+
+	ret = git_submodule_set_fetch_recurse_submodules (_ggit_native_get (repository),
+	                                                  name,
+	                                                  (git_submodule_recurse_t)fetch_recurse_submodules);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+	}
+}
+
+/**
+ * ggit_repository_get_submodule_status:
+ * @repository: a #GgitRepository.
+ * @name: the name of the submodule.
+ * @ignore: the ignore rules to follow.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Gets the status for a submodule.
+ * This looks at a submodule and tries to determine the status.  It
+ * will return a combination of the %GGIT_SUBMODULE_STATUS values.
+ * How deeply it examines the working directory to do this will depend
+ * on @ignore.
+ *
+ * Returns: the #GgitSubmoduleStatus for @submodule.
+ */
+GgitSubmoduleStatus
+ggit_repository_get_submodule_status (GgitRepository      *repository,
+                                      const gchar         *name,
+                                      GgitSubmoduleIgnore  ignore,
+                                      GError             **error)
+{
+	gint ret;
+	GgitSubmoduleStatus status;
+
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), 0);
+	g_return_val_if_fail (name != NULL, 0);
+	g_return_val_if_fail (error == NULL || *error == NULL, 0);
+
+	ret = git_submodule_status (&status,
+	                            _ggit_native_get (repository),
+	                            name,
+	                            (git_submodule_ignore_t)ignore);
 
 	if (ret != GIT_OK)
 	{
 		_ggit_error_set (error, ret);
-		return FALSE;
 	}
 
-	return TRUE;
+	return status;
 }
 
 /**
- * ggit_repository_set_submodule_ignore:
+ * ggit_repository_reset:
  * @repository: a #GgitRepository.
- * @name: the name of the submodule.
- * @ignore: a #GgitSubmoduleIgnore.
+ * @target: the target #GgitObject which is a commit or a tag.
+ * @reset_type: the #GgitResetType to perform.
+ * @checkout_options: the #GgitCheckoutOptions to be used for a HARD reset.
  * @error: a #GError for error reporting, or %NULL.
  *
- * Sets the ignore rule for the submodule in the configuration.
- * This does not affect any currently-loaded instances..
+ * Performs a reset of type @reset_type on @repository to @target,
+ * or @error will be set.
  */
 void
-ggit_repository_set_submodule_ignore (GgitRepository       *repository,
-                                      const gchar          *name,
-                                      GgitSubmoduleIgnore   ignore,
-                                      GError              **error)
+ggit_repository_reset (GgitRepository       *repository,
+                       GgitObject           *target,
+                       GgitResetType         reset_type,
+                       GgitCheckoutOptions  *checkout_options,
+                       GError              **error)
 {
 	gint ret;
 
 	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
-	g_return_if_fail (name != NULL);
+	g_return_if_fail (GGIT_IS_OBJECT (target));
+	g_return_if_fail (GGIT_IS_CHECKOUT_OPTIONS (checkout_options));
 	g_return_if_fail (error == NULL || *error == NULL);
 
-	ret = git_submodule_set_ignore (_ggit_native_get (repository),
-	                                name,
-	                                (git_submodule_ignore_t)ignore);
+	ret = git_reset (_ggit_native_get (repository),
+	                 _ggit_native_get (target),
+	                 (git_reset_t)reset_type,
+	                 (git_checkout_options *)_ggit_checkout_options_get_checkout_options (checkout_options));
 
 	if (ret != GIT_OK)
 	{
@@ -2546,30 +4178,39 @@ ggit_repository_set_submodule_ignore (GgitRepository       *repository,
 }
 
 /**
- * ggit_repository_set_submodule_update:
+ * ggit_repository_reset_default:
  * @repository: a #GgitRepository.
- * @name: the name of the submodule.
- * @update: a #GgitSubmoduleUpdate.
- * @error: a #GError for error reporting, or %NULL.
+ * @target: (allow-none): the target #GgitObject which is a commit or a tag.
+ * @pathspecs: (array zero-terminated=1): a list of file paths to reset.
+ * @error: a #GError for error reporting or %NULL.
  *
- * Sets the update rule for the submodule in the configuration.
- * This setting won't affect any existing instances.
- */
+ * Update some entries in the index from the target commit tree. The scope of
+ * the updated entries is determined by the paths specified in @pathspecs.
+ * Passing %NULL in @target will result in removing entries in the index
+ * matching the provided pathspecs.
+ *
+ **/
 void
-ggit_repository_set_submodule_update (GgitRepository       *repository,
-                                      const gchar          *name,
-                                      GgitSubmoduleUpdate   update,
-                                      GError              **error)
+ggit_repository_reset_default (GgitRepository       *repository,
+                               GgitObject           *target,
+                               const gchar * const  *pathspecs,
+                               GError              **error)
 {
 	gint ret;
+	git_strarray pp;
 
 	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
-	g_return_if_fail (name != NULL);
+	g_return_if_fail (target == NULL || GGIT_IS_OBJECT (target));
+	g_return_if_fail (pathspecs != NULL && *pathspecs != NULL);
 	g_return_if_fail (error == NULL || *error == NULL);
 
-	ret = git_submodule_set_update (_ggit_native_get (repository),
-	                                name,
-	                                (git_submodule_update_t)update);
+	ggit_utils_get_git_strarray_from_str_array (pathspecs, &pp);
+
+	ret = git_reset_default (_ggit_native_get (repository),
+	                         _ggit_native_get (target),
+	                         &pp);
+
+	git_strarray_free (&pp);
 
 	if (ret != GIT_OK)
 	{
@@ -2578,65 +4219,69 @@ ggit_repository_set_submodule_update (GgitRepository       *repository,
 }
 
 /**
- * ggit_repository_set_submodule_url:
+ * ggit_repository_save_stash:
  * @repository: a #GgitRepository.
- * @name: the name of the submodule to configure.
- * @url: URL that should be used for the submodule.
- * @error: a #GError for error reporting, or %NULL.
+ * @stasher: a #GgitSignature.
+ * @message: description along with the stashed state or %NULL to be autogenerated.
+ * @flags: a #GgitStashFlags to control the stashing process.
+ * @error: a #GError for error reporting, #GGIT_ENOTFOUND if there's nothing to stash or %NULL.
  *
- * Sets the URL for the submodule in the configuration.
+ * Saves the local modifications to a new stash.
+ * It returns the commit containing the stashed state.
+ * This commit is also the target of the direct reference refs/stash.
  *
- * After calling this, you may wish to call ggit_submodule_sync() to
- * write the changes to the checked out submodule repository.
+ * Returns: (transfer full) (nullable): a new object id of the commit containing the stashed state.
  */
-void
-ggit_repository_set_submodule_url (GgitRepository  *repository,
-                                   const gchar     *name,
-                                   const gchar     *url,
-                                   GError         **error)
+GgitOId *
+ggit_repository_save_stash (GgitRepository  *repository,
+                            GgitSignature   *stasher,
+                            const gchar     *message,
+                            GgitStashFlags   flags,
+                            GError         **error)
 {
 	gint ret;
+	git_oid oid;
 
-	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
-	g_return_if_fail (name != NULL);
-	g_return_if_fail (url != NULL);
-	g_return_if_fail (error == NULL || *error == NULL);
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
+	g_return_val_if_fail (GGIT_IS_SIGNATURE (stasher), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	ret = git_submodule_set_url (_ggit_native_get (repository),
-	                             name,
-	                             url);
+	ret = git_stash_save (&oid,
+	                      _ggit_native_get (repository),
+	                      _ggit_native_get (stasher),
+	                      message,
+	                      flags);
 
 	if (ret != GIT_OK)
 	{
 		_ggit_error_set (error, ret);
+		return NULL;
 	}
+
+	return _ggit_oid_wrap (&oid);
 }
 
 /**
- * ggit_repository_set_submodule_fetch_recurse:
+ * ggit_repository_drop_stash:
  * @repository: a #GgitRepository.
- * @name: the name of the submodule.
- * @fetch_recurse_submodules: a #GgitSubmoduleRecurse.
+ * @index: the position within the stash list. 0 points to the.
+ * most recent stashed state.
  * @error: a #GError for error reporting, or %NULL.
  *
- * Sets the submodule.'name'.fetchRecurseSubmodules value for
- * the submodule. This setting won't affect any existing instances..
+ * Removes a single stashed state from the stash list.
  */
 void
-ggit_repository_set_submodule_fetch_recurse (GgitRepository        *repository,
-                                             const gchar           *name,
-                                             GgitSubmoduleRecurse   fetch_recurse_submodules,
-                                             GError               **error)
+ggit_repository_drop_stash (GgitRepository  *repository,
+                            gsize            index,
+                            GError         **error)
 {
 	gint ret;
 
 	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
-	g_return_if_fail (name != NULL);
 	g_return_if_fail (error == NULL || *error == NULL);
 
-	ret = git_submodule_set_fetch_recurse_submodules (_ggit_native_get (repository),
-	                                                  name,
-	                                                  (git_submodule_recurse_t)fetch_recurse_submodules);
+	ret = git_stash_drop (_ggit_native_get (repository),
+	                      index);
 
 	if (ret != GIT_OK)
 	{
@@ -2644,157 +4289,247 @@ ggit_repository_set_submodule_fetch_recurse (GgitRepository        *repository,
 	}
 }
 
+typedef struct
+{
+	gpointer user_data;
+
+	GgitStashCallback callback;
+} StashCallbackWrapperData;
+
+static gint
+stash_callback_wrapper (gsize          index,
+                        const gchar   *message,
+                        const git_oid *stash_oid,
+                        gpointer       user_data)
+{
+	StashCallbackWrapperData *wrapper_data = (StashCallbackWrapperData *)user_data;
+	GgitOId *oid;
+	gint ret;
+
+	oid = _ggit_oid_wrap (stash_oid);
+
+	ret = wrapper_data->callback (index, message, oid, wrapper_data->user_data);
+	ggit_oid_free (oid);
+
+	return ret;
+}
+
 /**
- * ggit_repository_get_submodule_status:
+ * ggit_repository_stash_foreach:
  * @repository: a #GgitRepository.
- * @name: the name of the submodule.
- * @ignore: the ignore rules to follow.
+ * @callback: (scope call): a #GgitStashCallback.
+ * @user_data: callback user data.
  * @error: a #GError for error reporting, or %NULL.
  *
- * Gets the status for a submodule.
- * This looks at a submodule and tries to determine the status.  It
- * will return a combination of the %GGIT_SUBMODULE_STATUS values.
- * How deeply it examines the working directory to do this will depend
- * on @ignore.
+ * Loops over all the stashed states and issue a callback for each one.
+ * If @callback returns a non-zero value, this will stop looping.
  *
- * Returns: the #GgitSubmoduleStatus for @submodule.
+ * Returns: %TRUE if there was no error, %FALSE otherwise.
  */
-GgitSubmoduleStatus
-ggit_repository_get_submodule_status (GgitRepository      *repository,
-                                      const gchar         *name,
-                                      GgitSubmoduleIgnore  ignore,
-                                      GError             **error)
+gboolean
+ggit_repository_stash_foreach (GgitRepository     *repository,
+                               GgitStashCallback   callback,
+                               gpointer            user_data,
+                               GError            **error)
 {
+	StashCallbackWrapperData wrapper_data;
 	gint ret;
-	GgitSubmoduleStatus status;
 
-	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), 0);
-	g_return_val_if_fail (name != NULL, 0);
-	g_return_val_if_fail (error == NULL || *error == NULL, 0);
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), FALSE);
+	g_return_val_if_fail (callback != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	wrapper_data.user_data = user_data;
+	wrapper_data.callback = callback;
+
+	ret = git_stash_foreach (_ggit_native_get (repository),
+	                         stash_callback_wrapper,
+	                         &wrapper_data);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * ggit_repository_get_ahead_behind:
+ * @repository: a #GgitRepository.
+ * @local: the commit for local.
+ * @upstream: the commit for upstream.
+ * @ahead: (out): number of unique from commits in @upstream.
+ * @behind: (out): number of unique from commits in @local.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Count the number of unique commits between two commit objects.
+ *
+ * There is no need for branches containing the commits to have any
+ * upstream relationship, but it helps to think of one as a branch and
+ * the other as its upstream, the @ahead and @behind values will be
+ * what git would report for the branches.
+ */
+void
+ggit_repository_get_ahead_behind (GgitRepository  *repository,
+                                  GgitOId         *local,
+                                  GgitOId         *upstream,
+                                  gsize           *ahead,
+                                  gsize           *behind,
+                                  GError         **error)
+{
+	gint ret;
+
+	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
+	g_return_if_fail (local != NULL);
+	g_return_if_fail (upstream != NULL);
+	g_return_if_fail (ahead != NULL);
+	g_return_if_fail (behind != NULL);
+	g_return_if_fail (error == NULL || *error == NULL);
 
-	ret = git_submodule_status (&status,
-	                            _ggit_native_get (repository),
-	                            name,
-	                            (git_submodule_ignore_t)ignore);
+	ret = git_graph_ahead_behind (ahead, behind,
+	                              _ggit_native_get (repository),
+	                              _ggit_oid_get_oid (local),
+	                              _ggit_oid_get_oid (upstream));
 
 	if (ret != GIT_OK)
 	{
 		_ggit_error_set (error, ret);
 	}
-
-	return status;
 }
 
 /**
- * ggit_repository_reset:
+ * ggit_repository_get_descendant_of:
  * @repository: a #GgitRepository.
- * @target: the target #GgitObject which is a commit or a tag.
- * @reset_type: the #GgitResetType to perform.
- * @checkout_options: the #GgitCheckoutOptions to be used for a HARD reset.
+ * @commit: the commit.
+ * @ancestor: the ancestor.
  * @error: a #GError for error reporting, or %NULL.
  *
- * Performs a reset of type @reset_type on @repository to @target,
- * or @error will be set.
+ * Check whether @com mit is a descendant of @ancestor. Note that if this
+ * function returns %FALSE, an error might have occurred. If so, @error will
+ * be set appropriately.
+ *
+ * Returns: %TRUE if @commit is a descendant of @ancestor, or %FALSE otherwise.
+ *
  */
-void
-ggit_repository_reset (GgitRepository       *repository,
-                       GgitObject           *target,
-                       GgitResetType         reset_type,
-                       GgitCheckoutOptions  *checkout_options,
-                       GError              **error)
+gboolean
+ggit_repository_get_descendant_of (GgitRepository  *repository,
+                                   GgitOId         *commit,
+                                   GgitOId         *ancestor,
+                                   GError         **error)
 {
 	gint ret;
 
-	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
-	g_return_if_fail (GGIT_IS_OBJECT (target));
-	g_return_if_fail (GGIT_IS_CHECKOUT_OPTIONS (checkout_options));
-	g_return_if_fail (error == NULL || *error == NULL);
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), FALSE);
+	g_return_val_if_fail (commit != NULL, FALSE);
+	g_return_val_if_fail (ancestor != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-	ret = git_reset (_ggit_native_get (repository),
-	                 _ggit_native_get (target),
-	                 (git_reset_t)reset_type,
-	                 (git_checkout_options *)_ggit_checkout_options_get_checkout_options (checkout_options));
+	ret = git_graph_descendant_of (_ggit_native_get (repository),
+	                               _ggit_oid_get_oid (commit),
+	                               _ggit_oid_get_oid (ancestor));
+
+	if (ret == 1)
+	{
+		return TRUE;
+	}
 
 	if (ret != GIT_OK)
 	{
 		_ggit_error_set (error, ret);
+
 	}
+
+	return FALSE;
 }
 
 /**
- * ggit_repository_reset_default:
+ * ggit_repository_create_blob:
  * @repository: a #GgitRepository.
- * @target: (allow-none): the target #GgitObject which is a commit or a tag.
- * @pathspecs: (array zero-terminated=1): a list of file paths to reset.
- * @error: a #GError for error reporting or %NULL.
  *
- * Update some entries in the index from the target commit tree. The scope of
- * the updated entries is determined by the paths specified in @pathspecs.
- * Passing %NULL in @target will result in removing entries in the index
- * matching the provided pathspecs.
+ * Create a new blob and return a #GOutputStream to write contents to the blob.
+ * This is an efficient way to create new blobs without copying data. The
+ * blob id can be obtained from the blob output stream using
+ * #ggit_blob_output_stream_get_id, after you close the stream.
+ *
+ * Returns: (transfer full) (nullable): a #GgitBlobOutputStream.
  *
  **/
-void
-ggit_repository_reset_default (GgitRepository       *repository,
-                               GgitObject           *target,
-                               const gchar * const  *pathspecs,
-                               GError              **error)
+GgitBlobOutputStream *
+ggit_repository_create_blob (GgitRepository *repository)
 {
-	gint ret;
-	git_strarray pp;
-
-	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
-	g_return_if_fail (target == NULL || GGIT_IS_OBJECT (target));
-	g_return_if_fail (pathspecs != NULL && *pathspecs != NULL);
-	g_return_if_fail (error == NULL || *error == NULL);
-
-	ggit_utils_get_git_strarray_from_str_array (pathspecs, &pp);
-
-	ret = git_reset_default (_ggit_native_get (repository),
-	                         _ggit_native_get (target),
-	                         &pp);
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
+	return _ggit_blob_output_stream_new (repository);
+}
 
-	git_strarray_free (&pp);
+/**
+ * ggit_repository_open_blob_stream:
+ * @repository: a #GgitRepository.
+ * @oid: the id of the blob to read.
+ * @as_path: (allow-none): the path used to select the filters to apply, or %NULL.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Open a #GInputStream reading the contents of the blob identified by @oid,
+ * without loading it as a #GgitBlob.
+ *
+ * Only loose blobs read without filters are streamed in constant memory:
+ * they are inflated as the stream is read. libgit2 cannot stream objects
+ * out of a pack, so a packed blob is inflated in full when the stream is
+ * opened and then served from memory. Filtering needs the whole contents
+ * as well. Either way, the memory used is proportional to the size of the
+ * blob, which is what most blobs cost in a cloned or garbage-collected
+ * repository.
+ *
+ * If @as_path is not %NULL, the filters configured for @as_path (such as
+ * CRLF conversion and ident expansion) are applied, as when checking out
+ * the blob to the working directory. This also reads the blob in full.
+ *
+ * Returns: (transfer full) (nullable): a #GgitBlobInputStream or %NULL.
+ *
+ **/
+GgitBlobInputStream *
+ggit_repository_open_blob_stream (GgitRepository  *repository,
+                                  GgitOId         *oid,
+                                  const gchar     *as_path,
+                                  GError         **error)
+{
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
+	g_return_val_if_fail (oid != NULL, NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	if (ret != GIT_OK)
-	{
-		_ggit_error_set (error, ret);
-	}
+	return _ggit_blob_input_stream_new (repository, oid, as_path, error);
 }
 
 /**
- * ggit_repository_save_stash:
+ * ggit_repository_create_blob_from_buffer:
  * @repository: a #GgitRepository.
- * @stasher: a #GgitSignature.
- * @message: description along with the stashed state or %NULL to be autogenerated.
- * @flags: a #GgitStashFlags to control the stashing process.
- * @error: a #GError for error reporting, #GGIT_ENOTFOUND if there's nothing to stash or %NULL.
+ * @buffer: (array length=size) (element-type guint8): the data.
+ * @size: the length (in bytes) of the data.
+ * @error: a #GError for error reporting, or %NULL.
  *
- * Saves the local modifications to a new stash.
- * It returns the commit containing the stashed state.
- * This commit is also the target of the direct reference refs/stash.
+ * Write an in-memory buffer to the object database as a blob.
  *
- * Returns: (transfer full) (nullable): a new object id of the commit containing the stashed state.
+ * Returns: (transfer full) (nullable): the new #GgitOid of the written blob,
+ * or %NULL if writing the blob failed.
  */
 GgitOId *
-ggit_repository_save_stash (GgitRepository  *repository,
-                            GgitSignature   *stasher,
-                            const gchar     *message,
-                            GgitStashFlags   flags,
-                            GError         **error)
+ggit_repository_create_blob_from_buffer (GgitRepository  *repository,
+                                         gconstpointer    buffer,
+                                         gsize            size,
+                                         GError         **error)
 {
 	gint ret;
 	git_oid oid;
 
 	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
-	g_return_val_if_fail (GGIT_IS_SIGNATURE (stasher), NULL);
+	g_return_val_if_fail (buffer != NULL, NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	ret = git_stash_save (&oid,
-	                      _ggit_native_get (repository),
-	                      _ggit_native_get (stasher),
-	                      message,
-	                      flags);
+	ret = git_blob_create_frombuffer (&oid,
+	                                  _ggit_native_get (repository),
+	                                  buffer,
+	                                  size);
 
 	if (ret != GIT_OK)
 	{
@@ -2806,236 +4541,381 @@ ggit_repository_save_stash (GgitRepository  *repository,
 }
 
 /**
- * ggit_repository_drop_stash:
+ * ggit_repository_create_blob_from_file:
  * @repository: a #GgitRepository.
- * @index: the position within the stash list. 0 points to the.
- * most recent stashed state.
+ * @file: a #GFile.
  * @error: a #GError for error reporting, or %NULL.
  *
- * Removes a single stashed state from the stash list.
+ * Write a file to the object database as a blob.
+ *
+ * Returns (transfer full) (nullable): the new #GgitOid of the written blob,
+ * or %NULL if writing the blob failed.
  */
-void
-ggit_repository_drop_stash (GgitRepository  *repository,
-                            gsize            index,
-                            GError         **error)
+GgitOId *
+ggit_repository_create_blob_from_file (GgitRepository  *repository,
+                                       GFile           *file,
+                                       GError         **error)
 {
 	gint ret;
+	git_oid oid;
+	gchar *path;
 
-	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
-	g_return_if_fail (error == NULL || *error == NULL);
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
+	g_return_val_if_fail (G_IS_FILE (file), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	ret = git_stash_drop (_ggit_native_get (repository),
-	                      index);
+	path = g_file_get_path (file);
+
+	ret = git_blob_create_fromdisk (&oid,
+	                                _ggit_native_get (repository),
+	                                path);
+
+	g_free (path);
 
 	if (ret != GIT_OK)
 	{
 		_ggit_error_set (error, ret);
+		return NULL;
 	}
+
+	return _ggit_oid_wrap (&oid);
 }
 
 typedef struct
 {
-	gpointer user_data;
+	const gchar *repo_path;
+	GFile **files;
+	guint n_files;
+	git_oid *oids;
+	GCancellable *cancellable;
+	GAsyncQueue *done;
 
-	GgitStashCallback callback;
-} StashCallbackWrapperData;
+	gint next_file;
+	gint failed;
 
-static gint
-stash_callback_wrapper (gsize          index,
-                        const gchar   *message,
-                        const git_oid *stash_oid,
-                        gpointer       user_data)
+	/* protected by lock */
+	GMutex lock;
+	GError *error;
+} CreateBlobsData;
+
+static void
+create_blobs_set_error (CreateBlobsData *data,
+                        GError          *error)
 {
-	StashCallbackWrapperData *wrapper_data = (StashCallbackWrapperData *)user_data;
-	GgitOId *oid;
+	g_mutex_lock (&data->lock);
+
+	if (data->error == NULL)
+	{
+		data->error = error;
+		error = NULL;
+	}
+
+	g_mutex_unlock (&data->lock);
+
+	g_clear_error (&error);
+	g_atomic_int_set (&data->failed, 1);
+}
+
+static void
+create_blobs_write (CreateBlobsData *data,
+                    git_odb         *odb,
+                    guint            idx)
+{
+	GMappedFile *mapped;
+	GError *error = NULL;
+	gchar *path;
+	gsize size = 0;
+	gint ret;
+
+	if (g_atomic_int_get (&data->failed) ||
+	    g_cancellable_set_error_if_cancelled (data->cancellable, &error))
+	{
+		if (error != NULL)
+		{
+			create_blobs_set_error (data, error);
+		}
+
+		g_async_queue_push (data->done, GSIZE_TO_POINTER (size + 1));
+		return;
+	}
+
+	path = g_file_get_path (data->files[idx]);
+	mapped = path != NULL ? g_mapped_file_new (path, FALSE, &error) : NULL;
+	g_free (path);
+
+	if (mapped == NULL)
+	{
+		if (error == NULL)
+		{
+			g_set_error (&error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+			             "The file does not have a local path");
+		}
+
+		create_blobs_set_error (data, error);
+	}
+	else
+	{
+		const gchar *contents;
+
+		size = g_mapped_file_get_length (mapped);
+		contents = g_mapped_file_get_contents (mapped);
+
+		/* Hashes, deflates and writes the loose object */
+		ret = git_odb_write (&data->oids[idx],
+		                     odb,
+		                     contents != NULL ? contents : "",
+		                     size,
+		                     GIT_OBJ_BLOB);
+
+		g_mapped_file_unref (mapped);
+
+		if (ret != GIT_OK)
+		{
+			_ggit_error_set (&error, ret);
+			create_blobs_set_error (data, error);
+		}
+	}
+
+	g_async_queue_push (data->done, GSIZE_TO_POINTER (size + 1));
+}
+
+static gpointer
+create_blobs_thread (gpointer user_data)
+{
+	CreateBlobsData *data = user_data;
+	git_repository *repo = NULL;
+	git_odb *odb = NULL;
+	gint i;
 	gint ret;
 
-	oid = _ggit_oid_wrap (stash_oid);
+	ret = ggit_utils_open_worker_repository (&repo, data->repo_path, NULL);
+
+	if (ret == GIT_OK)
+	{
+		ret = git_repository_odb (&odb, repo);
+	}
+
+	if (ret != GIT_OK)
+	{
+		GError *error = NULL;
+
+		_ggit_error_set (&error, ret);
+		create_blobs_set_error (data, error);
+	}
+
+	/* Every file is still accounted for after a failure, so that the
+	 * calling thread receives one result per file.
+	 */
+	while ((i = g_atomic_int_add (&data->next_file, 1)) < (gint)data->n_files)
+	{
+		create_blobs_write (data, odb, i);
+	}
+
+	if (odb != NULL)
+	{
+		git_odb_free (odb);
+	}
 
-	ret = wrapper_data->callback (index, message, oid, wrapper_data->user_data);
-	ggit_oid_free (oid);
+	if (repo != NULL)
+	{
+		git_repository_free (repo);
+	}
 
-	return ret;
+	return NULL;
 }
 
 /**
- * ggit_repository_stash_foreach:
+ * ggit_repository_create_blobs_from_files:
  * @repository: a #GgitRepository.
- * @callback: (scope call): a #GgitStashCallback.
- * @user_data: callback user data.
+ * @files: (array length=n_files): the files to write.
+ * @n_files: the number of files in @files.
+ * @n_workers: the number of threads to use, or 0 to use the number of
+ *             processors.
+ * @cancellable: (allow-none): a #GCancellable, or %NULL.
+ * @progress: (allow-none) (scope call) (closure user_data): a
+ *            #GgitBlobsProgressCallback, or %NULL.
+ * @user_data: user data for @progress.
  * @error: a #GError for error reporting, or %NULL.
  *
- * Loops over all the stashed states and issue a callback for each one.
- * If @callback returns a non-zero value, this will stop looping.
+ * Write many files to the object database as blobs, see
+ * ggit_repository_create_blob_from_file(). The files are memory mapped
+ * and hashed, compressed and written on @n_workers threads, each using
+ * its own handle on the object database. @progress is called from the
+ * calling thread each time a file has been written.
  *
- * Returns: %TRUE if there was no error, %FALSE otherwise.
+ * If any of the files could not be written, or the operation was
+ * cancelled, %NULL is returned and @error is set. Blobs which were
+ * already written remain in the object database.
+ *
+ * Returns: (transfer full) (element-type GgitOId) (nullable): the ids of
+ *          the written blobs, in the order of @files, or %NULL.
  */
-gboolean
-ggit_repository_stash_foreach (GgitRepository     *repository,
-                               GgitStashCallback   callback,
-                               gpointer            user_data,
-                               GError            **error)
+GPtrArray *
+ggit_repository_create_blobs_from_files (GgitRepository             *repository,
+                                         GFile                     **files,
+                                         guint                       n_files,
+                                         guint                       n_workers,
+                                         GCancellable               *cancellable,
+                                         GgitBlobsProgressCallback   progress,
+                                         gpointer                    user_data,
+                                         GError                    **error)
 {
-	StashCallbackWrapperData wrapper_data;
-	gint ret;
+	CreateBlobsData data = { 0, };
+	GThread **threads;
+	GPtrArray *ret = NULL;
+	guint64 bytes_done = 0;
+	guint i;
 
-	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), FALSE);
-	g_return_val_if_fail (callback != NULL, FALSE);
-	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
+	g_return_val_if_fail (files != NULL || n_files == 0, NULL);
+	g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	wrapper_data.user_data = user_data;
-	wrapper_data.callback = callback;
+	if (n_workers == 0)
+	{
+		n_workers = g_get_num_processors ();
+	}
 
-	ret = git_stash_foreach (_ggit_native_get (repository),
-	                         stash_callback_wrapper,
-	                         &wrapper_data);
+	n_workers = MAX (MIN (n_workers, n_files), 1);
 
-	if (ret != GIT_OK)
+	data.repo_path = git_repository_path (_ggit_native_get (repository));
+	data.files = files;
+	data.n_files = n_files;
+	data.oids = g_new0 (git_oid, n_files);
+	data.cancellable = cancellable;
+	data.done = g_async_queue_new ();
+	g_mutex_init (&data.lock);
+
+	threads = g_new (GThread *, n_workers);
+
+	for (i = 0; i < n_workers; ++i)
 	{
-		_ggit_error_set (error, ret);
-		return FALSE;
+		threads[i] = g_thread_new ("ggit-blobs", create_blobs_thread, &data);
 	}
 
-	return TRUE;
-}
+	for (i = 0; i < n_files; ++i)
+	{
+		gsize size;
 
-/**
- * ggit_repository_get_ahead_behind:
- * @repository: a #GgitRepository.
- * @local: the commit for local.
- * @upstream: the commit for upstream.
- * @ahead: (out): number of unique from commits in @upstream.
- * @behind: (out): number of unique from commits in @local.
- * @error: a #GError for error reporting, or %NULL.
- *
- * Count the number of unique commits between two commit objects.
- *
- * There is no need for branches containing the commits to have any
- * upstream relationship, but it helps to think of one as a branch and
- * the other as its upstream, the @ahead and @behind values will be
- * what git would report for the branches.
- */
-void
-ggit_repository_get_ahead_behind (GgitRepository  *repository,
-                                  GgitOId         *local,
-                                  GgitOId         *upstream,
-                                  gsize           *ahead,
-                                  gsize           *behind,
-                                  GError         **error)
-{
-	gint ret;
+		size = GPOINTER_TO_SIZE (g_async_queue_pop (data.done)) - 1;
+		bytes_done += size;
 
-	g_return_if_fail (GGIT_IS_REPOSITORY (repository));
-	g_return_if_fail (local != NULL);
-	g_return_if_fail (upstream != NULL);
-	g_return_if_fail (ahead != NULL);
-	g_return_if_fail (behind != NULL);
-	g_return_if_fail (error == NULL || *error == NULL);
+		if (progress != NULL && !g_atomic_int_get (&data.failed))
+		{
+			progress (i + 1, n_files, bytes_done, user_data);
+		}
+	}
 
-	ret = git_graph_ahead_behind (ahead, behind,
-	                              _ggit_native_get (repository),
-	                              _ggit_oid_get_oid (local),
-	                              _ggit_oid_get_oid (upstream));
+	for (i = 0; i < n_workers; ++i)
+	{
+		g_thread_join (threads[i]);
+	}
 
-	if (ret != GIT_OK)
+	g_free (threads);
+	g_async_queue_unref (data.done);
+	g_mutex_clear (&data.lock);
+
+	if (data.error != NULL)
 	{
-		_ggit_error_set (error, ret);
+		g_propagate_error (error, data.error);
+	}
+	else
+	{
+		ret = g_ptr_array_new_full (n_files, (GDestroyNotify)ggit_oid_free);
+
+		for (i = 0; i < n_files; ++i)
+		{
+			g_ptr_array_add (ret, _ggit_oid_wrap (&data.oids[i]));
+		}
 	}
+
+	g_free (data.oids);
+
+	return ret;
 }
 
 /**
- * ggit_repository_get_descendant_of:
+ * ggit_repository_hash_file:
  * @repository: a #GgitRepository.
- * @commit: the commit.
- * @ancestor: the ancestor.
+ * @file: a #GFile.
+ * @as_path: (allow-none): the path used to select the filters to apply, or %NULL.
  * @error: a #GError for error reporting, or %NULL.
  *
- * Check whether @com mit is a descendant of @ancestor. Note that if this
- * function returns %FALSE, an error might have occurred. If so, @error will
- * be set appropriately.
- *
- * Returns: %TRUE if @commit is a descendant of @ancestor, or %FALSE otherwise.
+ * Compute the id @file would have if it was written to the object database
+ * as a blob, without writing it. The filters configured for the file (such
+ * as CRLF conversion) are applied, as when adding the file to the index.
+ * If @as_path is %NULL, the path of @file relative to the working directory
+ * is used to select the filters. Pass an empty string to disable filtering.
  *
+ * Returns: (transfer full) (nullable): the #GgitOId of the blob, or %NULL
+ *          if the file could not be read.
  */
-gboolean
-ggit_repository_get_descendant_of (GgitRepository  *repository,
-                                   GgitOId         *commit,
-                                   GgitOId         *ancestor,
-                                   GError         **error)
+GgitOId *
+ggit_repository_hash_file (GgitRepository  *repository,
+                           GFile           *file,
+                           const gchar     *as_path,
+                           GError         **error)
 {
 	gint ret;
+	git_oid oid;
+	gchar *path;
 
-	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), FALSE);
-	g_return_val_if_fail (commit != NULL, FALSE);
-	g_return_val_if_fail (ancestor != NULL, FALSE);
-	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
+	g_return_val_if_fail (G_IS_FILE (file), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	ret = git_graph_descendant_of (_ggit_native_get (repository),
-	                               _ggit_oid_get_oid (commit),
-	                               _ggit_oid_get_oid (ancestor));
+	path = g_file_get_path (file);
 
-	if (ret == 1)
+	if (path == NULL)
 	{
-		return TRUE;
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+		             "The file does not have a local path");
+		return NULL;
 	}
 
+	ret = git_repository_hashfile (&oid,
+	                               _ggit_native_get (repository),
+	                               path,
+	                               GIT_OBJ_BLOB,
+	                               as_path);
+
+	g_free (path);
+
 	if (ret != GIT_OK)
 	{
 		_ggit_error_set (error, ret);
-
+		return NULL;
 	}
 
-	return FALSE;
-}
-
-/**
- * ggit_repository_create_blob:
- * @repository: a #GgitRepository.
- *
- * Create a new blob and return a #GOutputStream to write contents to the blob.
- * This is an efficient way to create new blobs without copying data. The
- * blob id can be obtained from the blob output stream using
- * #ggit_blob_output_stream_get_id, after you close the stream.
- *
- * Returns: (transfer full) (nullable): a #GgitBlobOutputStream.
- *
- **/
-GgitBlobOutputStream *
-ggit_repository_create_blob (GgitRepository *repository)
-{
-	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
-	return _ggit_blob_output_stream_new (repository);
+	return _ggit_oid_wrap (&oid);
 }
 
 /**
- * ggit_repository_create_blob_from_buffer:
+ * ggit_repository_hash_buffer:
  * @repository: a #GgitRepository.
  * @buffer: (array length=size) (element-type guint8): the data.
- * @size: the length (in bytes) of the data.
+ * @size: the size of @buffer.
  * @error: a #GError for error reporting, or %NULL.
  *
- * Write an in-memory buffer to the object database as a blob.
+ * Compute the id @buffer would have if it was written to the object
+ * database as a blob, without writing it. No filters are applied.
  *
- * Returns: (transfer full) (nullable): the new #GgitOid of the written blob,
- * or %NULL if writing the blob failed.
+ * Returns: (transfer full) (nullable): the #GgitOId of the blob, or %NULL.
  */
 GgitOId *
-ggit_repository_create_blob_from_buffer (GgitRepository  *repository,
-                                         gconstpointer    buffer,
-                                         gsize            size,
-                                         GError         **error)
+ggit_repository_hash_buffer (GgitRepository  *repository,
+                             gconstpointer    buffer,
+                             gsize            size,
+                             GError         **error)
 {
 	gint ret;
 	git_oid oid;
 
 	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
-	g_return_val_if_fail (buffer != NULL, NULL);
+	g_return_val_if_fail (buffer != NULL || size == 0, NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	ret = git_blob_create_frombuffer (&oid,
-	                                  _ggit_native_get (repository),
-	                                  buffer,
-	                                  size);
+	ret = git_odb_hash (&oid, buffer != NULL ? buffer : "", size, GIT_OBJ_BLOB);
 
 	if (ret != GIT_OK)
 	{
@@ -3046,45 +4926,182 @@ ggit_repository_create_blob_from_buffer (GgitRepository  *repository,
 	return _ggit_oid_wrap (&oid);
 }
 
+typedef struct
+{
+	const gchar *repo_path;
+	const gchar *workdir;
+	GFile **files;
+	guint n_files;
+	git_oid *oids;
+	GCancellable *cancellable;
+
+	gint next_file;
+	gint failed;
+
+	/* protected by lock */
+	GMutex lock;
+	GError *error;
+} HashFilesData;
+
+static gpointer
+hash_files_thread (gpointer user_data)
+{
+	HashFilesData *data = user_data;
+	git_repository *repo = NULL;
+	GError *error = NULL;
+	gint ret;
+	gint i;
+
+	/* The attribute cache, and therefore the filter rules, is shared by
+	 * all the files hashed on this thread.
+	 */
+	ret = ggit_utils_open_worker_repository (&repo,
+	                                         data->repo_path,
+	                                         data->workdir);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (&error, ret);
+	}
+
+	while (error == NULL &&
+	       !g_atomic_int_get (&data->failed) &&
+	       (i = g_atomic_int_add (&data->next_file, 1)) < (gint)data->n_files &&
+	       !g_cancellable_set_error_if_cancelled (data->cancellable, &error))
+	{
+		gchar *path;
+
+		path = g_file_get_path (data->files[i]);
+
+		if (path == NULL)
+		{
+			g_set_error (&error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+			             "The file does not have a local path");
+		}
+		else
+		{
+			ret = git_repository_hashfile (&data->oids[i],
+			                               repo,
+			                               path,
+			                               GIT_OBJ_BLOB,
+			                               NULL);
+
+			g_free (path);
+
+			if (ret != GIT_OK)
+			{
+				_ggit_error_set (&error, ret);
+			}
+		}
+	}
+
+	if (error != NULL)
+	{
+		g_mutex_lock (&data->lock);
+
+		if (data->error == NULL)
+		{
+			data->error = error;
+			error = NULL;
+		}
+
+		g_mutex_unlock (&data->lock);
+
+		g_clear_error (&error);
+		g_atomic_int_set (&data->failed, 1);
+	}
+
+	if (repo != NULL)
+	{
+		git_repository_free (repo);
+	}
+
+	return NULL;
+}
+
 /**
- * ggit_repository_create_blob_from_file:
+ * ggit_repository_hash_files:
  * @repository: a #GgitRepository.
- * @file: a #GFile.
+ * @files: (array length=n_files): the files to hash.
+ * @n_files: the number of files in @files.
+ * @n_workers: the number of threads to use, or 0 to use the number of
+ *             processors.
+ * @cancellable: (allow-none): a #GCancellable, or %NULL.
  * @error: a #GError for error reporting, or %NULL.
  *
- * Write a file to the object database as a blob.
+ * Compute the blob ids of many files at once on @n_workers threads, see
+ * ggit_repository_hash_file(). Filters are selected using the path of each
+ * file relative to the working directory. Each thread uses its own handle
+ * on @repository, so the filter rules are loaded once per thread.
  *
- * Returns (transfer full) (nullable): the new #GgitOid of the written blob,
- * or %NULL if writing the blob failed.
+ * Returns: (transfer full) (element-type GgitOId) (nullable): the ids of
+ *          the files, in the order of @files, or %NULL in case of an error.
  */
-GgitOId *
-ggit_repository_create_blob_from_file (GgitRepository  *repository,
-                                       GFile           *file,
-                                       GError         **error)
+GPtrArray *
+ggit_repository_hash_files (GgitRepository  *repository,
+                            GFile          **files,
+                            guint            n_files,
+                            guint            n_workers,
+                            GCancellable    *cancellable,
+                            GError         **error)
 {
-	gint ret;
-	git_oid oid;
-	gchar *path;
+	HashFilesData data = { 0, };
+	GThread **threads;
+	GPtrArray *ret = NULL;
+	guint i;
 
 	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
-	g_return_val_if_fail (G_IS_FILE (file), NULL);
+	g_return_val_if_fail (files != NULL || n_files == 0, NULL);
+	g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	path = g_file_get_path (file);
+	if (n_workers == 0)
+	{
+		n_workers = g_get_num_processors ();
+	}
 
-	ret = git_blob_create_fromdisk (&oid,
-	                                _ggit_native_get (repository),
-	                                path);
+	n_workers = MAX (MIN (n_workers, n_files), 1);
 
-	g_free (path);
+	data.repo_path = git_repository_path (_ggit_native_get (repository));
+	data.workdir = git_repository_workdir (_ggit_native_get (repository));
+	data.files = files;
+	data.n_files = n_files;
+	data.oids = g_new0 (git_oid, n_files);
+	data.cancellable = cancellable;
+	g_mutex_init (&data.lock);
 
-	if (ret != GIT_OK)
+	threads = g_new (GThread *, n_workers);
+
+	for (i = 0; i < n_workers; ++i)
 	{
-		_ggit_error_set (error, ret);
-		return NULL;
+		threads[i] = g_thread_new ("ggit-hash", hash_files_thread, &data);
 	}
 
-	return _ggit_oid_wrap (&oid);
+	for (i = 0; i < n_workers; ++i)
+	{
+		g_thread_join (threads[i]);
+	}
+
+	g_free (threads);
+	g_mutex_clear (&data.lock);
+
+	if (data.error != NULL)
+	{
+		g_propagate_error (error, data.error);
+	}
+	else
+	{
+		ret = g_ptr_array_new_full (n_files, (GDestroyNotify)ggit_oid_free);
+
+		for (i = 0; i < n_files; ++i)
+		{
+			g_ptr_array_add (ret, _ggit_oid_wrap (&data.oids[i]));
+		}
+	}
+
+	g_free (data.oids);
+
+	return ret;
 }
 
 /**
@@ -32,6 +32,7 @@
 #include <libgit2-glib/ggit-object.h>
 #include <libgit2-glib/ggit-tree.h>
 #include <libgit2-glib/ggit-branch.h>
+#include <libgit2-glib/ggit-blob-input-stream.h>
 #include <libgit2-glib/ggit-blob-output-stream.h>
 #include <libgit2-glib/ggit-checkout-options.h>
 #include <libgit2-glib/ggit-note.h>
@@ -43,6 +44,7 @@
 #include <libgit2-glib/ggit-rebase.h>
 #include <libgit2-glib/ggit-blob.h>
 #include <libgit2-glib/ggit-tag.h>
+#include <libgit2-glib/ggit-status-list.h>
 
 G_BEGIN_DECLS
 
@@ -92,11 +94,73 @@ GgitRepository     *ggit_repository_clone             (const gchar           *ur
                                                        GgitCloneOptions      *options,
                                                        GError               **error);
 
+void                ggit_repository_open_async        (GFile                 *location,
+                                                       gint                   io_priority,
+                                                       GCancellable          *cancellable,
+                                                       GAsyncReadyCallback    callback,
+                                                       gpointer               user_data);
+
+GgitRepository     *ggit_repository_open_finish       (GAsyncResult          *result,
+                                                       GError               **error);
+
+void                ggit_repository_init_repository_async (
+                                                       GFile                 *location,
+                                                       gboolean               is_bare,
+                                                       gint                   io_priority,
+                                                       GCancellable          *cancellable,
+                                                       GAsyncReadyCallback    callback,
+                                                       gpointer               user_data);
+
+GgitRepository     *ggit_repository_init_repository_finish (
+                                                       GAsyncResult          *result,
+                                                       GError               **error);
+
+void                ggit_repository_clone_async       (const gchar           *url,
+                                                       GFile                 *location,
+                                                       GgitCloneOptions      *options,
+                                                       gint                   io_priority,
+                                                       GCancellable          *cancellable,
+                                                       GAsyncReadyCallback    callback,
+                                                       gpointer               user_data);
+
+GgitRepository     *ggit_repository_clone_finish      (GAsyncResult          *result,
+                                                       GError               **error);
+
 GgitObject         *ggit_repository_lookup            (GgitRepository        *repository,
                                                        GgitOId               *oid,
                                                        GType                  gtype,
                                                        GError               **error);
 
+void                ggit_repository_set_object_cache_enabled (GgitRepository   *repository,
+                                                              gboolean          enabled);
+
+gboolean            ggit_repository_get_object_cache_enabled (GgitRepository   *repository);
+
+void                ggit_repository_get_object_cache_stats   (GgitRepository   *repository,
+                                                              guint            *hits,
+                                                              guint            *misses);
+
+void                ggit_repository_reset_object_cache_stats (GgitRepository   *repository);
+
+GPtrArray          *ggit_repository_lookup_many       (GgitRepository        *repository,
+                                                       GgitOId              **oids,
+                                                       guint                  n_oids,
+                                                       GType                  gtype,
+                                                       GError               **error);
+
+gboolean            ggit_repository_read_object_header  (GgitRepository      *repository,
+                                                         GgitOId             *oid,
+                                                         GType               *gtype,
+                                                         gsize               *size,
+                                                         GError             **error);
+
+gboolean            ggit_repository_read_object_headers (GgitRepository      *repository,
+                                                         GgitOId            **oids,
+                                                         guint                n_oids,
+                                                         GType               *gtypes,
+                                                         gsize               *sizes,
+                                                         GError             **error);
+
 GgitRef            *ggit_repository_lookup_reference  (GgitRepository        *repository,
                                                        const gchar           *name,
                                                        GError               **error);
@@ -121,6 +185,12 @@ GgitRef            *ggit_repository_create_symbolic_reference
 GgitBlobOutputStream *
                     ggit_repository_create_blob       (GgitRepository        *repository);
 
+GgitBlobInputStream *
+                    ggit_repository_open_blob_stream  (GgitRepository        *repository,
+                                                       GgitOId               *oid,
+                                                       const gchar           *as_path,
+                                                       GError               **error);
+
 
 GgitOId            *ggit_repository_create_blob_from_buffer (
                                                        GgitRepository        *repository,
@@ -138,6 +208,33 @@ GgitOId            *ggit_repository_create_blob_from_path (
                                                        const gchar           *path,
                                                        GError               **error);
 
+GPtrArray          *ggit_repository_create_blobs_from_files (
+                                                       GgitRepository             *repository,
+                                                       GFile                     **files,
+                                                       guint                       n_files,
+                                                       guint                       n_workers,
+                                                       GCancellable               *cancellable,
+                                                       GgitBlobsProgressCallback   progress,
+                                                       gpointer                    user_data,
+                                                       GError                    **error);
+
+GgitOId            *ggit_repository_hash_file         (GgitRepository        *repository,
+                                                       GFile                 *file,
+                                                       const gchar           *as_path,
+                                                       GError               **error);
+
+GgitOId            *ggit_repository_hash_buffer       (GgitRepository        *repository,
+                                                       gconstpointer          buffer,
+                                                       gsize                  size,
+                                                       GError               **error);
+
+GPtrArray          *ggit_repository_hash_files        (GgitRepository        *repository,
+                                                       GFile                **files,
+                                                       guint                  n_files,
+                                                       guint                  n_workers,
+                                                       GCancellable          *cancellable,
+                                                       GError               **error);
+
 GgitOId                    *ggit_repository_create_commit (
                                                        GgitRepository        *repository,
                                                        const gchar           *update_ref,
@@ -362,6 +459,22 @@ gboolean            ggit_repository_file_status_foreach
                                                       gpointer                user_data,
                                                       GError                **error);
 
+gboolean            ggit_repository_file_status_foreach_parallel
+                                                     (GgitRepository         *repository,
+                                                      GgitStatusOptions      *options,
+                                                      guint                   n_workers,
+                                                      GgitStatusCallback      callback,
+                                                      gpointer                user_data,
+                                                      GError                **error);
+
+gboolean            ggit_repository_is_dirty          (GgitRepository        *repository,
+                                                       GgitDirtyFlags         flags,
+                                                       GError               **error);
+
+GgitStatusList     *ggit_repository_get_status_list   (GgitRepository        *repository,
+                                                       GgitStatusOptions     *options,
+                                                       GError               **error);
+
 gboolean            ggit_repository_references_foreach (GgitRepository             *repository,
                                                         GgitReferencesCallback      callback,
                                                         gpointer                    user_data,
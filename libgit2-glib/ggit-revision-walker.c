@@ -544,6 +544,71 @@ ggit_revision_walker_next (GgitRevisionWalker  *walker,
 	return goid;
 }
 
+/**
+ * ggit_revision_walker_next_n:
+ * @walker: a #GgitRevisionWalker.
+ * @max_commits: the maximum number of commits to return.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Gets up to @max_commits commits from the revision walk at once. The
+ * ids are returned as consecutive raw (binary) object ids, so the number
+ * of commits returned is the size of the returned #GBytes divided by
+ * the size of a raw object id (20 bytes). Use ggit_oid_new_from_raw() to
+ * turn a single entry back into a #GgitOId.
+ *
+ * This avoids allocating a #GgitOId for every commit and is the
+ * preferred way of walking large histories.
+ *
+ * Fewer than @max_commits ids are returned only when the walk is over;
+ * an empty #GBytes is returned once there are no more commits. Like
+ * ggit_revision_walker_next(), the revision walker is reset when the
+ * walk is over.
+ *
+ * Returns: (transfer full) (nullable): the packed raw ids of the next
+ *          commits from the revision walk or %NULL in case of an error.
+ */
+GBytes *
+ggit_revision_walker_next_n (GgitRevisionWalker  *walker,
+                             guint                max_commits,
+                             GError             **error)
+{
+	git_revwalk *revwalk;
+	GByteArray *ids;
+	git_oid oid;
+	guint i;
+	gint ret = GIT_OK;
+
+	g_return_val_if_fail (GGIT_IS_REVISION_WALKER (walker), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	revwalk = _ggit_native_get (walker);
+
+	/* @max_commits is only an upper bound, let the array grow past this */
+	ids = g_byte_array_sized_new (MIN (max_commits, 1024) * GIT_OID_RAWSZ);
+
+	for (i = 0; i < max_commits; ++i)
+	{
+		ret = git_revwalk_next (&oid, revwalk);
+
+		if (ret != GIT_OK)
+		{
+			break;
+		}
+
+		g_byte_array_append (ids, oid.id, GIT_OID_RAWSZ);
+	}
+
+	if (ret != GIT_OK && ret != GIT_ITEROVER)
+	{
+		_ggit_error_set (error, ret);
+		g_byte_array_unref (ids);
+
+		return NULL;
+	}
+
+	return g_byte_array_free_to_bytes (ids);
+}
+
 /**
  * ggit_revision_walker_set_sort_mode:
  * @walker: a #GgitRevisionWalker.
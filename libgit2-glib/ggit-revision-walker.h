@@ -85,6 +85,10 @@ void                    ggit_revision_walker_hide_head      (GgitRevisionWalker
 GgitOId                *ggit_revision_walker_next           (GgitRevisionWalker  *walker,
                                                              GError             **error);
 
+GBytes                 *ggit_revision_walker_next_n         (GgitRevisionWalker  *walker,
+                                                             guint                max_commits,
+                                                             GError             **error);
+
 void                    ggit_revision_walker_set_sort_mode  (GgitRevisionWalker *walker,
                                                              GgitSortMode        sort_mode);
 
@@ -0,0 +1,451 @@
+/*
+ * ggit-status-list.c
+ * This file is part of libgit2-glib
+ *
+ * Copyright (C) 2026 - The libgit2-glib authors
+ *
+ * libgit2-glib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libgit2-glib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ggit-status-list.h"
+#include "ggit-diff-delta.h"
+
+/**
+ * GgitStatusList:
+ *
+ * Represents the status of the files of a repository, computed once.
+ *
+ * The entries are accessed by index and are read directly from the native
+ * list, without being copied. #GgitStatusList implements #GListModel, each
+ * item being a #GgitStatusEntry which is created when it is requested.
+ */
+struct _GgitStatusList
+{
+	GgitNative parent_instance;
+};
+
+/**
+ * GgitStatusEntry:
+ *
+ * Represents a single entry of a #GgitStatusList.
+ */
+struct _GgitStatusEntry
+{
+	GObject parent_instance;
+
+	GgitStatusList *list;
+	gsize index;
+};
+
+static void ggit_status_list_list_model_iface_init (GListModelInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GgitStatusList, ggit_status_list, GGIT_TYPE_NATIVE,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL,
+                                                ggit_status_list_list_model_iface_init))
+
+G_DEFINE_TYPE (GgitStatusEntry, ggit_status_entry, G_TYPE_OBJECT)
+
+static GType
+ggit_status_list_get_item_type (GListModel *model)
+{
+	return GGIT_TYPE_STATUS_ENTRY;
+}
+
+static guint
+ggit_status_list_get_n_items (GListModel *model)
+{
+	return (guint)ggit_status_list_get_size (GGIT_STATUS_LIST (model));
+}
+
+static gpointer
+ggit_status_list_get_item (GListModel *model,
+                           guint       position)
+{
+	GgitStatusList *status_list = GGIT_STATUS_LIST (model);
+
+	if (position >= ggit_status_list_get_size (status_list))
+	{
+		return NULL;
+	}
+
+	return ggit_status_list_get_entry (status_list, position);
+}
+
+static void
+ggit_status_list_list_model_iface_init (GListModelInterface *iface)
+{
+	iface->get_item_type = ggit_status_list_get_item_type;
+	iface->get_n_items = ggit_status_list_get_n_items;
+	iface->get_item = ggit_status_list_get_item;
+}
+
+static void
+ggit_status_list_class_init (GgitStatusListClass *klass)
+{
+}
+
+static void
+ggit_status_list_init (GgitStatusList *status_list)
+{
+}
+
+static void
+ggit_status_entry_finalize (GObject *object)
+{
+	GgitStatusEntry *entry = GGIT_STATUS_ENTRY (object);
+
+	g_clear_object (&entry->list);
+
+	G_OBJECT_CLASS (ggit_status_entry_parent_class)->finalize (object);
+}
+
+static void
+ggit_status_entry_class_init (GgitStatusEntryClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->finalize = ggit_status_entry_finalize;
+}
+
+static void
+ggit_status_entry_init (GgitStatusEntry *entry)
+{
+}
+
+GgitStatusList *
+_ggit_status_list_wrap (git_status_list *status_list)
+{
+	GgitStatusList *gstatus_list;
+
+	gstatus_list = g_object_new (GGIT_TYPE_STATUS_LIST,
+	                             "native", status_list,
+	                             NULL);
+
+	_ggit_native_set_destroy_func (gstatus_list,
+	                               (GDestroyNotify)git_status_list_free);
+
+	return gstatus_list;
+}
+
+static const git_status_entry *
+get_native_entry (GgitStatusList *status_list,
+                  gsize           idx)
+{
+	return git_status_byindex (_ggit_native_get (status_list), idx);
+}
+
+/**
+ * ggit_status_list_get_size:
+ * @status_list: a #GgitStatusList.
+ *
+ * Get the number of entries in @status_list.
+ *
+ * Returns: the number of entries.
+ */
+gsize
+ggit_status_list_get_size (GgitStatusList *status_list)
+{
+	g_return_val_if_fail (GGIT_IS_STATUS_LIST (status_list), 0);
+
+	return git_status_list_entrycount (_ggit_native_get (status_list));
+}
+
+/**
+ * ggit_status_list_get_status:
+ * @status_list: a #GgitStatusList.
+ * @idx: the index of the entry.
+ *
+ * Get the status of the entry at @idx.
+ *
+ * Returns: a #GgitStatusFlags.
+ */
+GgitStatusFlags
+ggit_status_list_get_status (GgitStatusList *status_list,
+                             gsize           idx)
+{
+	const git_status_entry *entry;
+
+	g_return_val_if_fail (GGIT_IS_STATUS_LIST (status_list), GGIT_STATUS_CURRENT);
+
+	entry = get_native_entry (status_list, idx);
+	g_return_val_if_fail (entry != NULL, GGIT_STATUS_CURRENT);
+
+	return (GgitStatusFlags)entry->status;
+}
+
+/**
+ * ggit_status_list_get_path:
+ * @status_list: a #GgitStatusList.
+ * @idx: the index of the entry.
+ *
+ * Get the current path of the entry at @idx, relative to the working
+ * directory. For renamed files, this is the path after the rename.
+ *
+ * Returns: (transfer none) (nullable): the path of the entry.
+ */
+const gchar *
+ggit_status_list_get_path (GgitStatusList *status_list,
+                           gsize           idx)
+{
+	const git_status_entry *entry;
+
+	g_return_val_if_fail (GGIT_IS_STATUS_LIST (status_list), NULL);
+
+	entry = get_native_entry (status_list, idx);
+	g_return_val_if_fail (entry != NULL, NULL);
+
+	if (entry->index_to_workdir != NULL)
+	{
+		return entry->index_to_workdir->new_file.path;
+	}
+	else if (entry->head_to_index != NULL)
+	{
+		return entry->head_to_index->new_file.path;
+	}
+
+	return NULL;
+}
+
+/**
+ * ggit_status_list_get_renamed_from:
+ * @status_list: a #GgitStatusList.
+ * @idx: the index of the entry.
+ *
+ * Get the original path of the entry at @idx if it was renamed, either in
+ * the index or in the working directory. Renames are only detected when
+ * requested in the #GgitStatusOptions used to create @status_list.
+ *
+ * Returns: (transfer none) (nullable): the path before the rename or %NULL
+ *          if the entry was not renamed.
+ */
+const gchar *
+ggit_status_list_get_renamed_from (GgitStatusList *status_list,
+                                   gsize           idx)
+{
+	const git_status_entry *entry;
+
+	g_return_val_if_fail (GGIT_IS_STATUS_LIST (status_list), NULL);
+
+	entry = get_native_entry (status_list, idx);
+	g_return_val_if_fail (entry != NULL, NULL);
+
+	if ((entry->status & GIT_STATUS_INDEX_RENAMED) && entry->head_to_index != NULL)
+	{
+		return entry->head_to_index->old_file.path;
+	}
+	else if ((entry->status & GIT_STATUS_WT_RENAMED) && entry->index_to_workdir != NULL)
+	{
+		return entry->index_to_workdir->old_file.path;
+	}
+
+	return NULL;
+}
+
+/**
+ * ggit_status_list_get_head_to_index:
+ * @status_list: a #GgitStatusList.
+ * @idx: the index of the entry.
+ *
+ * Get the differences between HEAD and the index for the entry at @idx.
+ *
+ * Returns: (transfer full) (nullable): a #GgitDiffDelta or %NULL if the
+ *          entry did not change in the index.
+ */
+GgitDiffDelta *
+ggit_status_list_get_head_to_index (GgitStatusList *status_list,
+                                    gsize           idx)
+{
+	const git_status_entry *entry;
+
+	g_return_val_if_fail (GGIT_IS_STATUS_LIST (status_list), NULL);
+
+	entry = get_native_entry (status_list, idx);
+	g_return_val_if_fail (entry != NULL, NULL);
+
+	if (entry->head_to_index == NULL)
+	{
+		return NULL;
+	}
+
+	return _ggit_diff_delta_wrap (entry->head_to_index);
+}
+
+/**
+ * ggit_status_list_get_index_to_workdir:
+ * @status_list: a #GgitStatusList.
+ * @idx: the index of the entry.
+ *
+ * Get the differences between the index and the working directory for the
+ * entry at @idx.
+ *
+ * Returns: (transfer full) (nullable): a #GgitDiffDelta or %NULL if the
+ *          entry did not change in the working directory.
+ */
+GgitDiffDelta *
+ggit_status_list_get_index_to_workdir (GgitStatusList *status_list,
+                                       gsize           idx)
+{
+	const git_status_entry *entry;
+
+	g_return_val_if_fail (GGIT_IS_STATUS_LIST (status_list), NULL);
+
+	entry = get_native_entry (status_list, idx);
+	g_return_val_if_fail (entry != NULL, NULL);
+
+	if (entry->index_to_workdir == NULL)
+	{
+		return NULL;
+	}
+
+	return _ggit_diff_delta_wrap (entry->index_to_workdir);
+}
+
+/**
+ * ggit_status_list_get_entry:
+ * @status_list: a #GgitStatusList.
+ * @idx: the index of the entry.
+ *
+ * Get the entry at @idx. The entry keeps a reference on @status_list.
+ *
+ * Returns: (transfer full): a #GgitStatusEntry.
+ */
+GgitStatusEntry *
+ggit_status_list_get_entry (GgitStatusList *status_list,
+                            gsize           idx)
+{
+	GgitStatusEntry *entry;
+
+	g_return_val_if_fail (GGIT_IS_STATUS_LIST (status_list), NULL);
+	g_return_val_if_fail (idx < ggit_status_list_get_size (status_list), NULL);
+
+	entry = g_object_new (GGIT_TYPE_STATUS_ENTRY, NULL);
+	entry->list = g_object_ref (status_list);
+	entry->index = idx;
+
+	return entry;
+}
+
+/**
+ * ggit_status_entry_get_list:
+ * @entry: a #GgitStatusEntry.
+ *
+ * Get the #GgitStatusList containing @entry.
+ *
+ * Returns: (transfer none): a #GgitStatusList.
+ */
+GgitStatusList *
+ggit_status_entry_get_list (GgitStatusEntry *entry)
+{
+	g_return_val_if_fail (GGIT_IS_STATUS_ENTRY (entry), NULL);
+
+	return entry->list;
+}
+
+/**
+ * ggit_status_entry_get_index:
+ * @entry: a #GgitStatusEntry.
+ *
+ * Get the index of @entry in its #GgitStatusList.
+ *
+ * Returns: the index of @entry.
+ */
+gsize
+ggit_status_entry_get_index (GgitStatusEntry *entry)
+{
+	g_return_val_if_fail (GGIT_IS_STATUS_ENTRY (entry), 0);
+
+	return entry->index;
+}
+
+/**
+ * ggit_status_entry_get_status:
+ * @entry: a #GgitStatusEntry.
+ *
+ * See ggit_status_list_get_status().
+ *
+ * Returns: a #GgitStatusFlags.
+ */
+GgitStatusFlags
+ggit_status_entry_get_status (GgitStatusEntry *entry)
+{
+	g_return_val_if_fail (GGIT_IS_STATUS_ENTRY (entry), GGIT_STATUS_CURRENT);
+
+	return ggit_status_list_get_status (entry->list, entry->index);
+}
+
+/**
+ * ggit_status_entry_get_path:
+ * @entry: a #GgitStatusEntry.
+ *
+ * See ggit_status_list_get_path().
+ *
+ * Returns: (transfer none) (nullable): the path of the entry.
+ */
+const gchar *
+ggit_status_entry_get_path (GgitStatusEntry *entry)
+{
+	g_return_val_if_fail (GGIT_IS_STATUS_ENTRY (entry), NULL);
+
+	return ggit_status_list_get_path (entry->list, entry->index);
+}
+
+/**
+ * ggit_status_entry_get_renamed_from:
+ * @entry: a #GgitStatusEntry.
+ *
+ * See ggit_status_list_get_renamed_from().
+ *
+ * Returns: (transfer none) (nullable): the path before the rename or %NULL.
+ */
+const gchar *
+ggit_status_entry_get_renamed_from (GgitStatusEntry *entry)
+{
+	g_return_val_if_fail (GGIT_IS_STATUS_ENTRY (entry), NULL);
+
+	return ggit_status_list_get_renamed_from (entry->list, entry->index);
+}
+
+/**
+ * ggit_status_entry_get_head_to_index:
+ * @entry: a #GgitStatusEntry.
+ *
+ * See ggit_status_list_get_head_to_index().
+ *
+ * Returns: (transfer full) (nullable): a #GgitDiffDelta or %NULL.
+ */
+GgitDiffDelta *
+ggit_status_entry_get_head_to_index (GgitStatusEntry *entry)
+{
+	g_return_val_if_fail (GGIT_IS_STATUS_ENTRY (entry), NULL);
+
+	return ggit_status_list_get_head_to_index (entry->list, entry->index);
+}
+
+/**
+ * ggit_status_entry_get_index_to_workdir:
+ * @entry: a #GgitStatusEntry.
+ *
+ * See ggit_status_list_get_index_to_workdir().
+ *
+ * Returns: (transfer full) (nullable): a #GgitDiffDelta or %NULL.
+ */
+GgitDiffDelta *
+ggit_status_entry_get_index_to_workdir (GgitStatusEntry *entry)
+{
+	g_return_val_if_fail (GGIT_IS_STATUS_ENTRY (entry), NULL);
+
+	return ggit_status_list_get_index_to_workdir (entry->list, entry->index);
+}
+
+/* ex:set ts=8 noet: */
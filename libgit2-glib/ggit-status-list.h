@@ -0,0 +1,72 @@
+/*
+ * ggit-status-list.h
+ * This file is part of libgit2-glib
+ *
+ * Copyright (C) 2026 - The libgit2-glib authors
+ *
+ * libgit2-glib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libgit2-glib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GGIT_STATUS_LIST_H__
+#define __GGIT_STATUS_LIST_H__
+
+#include <glib-object.h>
+#include <gio/gio.h>
+#include <git2.h>
+
+#include "ggit-native.h"
+#include "ggit-types.h"
+
+G_BEGIN_DECLS
+
+#define GGIT_TYPE_STATUS_LIST (ggit_status_list_get_type ())
+G_DECLARE_FINAL_TYPE (GgitStatusList, ggit_status_list, GGIT, STATUS_LIST, GgitNative)
+
+#define GGIT_TYPE_STATUS_ENTRY (ggit_status_entry_get_type ())
+G_DECLARE_FINAL_TYPE (GgitStatusEntry, ggit_status_entry, GGIT, STATUS_ENTRY, GObject)
+
+GgitStatusList  *_ggit_status_list_wrap                    (git_status_list *status_list);
+
+gsize            ggit_status_list_get_size                 (GgitStatusList  *status_list);
+
+GgitStatusFlags  ggit_status_list_get_status               (GgitStatusList  *status_list,
+                                                            gsize            idx);
+const gchar     *ggit_status_list_get_path                 (GgitStatusList  *status_list,
+                                                            gsize            idx);
+const gchar     *ggit_status_list_get_renamed_from         (GgitStatusList  *status_list,
+                                                            gsize            idx);
+
+GgitDiffDelta   *ggit_status_list_get_head_to_index        (GgitStatusList  *status_list,
+                                                            gsize            idx);
+GgitDiffDelta   *ggit_status_list_get_index_to_workdir     (GgitStatusList  *status_list,
+                                                            gsize            idx);
+
+GgitStatusEntry *ggit_status_list_get_entry                (GgitStatusList  *status_list,
+                                                            gsize            idx);
+
+GgitStatusList  *ggit_status_entry_get_list                (GgitStatusEntry *entry);
+gsize            ggit_status_entry_get_index               (GgitStatusEntry *entry);
+
+GgitStatusFlags  ggit_status_entry_get_status              (GgitStatusEntry *entry);
+const gchar     *ggit_status_entry_get_path                (GgitStatusEntry *entry);
+const gchar     *ggit_status_entry_get_renamed_from        (GgitStatusEntry *entry);
+
+GgitDiffDelta   *ggit_status_entry_get_head_to_index       (GgitStatusEntry *entry);
+GgitDiffDelta   *ggit_status_entry_get_index_to_workdir    (GgitStatusEntry *entry);
+
+G_END_DECLS
+
+#endif /* __GGIT_STATUS_LIST_H__ */
+
+/* ex:set ts=8 noet: */
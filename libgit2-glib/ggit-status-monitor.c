@@ -0,0 +1,904 @@
+/*
+ * ggit-status-monitor.c
+ * This file is part of libgit2-glib
+ *
+ * Copyright (C) 2026 - The libgit2-glib authors
+ *
+ * libgit2-glib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libgit2-glib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <git2.h>
+#include <string.h>
+
+#include "ggit-status-monitor.h"
+#include "ggit-error.h"
+#include "ggit-status-list.h"
+
+/* Time to wait for more notifications before refreshing */
+#define REFRESH_LATENCY_MS 50
+
+/**
+ * GgitStatusMonitor:
+ *
+ * Keeps track of the status of the files in the working directory of a
+ * repository.
+ *
+ * The status of the whole working directory is computed once, when the
+ * monitor is created. Afterwards, the working directory is watched with
+ * #GFileMonitor and only the status of the paths reported as changed is
+ * computed again. Changes to the index, to HEAD or to the branch HEAD
+ * points to cause a full refresh.
+ *
+ * The monitor uses the thread-default main context of the thread which
+ * created it.
+ */
+struct _GgitStatusMonitor
+{
+	GObject parent_instance;
+
+	GgitRepository *repository;
+	GFile *workdir;
+	GMainContext *context;
+
+	/* path -> GgitStatusFlags, only for files which are not current */
+	GHashTable *status;
+
+	/* relative directory path -> GFileMonitor */
+	GHashTable *monitors;
+	GPtrArray *git_monitors;
+
+	/* The branch HEAD points to, followed when HEAD changes */
+	gchar *head_ref;
+	GFileMonitor *head_ref_monitor;
+
+	GHashTable *dirty;
+	gboolean full_refresh;
+	GSource *refresh_source;
+};
+
+enum
+{
+	PROP_0,
+	PROP_REPOSITORY
+};
+
+enum
+{
+	CHANGED,
+	NUM_SIGNALS
+};
+
+static guint signals[NUM_SIGNALS] = {0,};
+
+G_DEFINE_TYPE (GgitStatusMonitor, ggit_status_monitor, G_TYPE_OBJECT)
+
+static void
+free_monitor (GFileMonitor *monitor)
+{
+	/* A cancelled monitor does not emit any further events */
+	g_file_monitor_cancel (monitor);
+	g_object_unref (monitor);
+}
+
+static void
+cancel_refresh (GgitStatusMonitor *monitor)
+{
+	if (monitor->refresh_source != NULL)
+	{
+		g_source_destroy (monitor->refresh_source);
+		g_source_unref (monitor->refresh_source);
+		monitor->refresh_source = NULL;
+	}
+}
+
+static void
+ggit_status_monitor_dispose (GObject *object)
+{
+	GgitStatusMonitor *monitor = GGIT_STATUS_MONITOR (object);
+
+	cancel_refresh (monitor);
+
+	if (monitor->monitors != NULL)
+	{
+		g_hash_table_remove_all (monitor->monitors);
+	}
+
+	if (monitor->git_monitors != NULL)
+	{
+		g_ptr_array_set_size (monitor->git_monitors, 0);
+	}
+
+	if (monitor->head_ref_monitor != NULL)
+	{
+		free_monitor (monitor->head_ref_monitor);
+		monitor->head_ref_monitor = NULL;
+	}
+
+	G_OBJECT_CLASS (ggit_status_monitor_parent_class)->dispose (object);
+}
+
+static void
+ggit_status_monitor_finalize (GObject *object)
+{
+	GgitStatusMonitor *monitor = GGIT_STATUS_MONITOR (object);
+
+	g_hash_table_unref (monitor->status);
+	g_hash_table_unref (monitor->monitors);
+	g_hash_table_unref (monitor->dirty);
+	g_ptr_array_unref (monitor->git_monitors);
+	g_free (monitor->head_ref);
+
+	g_clear_object (&monitor->workdir);
+	g_clear_object (&monitor->repository);
+
+	g_main_context_unref (monitor->context);
+
+	G_OBJECT_CLASS (ggit_status_monitor_parent_class)->finalize (object);
+}
+
+static void
+ggit_status_monitor_get_property (GObject    *object,
+                                  guint       prop_id,
+                                  GValue     *value,
+                                  GParamSpec *pspec)
+{
+	GgitStatusMonitor *monitor = GGIT_STATUS_MONITOR (object);
+
+	switch (prop_id)
+	{
+		case PROP_REPOSITORY:
+			g_value_set_object (value, monitor->repository);
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+ggit_status_monitor_set_property (GObject      *object,
+                                  guint         prop_id,
+                                  const GValue *value,
+                                  GParamSpec   *pspec)
+{
+	GgitStatusMonitor *monitor = GGIT_STATUS_MONITOR (object);
+
+	switch (prop_id)
+	{
+		case PROP_REPOSITORY:
+			monitor->repository = g_value_dup_object (value);
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+ggit_status_monitor_class_init (GgitStatusMonitorClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->dispose = ggit_status_monitor_dispose;
+	object_class->finalize = ggit_status_monitor_finalize;
+	object_class->get_property = ggit_status_monitor_get_property;
+	object_class->set_property = ggit_status_monitor_set_property;
+
+	g_object_class_install_property (object_class,
+	                                 PROP_REPOSITORY,
+	                                 g_param_spec_object ("repository",
+	                                                      "Repository",
+	                                                      "The repository to monitor",
+	                                                      GGIT_TYPE_REPOSITORY,
+	                                                      G_PARAM_READWRITE |
+	                                                      G_PARAM_CONSTRUCT_ONLY |
+	                                                      G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * GgitStatusMonitor::changed:
+	 * @monitor: a #GgitStatusMonitor.
+	 * @paths: the paths of which the status changed.
+	 * @status_list: a #GgitStatusList with the new status of the
+	 *               refreshed paths.
+	 *
+	 * Emitted after a refresh when the status of some files changed.
+	 * Files which became current are part of @paths but have no entry
+	 * in @status_list.
+	 */
+	signals[CHANGED] =
+		g_signal_new ("changed",
+		              G_TYPE_FROM_CLASS (object_class),
+		              G_SIGNAL_RUN_LAST,
+		              0,
+		              NULL, NULL,
+		              NULL,
+		              G_TYPE_NONE,
+		              2,
+		              G_TYPE_STRV,
+		              GGIT_TYPE_STATUS_LIST);
+}
+
+static void
+ggit_status_monitor_init (GgitStatusMonitor *monitor)
+{
+	monitor->context = g_main_context_ref_thread_default ();
+
+	monitor->status = g_hash_table_new_full (g_str_hash,
+	                                         g_str_equal,
+	                                         g_free,
+	                                         NULL);
+
+	monitor->monitors = g_hash_table_new_full (g_str_hash,
+	                                           g_str_equal,
+	                                           g_free,
+	                                           (GDestroyNotify)free_monitor);
+
+	monitor->git_monitors = g_ptr_array_new_with_free_func ((GDestroyNotify)free_monitor);
+
+	monitor->dirty = g_hash_table_new_full (g_str_hash,
+	                                        g_str_equal,
+	                                        g_free,
+	                                        NULL);
+}
+
+static GgitStatusList *
+load_status (GgitStatusMonitor  *monitor,
+             gchar             **paths,
+             GError            **error)
+{
+	git_status_options options = GIT_STATUS_OPTIONS_INIT;
+	git_status_list *status_list;
+	gint ret;
+
+	options.show = GIT_STATUS_SHOW_INDEX_AND_WORKDIR;
+	options.flags = GIT_STATUS_OPT_INCLUDE_UNTRACKED |
+	                GIT_STATUS_OPT_RECURSE_UNTRACKED_DIRS;
+
+	/* Literal paths restrict the scan of the working directory to the
+	 * given files and directories.
+	 */
+	if (paths != NULL)
+	{
+		options.flags |= GIT_STATUS_OPT_DISABLE_PATHSPEC_MATCH;
+		options.pathspec.strings = paths;
+		options.pathspec.count = g_strv_length (paths);
+	}
+
+	ret = git_status_list_new (&status_list,
+	                           _ggit_native_get (monitor->repository),
+	                           &options);
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		return NULL;
+	}
+
+	return _ggit_status_list_wrap (status_list);
+}
+
+static void
+schedule_refresh (GgitStatusMonitor *monitor);
+
+static void
+mark_dirty (GgitStatusMonitor *monitor,
+            GFile             *file)
+{
+	gchar *path;
+
+	path = g_file_get_relative_path (monitor->workdir, file);
+
+	if (path == NULL)
+	{
+		return;
+	}
+
+	if (strcmp (path, ".git") == 0 || g_str_has_prefix (path, ".git/"))
+	{
+		g_free (path);
+		return;
+	}
+
+	g_hash_table_add (monitor->dirty, path);
+	schedule_refresh (monitor);
+}
+
+static void
+watch_directory (GgitStatusMonitor *monitor,
+                 GFile             *dir,
+                 const gchar       *path);
+
+static void
+unwatch_directory (GgitStatusMonitor *monitor,
+                   const gchar       *path)
+{
+	GHashTableIter iter;
+	gpointer key;
+	gsize len;
+
+	len = strlen (path);
+
+	g_hash_table_iter_init (&iter, monitor->monitors);
+
+	while (g_hash_table_iter_next (&iter, &key, NULL))
+	{
+		const gchar *dir = key;
+
+		if (strncmp (dir, path, len) == 0 &&
+		    (dir[len] == '\0' || dir[len] == '/'))
+		{
+			g_hash_table_iter_remove (&iter);
+		}
+	}
+}
+
+static void
+on_directory_changed (GFileMonitor      *file_monitor,
+                      GFile             *file,
+                      GFile             *other_file,
+                      GFileMonitorEvent  event,
+                      GgitStatusMonitor *monitor)
+{
+	if (event == G_FILE_MONITOR_EVENT_PRE_UNMOUNT ||
+	    event == G_FILE_MONITOR_EVENT_UNMOUNTED)
+	{
+		return;
+	}
+
+	mark_dirty (monitor, file);
+
+	if (other_file != NULL)
+	{
+		mark_dirty (monitor, other_file);
+	}
+
+	if (event == G_FILE_MONITOR_EVENT_CREATED &&
+	    g_file_query_file_type (file, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, NULL) == G_FILE_TYPE_DIRECTORY)
+	{
+		gchar *path;
+
+		path = g_file_get_relative_path (monitor->workdir, file);
+
+		if (path != NULL)
+		{
+			watch_directory (monitor, file, path);
+			g_free (path);
+		}
+	}
+	else if (event == G_FILE_MONITOR_EVENT_DELETED)
+	{
+		gchar *path;
+
+		path = g_file_get_relative_path (monitor->workdir, file);
+
+		if (path != NULL)
+		{
+			unwatch_directory (monitor, path);
+			g_free (path);
+		}
+	}
+}
+
+static void
+watch_head_ref (GgitStatusMonitor *monitor);
+
+static void
+on_git_file_changed (GFileMonitor      *file_monitor,
+                     GFile             *file,
+                     GFile             *other_file,
+                     GFileMonitorEvent  event,
+                     GgitStatusMonitor *monitor)
+{
+	/* HEAD may have moved to another branch */
+	watch_head_ref (monitor);
+
+	monitor->full_refresh = TRUE;
+	schedule_refresh (monitor);
+}
+
+static void
+watch_directory (GgitStatusMonitor *monitor,
+                 GFile             *dir,
+                 const gchar       *path)
+{
+	GFileMonitor *file_monitor;
+	GFileEnumerator *enumerator;
+	GFileInfo *info;
+
+	if (g_hash_table_contains (monitor->monitors, path))
+	{
+		return;
+	}
+
+	/* Nothing in ignored directories can change the status */
+	if (*path != '\0')
+	{
+		gchar *dir_path;
+		gint ignored = 0;
+
+		dir_path = g_strconcat (path, "/", NULL);
+		git_ignore_path_is_ignored (&ignored,
+		                            _ggit_native_get (monitor->repository),
+		                            dir_path);
+		g_free (dir_path);
+
+		if (ignored)
+		{
+			return;
+		}
+	}
+
+	/* Monitoring is best effort, for instance when running out of
+	 * inotify watches. ggit_status_monitor_mark_dirty() can still be
+	 * used for the directories which could not be monitored.
+	 */
+	file_monitor = g_file_monitor_directory (dir, G_FILE_MONITOR_NONE, NULL, NULL);
+
+	if (file_monitor == NULL)
+	{
+		return;
+	}
+
+	g_signal_connect (file_monitor,
+	                  "changed",
+	                  G_CALLBACK (on_directory_changed),
+	                  monitor);
+
+	g_hash_table_insert (monitor->monitors, g_strdup (path), file_monitor);
+
+	enumerator = g_file_enumerate_children (dir,
+	                                        G_FILE_ATTRIBUTE_STANDARD_NAME ","
+	                                        G_FILE_ATTRIBUTE_STANDARD_TYPE,
+	                                        G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+	                                        NULL,
+	                                        NULL);
+
+	if (enumerator == NULL)
+	{
+		return;
+	}
+
+	while ((info = g_file_enumerator_next_file (enumerator, NULL, NULL)) != NULL)
+	{
+		const gchar *name;
+
+		name = g_file_info_get_name (info);
+
+		if (g_file_info_get_file_type (info) == G_FILE_TYPE_DIRECTORY &&
+		    !(*path == '\0' && strcmp (name, ".git") == 0))
+		{
+			GFile *child;
+			gchar *child_path;
+
+			child = g_file_get_child (dir, name);
+			child_path = *path == '\0' ? g_strdup (name) : g_strconcat (path, "/", name, NULL);
+
+			watch_directory (monitor, child, child_path);
+
+			g_free (child_path);
+			g_object_unref (child);
+		}
+
+		g_object_unref (info);
+	}
+
+	g_object_unref (enumerator);
+}
+
+static void
+watch_git_file (GgitStatusMonitor *monitor,
+                const gchar       *name)
+{
+	GFile *location;
+	GFile *file;
+	GFileMonitor *file_monitor;
+
+	location = ggit_repository_get_location (monitor->repository);
+	file = g_file_get_child (location, name);
+	g_object_unref (location);
+
+	file_monitor = g_file_monitor_file (file, G_FILE_MONITOR_NONE, NULL, NULL);
+	g_object_unref (file);
+
+	if (file_monitor == NULL)
+	{
+		return;
+	}
+
+	g_signal_connect (file_monitor,
+	                  "changed",
+	                  G_CALLBACK (on_git_file_changed),
+	                  monitor);
+
+	g_ptr_array_add (monitor->git_monitors, file_monitor);
+}
+
+/* A commit only updates the branch HEAD points to, so watch that ref as
+ * well and follow HEAD when it is moved to another branch.
+ */
+static void
+watch_head_ref (GgitStatusMonitor *monitor)
+{
+	git_reference *head;
+	const gchar *target = NULL;
+	GFile *location;
+	GFile *file;
+
+	if (git_reference_lookup (&head,
+	                          _ggit_native_get (monitor->repository),
+	                          "HEAD") != GIT_OK)
+	{
+		head = NULL;
+	}
+
+	if (head != NULL && git_reference_type (head) == GIT_REF_SYMBOLIC)
+	{
+		target = git_reference_symbolic_target (head);
+	}
+
+	if (g_strcmp0 (target, monitor->head_ref) == 0)
+	{
+		git_reference_free (head);
+		return;
+	}
+
+	if (monitor->head_ref_monitor != NULL)
+	{
+		free_monitor (monitor->head_ref_monitor);
+		monitor->head_ref_monitor = NULL;
+	}
+
+	g_free (monitor->head_ref);
+	monitor->head_ref = g_strdup (target);
+
+	git_reference_free (head);
+
+	/* A detached HEAD is covered by watching HEAD itself */
+	if (monitor->head_ref == NULL)
+	{
+		return;
+	}
+
+	/* The ref of an unborn branch does not exist yet, which is fine
+	 * for a file monitor.
+	 */
+	location = ggit_repository_get_location (monitor->repository);
+	file = g_file_resolve_relative_path (location, monitor->head_ref);
+	g_object_unref (location);
+
+	monitor->head_ref_monitor = g_file_monitor_file (file, G_FILE_MONITOR_NONE, NULL, NULL);
+	g_object_unref (file);
+
+	if (monitor->head_ref_monitor != NULL)
+	{
+		g_signal_connect (monitor->head_ref_monitor,
+		                  "changed",
+		                  G_CALLBACK (on_git_file_changed),
+		                  monitor);
+	}
+}
+
+static gboolean
+refresh_timeout_cb (gpointer user_data)
+{
+	GgitStatusMonitor *monitor = user_data;
+	GError *error = NULL;
+
+	g_source_unref (monitor->refresh_source);
+	monitor->refresh_source = NULL;
+
+	if (!ggit_status_monitor_refresh (monitor, &error))
+	{
+		g_warning ("Failed to refresh the status: %s", error->message);
+		g_error_free (error);
+	}
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_refresh (GgitStatusMonitor *monitor)
+{
+	if (monitor->refresh_source != NULL)
+	{
+		return;
+	}
+
+	monitor->refresh_source = g_timeout_source_new (REFRESH_LATENCY_MS);
+	g_source_set_callback (monitor->refresh_source, refresh_timeout_cb, monitor, NULL);
+	g_source_attach (monitor->refresh_source, monitor->context);
+}
+
+/**
+ * ggit_status_monitor_new:
+ * @repository: a non-bare #GgitRepository.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Create a new status monitor for the working directory of @repository.
+ * This computes the status of all the files once and starts watching the
+ * working directory for changes.
+ *
+ * Returns: (transfer full) (nullable): a #GgitStatusMonitor or %NULL in
+ *          case of an error.
+ */
+GgitStatusMonitor *
+ggit_status_monitor_new (GgitRepository  *repository,
+                         GError         **error)
+{
+	GgitStatusMonitor *monitor;
+	GgitStatusList *status_list;
+	gsize i;
+
+	g_return_val_if_fail (GGIT_IS_REPOSITORY (repository), NULL);
+	g_return_val_if_fail (!ggit_repository_is_bare (repository), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	monitor = g_object_new (GGIT_TYPE_STATUS_MONITOR,
+	                        "repository", repository,
+	                        NULL);
+
+	monitor->workdir = ggit_repository_get_workdir (repository);
+
+	status_list = load_status (monitor, NULL, error);
+
+	if (status_list == NULL)
+	{
+		g_object_unref (monitor);
+		return NULL;
+	}
+
+	for (i = 0; i < ggit_status_list_get_size (status_list); ++i)
+	{
+		g_hash_table_insert (monitor->status,
+		                     g_strdup (ggit_status_list_get_path (status_list, i)),
+		                     GUINT_TO_POINTER (ggit_status_list_get_status (status_list, i)));
+	}
+
+	g_object_unref (status_list);
+
+	watch_directory (monitor, monitor->workdir, "");
+	watch_git_file (monitor, "index");
+	watch_git_file (monitor, "HEAD");
+	watch_git_file (monitor, "packed-refs");
+	watch_head_ref (monitor);
+
+	return monitor;
+}
+
+/**
+ * ggit_status_monitor_get_repository:
+ * @monitor: a #GgitStatusMonitor.
+ *
+ * Get the repository monitored by @monitor.
+ *
+ * Returns: (transfer none): a #GgitRepository.
+ */
+GgitRepository *
+ggit_status_monitor_get_repository (GgitStatusMonitor *monitor)
+{
+	g_return_val_if_fail (GGIT_IS_STATUS_MONITOR (monitor), NULL);
+
+	return monitor->repository;
+}
+
+/**
+ * ggit_status_monitor_get_status:
+ * @monitor: a #GgitStatusMonitor.
+ * @path: the path of a file, relative to the working directory.
+ *
+ * Get the last known status of @path. This does not access the file system.
+ *
+ * Returns: the #GgitStatusFlags of @path.
+ */
+GgitStatusFlags
+ggit_status_monitor_get_status (GgitStatusMonitor *monitor,
+                                const gchar       *path)
+{
+	g_return_val_if_fail (GGIT_IS_STATUS_MONITOR (monitor), GGIT_STATUS_CURRENT);
+	g_return_val_if_fail (path != NULL, GGIT_STATUS_CURRENT);
+
+	return GPOINTER_TO_UINT (g_hash_table_lookup (monitor->status, path));
+}
+
+/**
+ * ggit_status_monitor_mark_dirty:
+ * @monitor: a #GgitStatusMonitor.
+ * @path: the path of a file or directory, relative to the working directory.
+ *
+ * Mark @path as possibly changed, so that its status is computed again on
+ * the next refresh. This is done automatically for the changes reported by
+ * the file monitors, but can be used when the caller knows about changes
+ * before they are reported.
+ */
+void
+ggit_status_monitor_mark_dirty (GgitStatusMonitor *monitor,
+                                const gchar       *path)
+{
+	g_return_if_fail (GGIT_IS_STATUS_MONITOR (monitor));
+	g_return_if_fail (path != NULL);
+
+	g_hash_table_add (monitor->dirty, g_strdup (path));
+	schedule_refresh (monitor);
+}
+
+/* Move the entries of @path, or of the files below @path if it is a
+ * directory, from the status table to @old.
+ */
+static void
+take_status (GgitStatusMonitor *monitor,
+             const gchar       *path,
+             GHashTable        *old)
+{
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	gsize len;
+
+	if (g_hash_table_lookup_extended (monitor->status, path, &key, &value))
+	{
+		g_hash_table_steal (monitor->status, key);
+		g_hash_table_insert (old, key, value);
+		return;
+	}
+
+	/* The table only contains files which are not current, so it is
+	 * usually small.
+	 */
+	len = strlen (path);
+	g_hash_table_iter_init (&iter, monitor->status);
+
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		const gchar *p = key;
+
+		if (strncmp (p, path, len) == 0 && p[len] == '/')
+		{
+			g_hash_table_iter_steal (&iter);
+			g_hash_table_insert (old, key, value);
+		}
+	}
+}
+
+/**
+ * ggit_status_monitor_refresh:
+ * @monitor: a #GgitStatusMonitor.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Compute the status of the paths which changed since the last refresh
+ * right away, instead of waiting for the monitor to do so. The
+ * #GgitStatusMonitor::changed signal is emitted if the status of any file
+ * changed.
+ *
+ * Returns: %TRUE if the status was refreshed, %FALSE if there was an error.
+ */
+gboolean
+ggit_status_monitor_refresh (GgitStatusMonitor  *monitor,
+                             GError            **error)
+{
+	GgitStatusList *status_list;
+	GHashTable *old;
+	GHashTableIter iter;
+	GPtrArray *changed;
+	gchar **paths = NULL;
+	gpointer key;
+	gsize i;
+
+	g_return_val_if_fail (GGIT_IS_STATUS_MONITOR (monitor), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	cancel_refresh (monitor);
+
+	if (!monitor->full_refresh && g_hash_table_size (monitor->dirty) == 0)
+	{
+		return TRUE;
+	}
+
+	if (!monitor->full_refresh)
+	{
+		paths = g_new (gchar *, g_hash_table_size (monitor->dirty) + 1);
+		i = 0;
+
+		g_hash_table_iter_init (&iter, monitor->dirty);
+
+		while (g_hash_table_iter_next (&iter, &key, NULL))
+		{
+			paths[i++] = key;
+		}
+
+		paths[i] = NULL;
+	}
+
+	status_list = load_status (monitor, paths, error);
+
+	if (status_list == NULL)
+	{
+		g_free (paths);
+		return FALSE;
+	}
+
+	old = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+	if (paths == NULL)
+	{
+		g_hash_table_unref (old);
+		old = monitor->status;
+
+		monitor->status = g_hash_table_new_full (g_str_hash,
+		                                         g_str_equal,
+		                                         g_free,
+		                                         NULL);
+	}
+	else
+	{
+		for (i = 0; paths[i] != NULL; ++i)
+		{
+			take_status (monitor, paths[i], old);
+		}
+
+		/* The strings are owned by the dirty table */
+		g_free (paths);
+	}
+
+	monitor->full_refresh = FALSE;
+	g_hash_table_remove_all (monitor->dirty);
+
+	changed = g_ptr_array_new_with_free_func (g_free);
+
+	for (i = 0; i < ggit_status_list_get_size (status_list); ++i)
+	{
+		const gchar *path;
+		GgitStatusFlags flags;
+		gpointer old_flags;
+
+		path = ggit_status_list_get_path (status_list, i);
+		flags = ggit_status_list_get_status (status_list, i);
+
+		if (!g_hash_table_lookup_extended (old, path, NULL, &old_flags) ||
+		    GPOINTER_TO_UINT (old_flags) != flags)
+		{
+			g_ptr_array_add (changed, g_strdup (path));
+		}
+
+		g_hash_table_remove (old, path);
+		g_hash_table_insert (monitor->status, g_strdup (path), GUINT_TO_POINTER (flags));
+	}
+
+	/* Whatever is left became current */
+	g_hash_table_iter_init (&iter, old);
+
+	while (g_hash_table_iter_next (&iter, &key, NULL))
+	{
+		g_ptr_array_add (changed, g_strdup (key));
+	}
+
+	g_hash_table_unref (old);
+
+	if (changed->len > 0)
+	{
+		g_ptr_array_add (changed, NULL);
+
+		g_signal_emit (monitor,
+		               signals[CHANGED],
+		               0,
+		               (gchar **)changed->pdata,
+		               status_list);
+	}
+
+	g_ptr_array_unref (changed);
+	g_object_unref (status_list);
+
+	return TRUE;
+}
+
+/* ex:set ts=8 noet: */
@@ -0,0 +1,486 @@
+/*
+ * ggit-tree-iterator.c
+ * This file is part of libgit2-glib
+ *
+ * Copyright (C) 2026 - The libgit2-glib authors
+ *
+ * libgit2-glib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libgit2-glib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ggit-tree-iterator.h"
+#include "ggit-tree-entry.h"
+#include "ggit-error.h"
+#include "ggit-oid.h"
+#include <git2.h>
+
+typedef struct
+{
+	git_tree *tree;
+	gboolean owned;
+
+	gsize idx;
+	gsize root_len;
+
+	/* post-order: the subtree at idx has been visited */
+	gboolean visited;
+} Frame;
+
+struct _GgitTreeIterator
+{
+	GgitTree *tree;
+	GgitTreeWalkMode mode;
+
+	GArray *stack;
+	GString *root;
+
+	const git_tree_entry *current;
+	gboolean descend;
+	gboolean done;
+
+	gint ref_count;
+};
+
+G_DEFINE_BOXED_TYPE (GgitTreeIterator, ggit_tree_iterator, ggit_tree_iterator_ref, ggit_tree_iterator_unref)
+
+static Frame *
+top_frame (GgitTreeIterator *iter)
+{
+	return &g_array_index (iter->stack, Frame, iter->stack->len - 1);
+}
+
+static gboolean
+push_frame (GgitTreeIterator      *iter,
+            const git_tree_entry  *entry,
+            GError               **error)
+{
+	Frame frame = { 0, };
+	gint ret;
+
+	ret = git_tree_lookup (&frame.tree,
+	                       git_tree_owner (top_frame (iter)->tree),
+	                       git_tree_entry_id (entry));
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		return FALSE;
+	}
+
+	g_string_append (iter->root, git_tree_entry_name (entry));
+	g_string_append_c (iter->root, '/');
+
+	frame.owned = TRUE;
+	frame.root_len = iter->root->len;
+
+	g_array_append_val (iter->stack, frame);
+	return TRUE;
+}
+
+static void
+pop_frame (GgitTreeIterator *iter)
+{
+	Frame *frame = top_frame (iter);
+
+	if (frame->owned)
+	{
+		git_tree_free (frame->tree);
+	}
+
+	g_array_set_size (iter->stack, iter->stack->len - 1);
+
+	if (iter->stack->len > 0)
+	{
+		g_string_truncate (iter->root, top_frame (iter)->root_len);
+	}
+}
+
+/**
+ * ggit_tree_iterator_new:
+ * @tree: a #GgitTree.
+ * @mode: the walking order.
+ *
+ * Create an iterator over all the entries of @tree, recursing into
+ * subtrees. Unlike ggit_tree_walk(), entries are produced on demand by
+ * ggit_tree_iterator_next() and subtrees are only loaded when the iterator
+ * enters them.
+ *
+ * Returns: (transfer full): a #GgitTreeIterator.
+ *
+ **/
+GgitTreeIterator *
+ggit_tree_iterator_new (GgitTree         *tree,
+                        GgitTreeWalkMode  mode)
+{
+	GgitTreeIterator *iter;
+	Frame frame = { 0, };
+
+	g_return_val_if_fail (GGIT_IS_TREE (tree), NULL);
+
+	iter = g_slice_new0 (GgitTreeIterator);
+	iter->ref_count = 1;
+	iter->tree = g_object_ref (tree);
+	iter->mode = mode;
+	iter->stack = g_array_new (FALSE, FALSE, sizeof (Frame));
+	iter->root = g_string_new (NULL);
+
+	frame.tree = _ggit_native_get (tree);
+	g_array_append_val (iter->stack, frame);
+
+	return iter;
+}
+
+/**
+ * ggit_tree_iterator_ref:
+ * @iter: a #GgitTreeIterator.
+ *
+ * Atomically increments the reference count of @iter by one.
+ * This function is MT-safe and may be called from any thread.
+ *
+ * Returns: (transfer none) (nullable): a #GgitTreeIterator or %NULL.
+ *
+ **/
+GgitTreeIterator *
+ggit_tree_iterator_ref (GgitTreeIterator *iter)
+{
+	g_return_val_if_fail (iter != NULL, NULL);
+
+	g_atomic_int_inc (&iter->ref_count);
+	return iter;
+}
+
+/**
+ * ggit_tree_iterator_unref:
+ * @iter: a #GgitTreeIterator.
+ *
+ * Atomically decrements the reference count of @iter by one.
+ * If the reference count drops to 0, @iter is freed.
+ *
+ **/
+void
+ggit_tree_iterator_unref (GgitTreeIterator *iter)
+{
+	g_return_if_fail (iter != NULL);
+
+	if (g_atomic_int_dec_and_test (&iter->ref_count))
+	{
+		while (iter->stack->len > 0)
+		{
+			pop_frame (iter);
+		}
+
+		g_array_unref (iter->stack);
+		g_string_free (iter->root, TRUE);
+		g_object_unref (iter->tree);
+
+		g_slice_free (GgitTreeIterator, iter);
+	}
+}
+
+static gboolean
+next_pre_order (GgitTreeIterator  *iter,
+                GError           **error)
+{
+	if (iter->current != NULL && iter->descend)
+	{
+		if (!push_frame (iter, iter->current, error))
+		{
+			return FALSE;
+		}
+	}
+
+	iter->current = NULL;
+	iter->descend = FALSE;
+
+	while (iter->stack->len > 0)
+	{
+		Frame *frame = top_frame (iter);
+
+		if (frame->idx < git_tree_entrycount (frame->tree))
+		{
+			iter->current = git_tree_entry_byindex (frame->tree, frame->idx++);
+			iter->descend = git_tree_entry_type (iter->current) == GIT_OBJ_TREE;
+
+			return TRUE;
+		}
+
+		pop_frame (iter);
+	}
+
+	return FALSE;
+}
+
+static gboolean
+next_post_order (GgitTreeIterator  *iter,
+                 GError           **error)
+{
+	iter->current = NULL;
+
+	while (iter->stack->len > 0)
+	{
+		Frame *frame = top_frame (iter);
+		const git_tree_entry *entry;
+
+		if (frame->idx >= git_tree_entrycount (frame->tree))
+		{
+			pop_frame (iter);
+
+			if (iter->stack->len > 0)
+			{
+				top_frame (iter)->visited = TRUE;
+			}
+
+			continue;
+		}
+
+		entry = git_tree_entry_byindex (frame->tree, frame->idx);
+
+		if (git_tree_entry_type (entry) == GIT_OBJ_TREE && !frame->visited)
+		{
+			if (!push_frame (iter, entry, error))
+			{
+				return FALSE;
+			}
+
+			continue;
+		}
+
+		frame->visited = FALSE;
+		frame->idx++;
+
+		iter->current = entry;
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+/**
+ * ggit_tree_iterator_next:
+ * @iter: a #GgitTreeIterator.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Move @iter to the next entry. The entry can then be inspected with the
+ * ggit_tree_iterator_get_*() functions.
+ *
+ * Returns: %TRUE if there is a next entry, %FALSE when the iteration is
+ *          finished or when a subtree could not be loaded, in which case
+ *          @error is set.
+ *
+ **/
+gboolean
+ggit_tree_iterator_next (GgitTreeIterator  *iter,
+                         GError           **error)
+{
+	gboolean ret;
+
+	g_return_val_if_fail (iter != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	if (iter->done)
+	{
+		return FALSE;
+	}
+
+	if (iter->mode == GGIT_TREE_WALK_MODE_POST)
+	{
+		ret = next_post_order (iter, error);
+	}
+	else
+	{
+		ret = next_pre_order (iter, error);
+	}
+
+	if (!ret)
+	{
+		iter->current = NULL;
+		iter->done = TRUE;
+	}
+
+	return ret;
+}
+
+/**
+ * ggit_tree_iterator_skip_subtree:
+ * @iter: a #GgitTreeIterator.
+ *
+ * When iterating in pre-order and the current entry is a tree, do not
+ * descend into it. The subtree is never loaded. This has no effect when
+ * iterating in post-order, since subtrees are visited before their entry.
+ *
+ **/
+void
+ggit_tree_iterator_skip_subtree (GgitTreeIterator *iter)
+{
+	g_return_if_fail (iter != NULL);
+
+	iter->descend = FALSE;
+}
+
+/**
+ * ggit_tree_iterator_get_root:
+ * @iter: a #GgitTreeIterator.
+ *
+ * Get the path of the tree containing the current entry, relative to the
+ * iterated tree. The path is empty for toplevel entries and ends with a
+ * '/' otherwise, as for ggit_tree_walk(). The returned string is only
+ * valid until the next call to ggit_tree_iterator_next().
+ *
+ * Returns: the root of the current entry.
+ *
+ **/
+const gchar *
+ggit_tree_iterator_get_root (GgitTreeIterator *iter)
+{
+	g_return_val_if_fail (iter != NULL, NULL);
+
+	return iter->root->str;
+}
+
+/**
+ * ggit_tree_iterator_get_depth:
+ * @iter: a #GgitTreeIterator.
+ *
+ * Get the depth of the current entry, 0 for toplevel entries.
+ *
+ * Returns: the depth of the current entry.
+ *
+ **/
+guint
+ggit_tree_iterator_get_depth (GgitTreeIterator *iter)
+{
+	g_return_val_if_fail (iter != NULL, 0);
+
+	return iter->stack->len > 0 ? iter->stack->len - 1 : 0;
+}
+
+/**
+ * ggit_tree_iterator_get_name:
+ * @iter: a #GgitTreeIterator.
+ *
+ * Get the name of the current entry. The returned string is owned by the
+ * tree and is only valid until the next call to ggit_tree_iterator_next().
+ *
+ * Returns: (nullable): the name of the current entry, or %NULL.
+ *
+ **/
+const gchar *
+ggit_tree_iterator_get_name (GgitTreeIterator *iter)
+{
+	g_return_val_if_fail (iter != NULL, NULL);
+
+	if (iter->current == NULL)
+	{
+		return NULL;
+	}
+
+	return git_tree_entry_name (iter->current);
+}
+
+/**
+ * ggit_tree_iterator_get_file_mode:
+ * @iter: a #GgitTreeIterator.
+ *
+ * Get the file mode of the current entry.
+ *
+ * Returns: the #GgitFileMode of the current entry.
+ *
+ **/
+GgitFileMode
+ggit_tree_iterator_get_file_mode (GgitTreeIterator *iter)
+{
+	g_return_val_if_fail (iter != NULL, GGIT_FILE_MODE_UNREADABLE);
+
+	if (iter->current == NULL)
+	{
+		return GGIT_FILE_MODE_UNREADABLE;
+	}
+
+	return (GgitFileMode)git_tree_entry_filemode (iter->current);
+}
+
+/**
+ * ggit_tree_iterator_get_raw_id:
+ * @iter: a #GgitTreeIterator.
+ *
+ * Get the raw id of the current entry, without allocating a #GgitOId. The
+ * returned buffer is owned by the tree and is only valid until the next
+ * call to ggit_tree_iterator_next().
+ *
+ * Returns: (array fixed-size=20) (nullable): the raw id of the current
+ *          entry, or %NULL.
+ *
+ **/
+const guchar *
+ggit_tree_iterator_get_raw_id (GgitTreeIterator *iter)
+{
+	g_return_val_if_fail (iter != NULL, NULL);
+
+	if (iter->current == NULL)
+	{
+		return NULL;
+	}
+
+	return git_tree_entry_id (iter->current)->id;
+}
+
+/**
+ * ggit_tree_iterator_get_id:
+ * @iter: a #GgitTreeIterator.
+ *
+ * Get the id of the current entry.
+ *
+ * Returns: (transfer full) (nullable): the #GgitOId of the current entry,
+ *          or %NULL.
+ *
+ **/
+GgitOId *
+ggit_tree_iterator_get_id (GgitTreeIterator *iter)
+{
+	g_return_val_if_fail (iter != NULL, NULL);
+
+	if (iter->current == NULL)
+	{
+		return NULL;
+	}
+
+	return _ggit_oid_wrap (git_tree_entry_id (iter->current));
+}
+
+/**
+ * ggit_tree_iterator_get_entry:
+ * @iter: a #GgitTreeIterator.
+ *
+ * Get a copy of the current entry, which remains valid after the iterator
+ * moves on.
+ *
+ * Returns: (transfer full) (nullable): the current #GgitTreeEntry, or %NULL.
+ *
+ **/
+GgitTreeEntry *
+ggit_tree_iterator_get_entry (GgitTreeIterator *iter)
+{
+	git_tree_entry *entry;
+
+	g_return_val_if_fail (iter != NULL, NULL);
+
+	if (iter->current == NULL ||
+	    git_tree_entry_dup (&entry, iter->current) != GIT_OK)
+	{
+		return NULL;
+	}
+
+	return _ggit_tree_entry_wrap (entry, TRUE);
+}
+
+/* ex:set ts=8 noet: */
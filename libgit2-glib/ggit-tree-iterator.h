@@ -0,0 +1,63 @@
+/*
+ * ggit-tree-iterator.h
+ * This file is part of libgit2-glib
+ *
+ * Copyright (C) 2026 - The libgit2-glib authors
+ *
+ * libgit2-glib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libgit2-glib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GGIT_TREE_ITERATOR_H__
+#define __GGIT_TREE_ITERATOR_H__
+
+#include <git2.h>
+#include <glib-object.h>
+#include <libgit2-glib/ggit-types.h>
+#include <libgit2-glib/ggit-tree.h>
+
+G_BEGIN_DECLS
+
+#define GGIT_TYPE_TREE_ITERATOR       (ggit_tree_iterator_get_type ())
+#define GGIT_TREE_ITERATOR(obj)       ((GgitTreeIterator *)obj)
+
+GType             ggit_tree_iterator_get_type      (void) G_GNUC_CONST;
+
+GgitTreeIterator *ggit_tree_iterator_new           (GgitTree          *tree,
+                                                    GgitTreeWalkMode   mode);
+
+GgitTreeIterator *ggit_tree_iterator_ref           (GgitTreeIterator  *iter);
+void              ggit_tree_iterator_unref         (GgitTreeIterator  *iter);
+
+gboolean          ggit_tree_iterator_next          (GgitTreeIterator  *iter,
+                                                    GError           **error);
+
+void              ggit_tree_iterator_skip_subtree  (GgitTreeIterator  *iter);
+
+const gchar      *ggit_tree_iterator_get_root      (GgitTreeIterator  *iter);
+guint             ggit_tree_iterator_get_depth     (GgitTreeIterator  *iter);
+
+const gchar      *ggit_tree_iterator_get_name      (GgitTreeIterator  *iter);
+GgitFileMode      ggit_tree_iterator_get_file_mode (GgitTreeIterator  *iter);
+const guchar     *ggit_tree_iterator_get_raw_id    (GgitTreeIterator  *iter);
+GgitOId          *ggit_tree_iterator_get_id        (GgitTreeIterator  *iter);
+
+GgitTreeEntry    *ggit_tree_iterator_get_entry     (GgitTreeIterator  *iter);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GgitTreeIterator, ggit_tree_iterator_unref)
+
+G_END_DECLS
+
+#endif /* __GGIT_TREE_ITERATOR_H__ */
+
+/* ex:set ts=8 noet: */
@@ -0,0 +1,180 @@
+/*
+ * ggit-tree-updates.c
+ * This file is part of libgit2-glib
+ *
+ * Copyright (C) 2026 - The libgit2-glib authors
+ *
+ * libgit2-glib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libgit2-glib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ggit-tree-updates.h"
+#include "ggit-oid.h"
+#include <git2.h>
+
+struct _GgitTreeUpdates
+{
+	GArray *updates;
+	gint ref_count;
+};
+
+G_DEFINE_BOXED_TYPE (GgitTreeUpdates, ggit_tree_updates, ggit_tree_updates_ref, ggit_tree_updates_unref)
+
+/**
+ * ggit_tree_updates_new:
+ *
+ * Create a new, empty list of tree updates. Updates are applied to a tree
+ * with ggit_tree_create_updated().
+ *
+ * Returns: (transfer full): a #GgitTreeUpdates.
+ *
+ **/
+GgitTreeUpdates *
+ggit_tree_updates_new (void)
+{
+	GgitTreeUpdates *ret;
+
+	ret = g_slice_new (GgitTreeUpdates);
+	ret->updates = g_array_new (FALSE, FALSE, sizeof (git_tree_update));
+	ret->ref_count = 1;
+
+	return ret;
+}
+
+/**
+ * ggit_tree_updates_ref:
+ * @updates: a #GgitTreeUpdates.
+ *
+ * Atomically increments the reference count of @updates by one.
+ * This function is MT-safe and may be called from any thread.
+ *
+ * Returns: (transfer none) (nullable): a #GgitTreeUpdates or %NULL.
+ *
+ **/
+GgitTreeUpdates *
+ggit_tree_updates_ref (GgitTreeUpdates *updates)
+{
+	g_return_val_if_fail (updates != NULL, NULL);
+
+	g_atomic_int_inc (&updates->ref_count);
+	return updates;
+}
+
+/**
+ * ggit_tree_updates_unref:
+ * @updates: a #GgitTreeUpdates.
+ *
+ * Atomically decrements the reference count of @updates by one.
+ * If the reference count drops to 0, @updates is freed.
+ *
+ **/
+void
+ggit_tree_updates_unref (GgitTreeUpdates *updates)
+{
+	g_return_if_fail (updates != NULL);
+
+	if (g_atomic_int_dec_and_test (&updates->ref_count))
+	{
+		guint i;
+
+		for (i = 0; i < updates->updates->len; ++i)
+		{
+			g_free ((gchar *)g_array_index (updates->updates, git_tree_update, i).path);
+		}
+
+		g_array_unref (updates->updates);
+		g_slice_free (GgitTreeUpdates, updates);
+	}
+}
+
+/**
+ * ggit_tree_updates_upsert:
+ * @updates: a #GgitTreeUpdates.
+ * @path: the full path of the entry, relative to the root of the tree.
+ * @id: the id of the object the entry points to.
+ * @file_mode: the #GgitFileMode of the entry.
+ *
+ * Add or replace the entry at @path. Missing intermediate trees are
+ * created.
+ *
+ **/
+void
+ggit_tree_updates_upsert (GgitTreeUpdates *updates,
+                          const gchar     *path,
+                          GgitOId         *id,
+                          GgitFileMode     file_mode)
+{
+	git_tree_update update = { 0, };
+
+	g_return_if_fail (updates != NULL);
+	g_return_if_fail (path != NULL);
+	g_return_if_fail (id != NULL);
+
+	update.action = GIT_TREE_UPDATE_UPSERT;
+	git_oid_cpy (&update.id, _ggit_oid_get_oid (id));
+	update.filemode = (git_filemode_t)file_mode;
+	update.path = g_strdup (path);
+
+	g_array_append_val (updates->updates, update);
+}
+
+/**
+ * ggit_tree_updates_remove:
+ * @updates: a #GgitTreeUpdates.
+ * @path: the full path of the entry, relative to the root of the tree.
+ *
+ * Remove the entry at @path. Trees left empty by the removal are removed
+ * as well.
+ *
+ **/
+void
+ggit_tree_updates_remove (GgitTreeUpdates *updates,
+                          const gchar     *path)
+{
+	git_tree_update update = { 0, };
+
+	g_return_if_fail (updates != NULL);
+	g_return_if_fail (path != NULL);
+
+	update.action = GIT_TREE_UPDATE_REMOVE;
+	update.path = g_strdup (path);
+
+	g_array_append_val (updates->updates, update);
+}
+
+/**
+ * ggit_tree_updates_get_size:
+ * @updates: a #GgitTreeUpdates.
+ *
+ * Get the number of updates in @updates.
+ *
+ * Returns: the number of updates.
+ *
+ **/
+guint
+ggit_tree_updates_get_size (GgitTreeUpdates *updates)
+{
+	g_return_val_if_fail (updates != NULL, 0);
+
+	return updates->updates->len;
+}
+
+const git_tree_update *
+_ggit_tree_updates_get_native (GgitTreeUpdates *updates)
+{
+	g_return_val_if_fail (updates != NULL, NULL);
+
+	return (const git_tree_update *)updates->updates->data;
+}
+
+/* ex:set ts=8 noet: */
@@ -0,0 +1,59 @@
+/*
+ * ggit-tree-updates.h
+ * This file is part of libgit2-glib
+ *
+ * Copyright (C) 2026 - The libgit2-glib authors
+ *
+ * libgit2-glib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libgit2-glib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libgit2-glib. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GGIT_TREE_UPDATES_H__
+#define __GGIT_TREE_UPDATES_H__
+
+#include <git2.h>
+#include <glib-object.h>
+#include <libgit2-glib/ggit-types.h>
+
+G_BEGIN_DECLS
+
+#define GGIT_TYPE_TREE_UPDATES       (ggit_tree_updates_get_type ())
+#define GGIT_TREE_UPDATES(obj)       ((GgitTreeUpdates *)obj)
+
+GType            ggit_tree_updates_get_type    (void) G_GNUC_CONST;
+
+GgitTreeUpdates *ggit_tree_updates_new         (void);
+
+GgitTreeUpdates *ggit_tree_updates_ref         (GgitTreeUpdates  *updates);
+void             ggit_tree_updates_unref       (GgitTreeUpdates  *updates);
+
+void             ggit_tree_updates_upsert      (GgitTreeUpdates  *updates,
+                                                const gchar      *path,
+                                                GgitOId          *id,
+                                                GgitFileMode      file_mode);
+
+void             ggit_tree_updates_remove      (GgitTreeUpdates  *updates,
+                                                const gchar      *path);
+
+guint            ggit_tree_updates_get_size    (GgitTreeUpdates  *updates);
+
+const git_tree_update *
+                _ggit_tree_updates_get_native  (GgitTreeUpdates  *updates);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GgitTreeUpdates, ggit_tree_updates_unref)
+
+G_END_DECLS
+
+#endif /* __GGIT_TREE_UPDATES_H__ */
+
+/* ex:set ts=8 noet: */
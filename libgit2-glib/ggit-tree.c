@@ -19,8 +19,10 @@
  */
 
 #include <git2.h>
+#include <string.h>
 
 #include "ggit-tree.h"
+#include "ggit-tree-updates.h"
 #include "ggit-oid.h"
 #include "ggit-error.h"
 
@@ -212,6 +214,271 @@ ggit_tree_get_by_path (GgitTree     *tree,
 	return entry;
 }
 
+typedef struct
+{
+	git_tree *tree;
+	gsize prefix_len;
+} PathLevel;
+
+static gint
+compare_path_index (gconstpointer a,
+                    gconstpointer b,
+                    gpointer      user_data)
+{
+	const gchar * const *paths = user_data;
+
+	return strcmp (paths[*(const guint *)a], paths[*(const guint *)b]);
+}
+
+static void
+tree_entry_unref_nullable (gpointer entry)
+{
+	if (entry != NULL)
+	{
+		ggit_tree_entry_unref (entry);
+	}
+}
+
+static void
+pop_path_level (GArray *levels)
+{
+	git_tree_free (g_array_index (levels, PathLevel, levels->len - 1).tree);
+	g_array_set_size (levels, levels->len - 1);
+}
+
+/**
+ * ggit_tree_get_by_paths:
+ * @tree: a #GgitTree.
+ * @paths: (array zero-terminated=1): the paths to resolve.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Retrieves the tree entries for many paths at once, see
+ * ggit_tree_get_by_path(). The paths are resolved in sorted order so that
+ * each subtree along shared directory prefixes is only loaded once.
+ *
+ * The returned array contains an element for each path, in the order of
+ * @paths. Elements are %NULL for paths which do not exist in @tree. As
+ * with ggit_tree_get_by_path(), a path with a trailing slash only
+ * resolves to a tree.
+ *
+ * Returns: (transfer full) (element-type GgitTreeEntry) (nullable): the
+ *          entries, or %NULL if a subtree could not be loaded.
+ *
+ **/
+GPtrArray *
+ggit_tree_get_by_paths (GgitTree            *tree,
+                        const gchar * const *paths,
+                        GError             **error)
+{
+	git_tree *root;
+	GPtrArray *ret;
+	GArray *levels;
+	PathLevel level = { 0, };
+	const gchar **names;
+	GPtrArray *stripped;
+	guint *order;
+	guint n_paths;
+	guint i;
+
+	g_return_val_if_fail (GGIT_IS_TREE (tree), NULL);
+	g_return_val_if_fail (paths != NULL, NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	root = _ggit_native_get (tree);
+	n_paths = g_strv_length ((gchar **)paths);
+
+	order = g_new (guint, n_paths);
+	names = g_new (const gchar *, n_paths);
+	stripped = g_ptr_array_new_with_free_func (g_free);
+
+	for (i = 0; i < n_paths; ++i)
+	{
+		gsize len = strlen (paths[i]);
+
+		order[i] = i;
+
+		/* Resolve "dir/" as "dir", which must then be a tree */
+		if (len > 1 && paths[i][len - 1] == '/')
+		{
+			names[i] = g_strndup (paths[i], len - 1);
+			g_ptr_array_add (stripped, (gpointer)names[i]);
+		}
+		else
+		{
+			names[i] = paths[i];
+		}
+	}
+
+	g_qsort_with_data (order,
+	                   n_paths,
+	                   sizeof (guint),
+	                   compare_path_index,
+	                   names);
+
+	ret = g_ptr_array_new_full (n_paths, tree_entry_unref_nullable);
+	g_ptr_array_set_size (ret, n_paths);
+
+	/* The chain of trees along the directory of the previous path. The
+	 * root level is borrowed from @tree.
+	 */
+	levels = g_array_new (FALSE, FALSE, sizeof (PathLevel));
+
+	level.tree = root;
+	g_array_append_val (levels, level);
+
+	for (i = 0; i < n_paths; ++i)
+	{
+		const gchar *path = names[order[i]];
+		const gchar *slash;
+		const git_tree_entry *entry = NULL;
+		PathLevel *top;
+		gsize dir_len;
+
+		slash = strrchr (path, '/');
+		dir_len = slash != NULL ? (gsize)(slash - path) + 1 : 0;
+
+		/* Go up until the top level is a prefix of the directory */
+		while (levels->len > 1)
+		{
+			top = &g_array_index (levels, PathLevel, levels->len - 1);
+
+			if (top->prefix_len <= dir_len &&
+			    strncmp (path, names[order[i - 1]], top->prefix_len) == 0)
+			{
+				break;
+			}
+
+			pop_path_level (levels);
+		}
+
+		top = &g_array_index (levels, PathLevel, levels->len - 1);
+
+		/* Go down the remaining directory components */
+		while (top->prefix_len < dir_len)
+		{
+			const gchar *name = path + top->prefix_len;
+			const gchar *end = strchr (name, '/');
+			gchar *component;
+			gint r;
+
+			component = g_strndup (name, end - name);
+			entry = git_tree_entry_byname (top->tree, component);
+			g_free (component);
+
+			if (entry == NULL || git_tree_entry_type (entry) != GIT_OBJ_TREE)
+			{
+				entry = NULL;
+				break;
+			}
+
+			r = git_tree_lookup (&level.tree,
+			                     git_tree_owner (root),
+			                     git_tree_entry_id (entry));
+
+			if (r != GIT_OK)
+			{
+				_ggit_error_set (error, r);
+				g_clear_pointer (&ret, g_ptr_array_unref);
+
+				break;
+			}
+
+			level.prefix_len = end - path + 1;
+			g_array_append_val (levels, level);
+
+			top = &g_array_index (levels, PathLevel, levels->len - 1);
+		}
+
+		if (ret == NULL)
+		{
+			break;
+		}
+
+		if (top->prefix_len == dir_len && path[dir_len] != '\0')
+		{
+			entry = git_tree_entry_byname (top->tree, path + dir_len);
+		}
+		else
+		{
+			entry = NULL;
+		}
+
+		if (entry != NULL &&
+		    path != paths[order[i]] &&
+		    git_tree_entry_type (entry) != GIT_OBJ_TREE)
+		{
+			entry = NULL;
+		}
+
+		if (entry != NULL)
+		{
+			git_tree_entry *dup;
+
+			if (git_tree_entry_dup (&dup, entry) == GIT_OK)
+			{
+				g_ptr_array_index (ret, order[i]) = _ggit_tree_entry_wrap (dup, TRUE);
+			}
+		}
+	}
+
+	while (levels->len > 1)
+	{
+		pop_path_level (levels);
+	}
+
+	g_array_unref (levels);
+	g_ptr_array_unref (stripped);
+	g_free (names);
+	g_free (order);
+
+	return ret;
+}
+
+/**
+ * ggit_tree_create_updated:
+ * @tree: the baseline #GgitTree.
+ * @updates: the #GgitTreeUpdates to apply.
+ * @error: a #GError for error reporting, or %NULL.
+ *
+ * Create a new tree by applying @updates to @tree. Updates address entries
+ * by their full path, and only the trees along the updated paths are
+ * written to the object database. Neither the index nor the working
+ * directory are used.
+ *
+ * Returns: (transfer full) (nullable): the #GgitOId of the new tree, or
+ *          %NULL in case of an error.
+ *
+ **/
+GgitOId *
+ggit_tree_create_updated (GgitTree         *tree,
+                          GgitTreeUpdates  *updates,
+                          GError          **error)
+{
+	git_tree *t;
+	git_oid oid;
+	gint ret;
+
+	g_return_val_if_fail (GGIT_IS_TREE (tree), NULL);
+	g_return_val_if_fail (updates != NULL, NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	t = _ggit_native_get (tree);
+
+	ret = git_tree_create_updated (&oid,
+	                               git_tree_owner (t),
+	                               t,
+	                               ggit_tree_updates_get_size (updates),
+	                               _ggit_tree_updates_get_native (updates));
+
+	if (ret != GIT_OK)
+	{
+		_ggit_error_set (error, ret);
+		return NULL;
+	}
+
+	return _ggit_oid_wrap (&oid);
+}
+
 typedef struct
 {
 	GgitTreeWalkCallback callback;
@@ -62,6 +62,14 @@ GgitTreeEntry *ggit_tree_get_by_path    (GgitTree     *tree,
                                          const gchar  *path,
                                          GError      **error);
 
+GPtrArray     *ggit_tree_get_by_paths   (GgitTree            *tree,
+                                         const gchar * const *paths,
+                                         GError             **error);
+
+GgitOId       *ggit_tree_create_updated (GgitTree         *tree,
+                                         GgitTreeUpdates  *updates,
+                                         GError          **error);
+
 void           ggit_tree_walk           (GgitTree              *tree,
                                          GgitTreeWalkMode       mode,
                                          GgitTreeWalkCallback   callback,
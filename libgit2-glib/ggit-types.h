@@ -158,6 +158,13 @@ typedef struct _GgitIndexEntriesResolveUndo GgitIndexEntriesResolveUndo;
  */
 typedef struct _GgitIndexEntryResolveUndo GgitIndexEntryResolveUndo;
 
+/**
+ * GgitIndexSnapshot:
+ *
+ * Represents an immutable copy of the entries in an index object.
+ */
+typedef struct _GgitIndexSnapshot GgitIndexSnapshot;
+
 /**
  * GgitMergeOptions:
  *
@@ -278,6 +285,20 @@ typedef struct _GgitTransferProgress GgitTransferProgress;
  */
 typedef struct _GgitTreeEntry GgitTreeEntry;
 
+/**
+ * GgitTreeIterator:
+ *
+ * Represents an iterator over the entries of a tree and its subtrees.
+ */
+typedef struct _GgitTreeIterator GgitTreeIterator;
+
+/**
+ * GgitTreeUpdates:
+ *
+ * Represents a list of changes to apply to a tree.
+ */
+typedef struct _GgitTreeUpdates GgitTreeUpdates;
+
 /**
  * GgitBlameOptions:
  *
@@ -478,6 +499,20 @@ typedef enum {
 	GGIT_DIFF_FLAG_VALID_ID   = 1 << 2
 } GgitDiffFlag;
 
+/**
+ * GgitDiffForeachFlags:
+ * @GGIT_DIFF_FOREACH_DEFAULT: default behavior.
+ * @GGIT_DIFF_FOREACH_BORROW_LINES: the #GgitDiffLine passed to the line
+ *   callback does not copy its contents and is only valid during the
+ *   callback. Use ggit_diff_line_copy() to keep it.
+ *
+ * Describes how ggit_diff_foreach_full() iterates over a diff.
+ */
+typedef enum {
+	GGIT_DIFF_FOREACH_DEFAULT      = 0,
+	GGIT_DIFF_FOREACH_BORROW_LINES = 1 << 0
+} GgitDiffForeachFlags;
+
 /**
  * GgitDiffLineType:
  * @GGIT_DIFF_LINE_CONTEXT: line is part of the context.
@@ -508,6 +543,21 @@ typedef enum {
 	GGIT_DIFF_LINE_BINARY        = 'B'
 } GgitDiffLineType;
 
+/**
+ * GgitDirtyFlags:
+ * @GGIT_DIRTY_DEFAULT: consider all changes.
+ * @GGIT_DIRTY_IGNORE_UNTRACKED: do not consider untracked files.
+ * @GGIT_DIRTY_IGNORE_SUBMODULES: do not consider changes in submodules.
+ *
+ * Describes which changes ggit_repository_is_dirty() takes into account.
+ */
+typedef enum
+{
+	GGIT_DIRTY_DEFAULT           = 0,
+	GGIT_DIRTY_IGNORE_UNTRACKED  = 1 << 0,
+	GGIT_DIRTY_IGNORE_SUBMODULES = 1 << 1
+} GgitDirtyFlags;
+
 /* NOTE: keep in sync with git2/errors.h */
 /**
  * GgitError:
@@ -541,6 +591,28 @@ typedef enum {
 	GGIT_FILE_MODE_COMMIT          = 0160000
 } GgitFileMode;
 
+/**
+ * GgitIndexAddOption:
+ * @GGIT_INDEX_ADD_DEFAULT: default behavior.
+ * @GGIT_INDEX_ADD_FORCE: add files even if they are ignored.
+ * @GGIT_INDEX_ADD_DISABLE_PATHSPEC_MATCH: match the pathspecs literally
+ *   instead of as fnmatch patterns.
+ * @GGIT_INDEX_ADD_CHECK_PATHSPEC: fail if a pathspec names an ignored file
+ *   and @GGIT_INDEX_ADD_FORCE is not set.
+ * @GGIT_INDEX_ADD_PARALLEL_HASH: hash and write the matched files to the
+ *   object database on several threads, and insert their entries directly.
+ *
+ * Describes how files are added to the index by ggit_index_add_all().
+ */
+typedef enum
+{
+	GGIT_INDEX_ADD_DEFAULT                = 0,
+	GGIT_INDEX_ADD_FORCE                  = 1 << 0,
+	GGIT_INDEX_ADD_DISABLE_PATHSPEC_MATCH = 1 << 1,
+	GGIT_INDEX_ADD_CHECK_PATHSPEC         = 1 << 2,
+	GGIT_INDEX_ADD_PARALLEL_HASH          = 1 << 16
+} GgitIndexAddOption;
+
 /* NOTE: keep in sync with git2/merge.h */
 /**
  * GgitMergeAutomergeMode:
@@ -1028,6 +1100,22 @@ typedef enum
 	GGIT_CLONE_LOCAL_NO_LINKS = 3
 } GgitCloneLocal;
 
+/**
+ * GgitBlobsProgressCallback:
+ * @n_done: the number of files written so far.
+ * @n_total: the total number of files.
+ * @bytes_done: the number of bytes written so far.
+ * @user_data: (closure): user-supplied data.
+ *
+ * The type of the callback functions reporting the progress of writing
+ * many files to the object database.
+ * See ggit_repository_create_blobs_from_files().
+ */
+typedef void (* GgitBlobsProgressCallback) (guint    n_done,
+                                            guint    n_total,
+                                            guint64  bytes_done,
+                                            gpointer user_data);
+
 /**
  * GgitConfigCallback:
  * @entry: a #GgitConfigEntry.
@@ -1139,6 +1227,22 @@ typedef gint (* GgitDiffSimilarityMetricSimilarityCallback) (gint     *score,
                                                              gpointer  signature_b,
                                                              gpointer  user_data);
 
+/**
+ * GgitIndexMatchedPathCallback:
+ * @path: the path of the file, relative to the working directory.
+ * @matched_pathspec: (allow-none): the pathspec which matched @path.
+ * @user_data: (closure): user-supplied data.
+ *
+ * The type of the callback functions called for each path matched by
+ * ggit_index_add_all(), ggit_index_update_all() and ggit_index_remove_all().
+ *
+ * Returns: 0 to process @path, a positive value to skip it or a negative
+ *          value to abort the operation.
+ */
+typedef gint (* GgitIndexMatchedPathCallback) (const gchar *path,
+                                               const gchar *matched_pathspec,
+                                               gpointer     user_data);
+
 /**
  * GgitNoteCallback:
  * @blob_id: id of the blob containing the message.
@@ -139,4 +139,34 @@ ggit_utils_get_git_strarray_from_str_array (const gchar * const *array,
 	}
 }
 
+/* A libgit2 repository must not be shared between threads, so workers open
+ * their own handle on the repository at @path, using @workdir if not %NULL.
+ */
+gint
+ggit_utils_open_worker_repository (git_repository **out,
+                                   const gchar     *path,
+                                   const gchar     *workdir)
+{
+	git_repository *repo = NULL;
+	gint ret;
+
+	*out = NULL;
+
+	ret = git_repository_open (&repo, path);
+
+	if (ret == GIT_OK && workdir != NULL)
+	{
+		ret = git_repository_set_workdir (repo, workdir, 0);
+	}
+
+	if (ret != GIT_OK)
+	{
+		git_repository_free (repo);
+		return ret;
+	}
+
+	*out = repo;
+	return GIT_OK;
+}
+
 /* ex:set ts=8 noet: */
@@ -42,6 +42,12 @@ void            ggit_utils_get_git_strarray_from_str_array
                                                       (const gchar * const *array,
                                                        git_strarray        *gitarray);
 
+gint            ggit_utils_open_worker_repository     (git_repository **out,
+                                                       const gchar     *path,
+                                                       const gchar     *workdir);
+
+gboolean        _ggit_object_factory_has_overrides    (void);
+
 G_END_DECLS
 
 #endif
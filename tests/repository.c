@@ -214,6 +214,7 @@ test_repository_blob_stream (const gchar *git_dir)
 	GgitBlob *blob;
 	gsize rl;
 	const guchar *content;
+	GBytes *bytes;
 
 	f = g_file_new_for_path (git_dir);
 	repo = ggit_repository_init_repository (f, FALSE, &err);
@@ -254,12 +255,122 @@ test_repository_blob_stream (const gchar *git_dir)
 	g_assert_cmpint (rl, ==, msglen);
 	g_assert_cmpint (memcmp (content, msg, msglen), ==, 0);
 
+	bytes = ggit_blob_get_content_bytes (blob);
+	g_object_unref (blob);
+
+	/* The bytes keep the blob content alive */
+	content = g_bytes_get_data (bytes, &rl);
+	g_assert_cmpint (rl, ==, msglen);
+	g_assert_cmpint (memcmp (content, msg, msglen), ==, 0);
+	g_bytes_unref (bytes);
+
 	ggit_oid_free (oid);
 
 	g_object_unref (stream);
 	g_object_unref (repo);
 }
 
+static void
+test_repository_blob_content_bytes_perf (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GPtrArray *oids;
+	guint8 *contents;
+	gsize size = 64 * 1024;
+	gsize total;
+	guint n_blobs = g_test_perf () ? 2000 : 200;
+	guint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	oids = g_ptr_array_new_with_free_func ((GDestroyNotify)ggit_oid_free);
+	contents = g_malloc (size);
+
+	for (i = 0; i < size; ++i)
+	{
+		contents[i] = i % 251;
+	}
+
+	for (i = 0; i < n_blobs; ++i)
+	{
+		GgitOId *oid;
+
+		memcpy (contents, &i, sizeof (i));
+
+		oid = ggit_repository_create_blob_from_buffer (repo, contents, size, &err);
+		g_assert_no_error (err);
+
+		g_ptr_array_add (oids, oid);
+	}
+
+	/* Copying the raw content, as bindings have to */
+	total = 0;
+	g_test_timer_start ();
+
+	for (i = 0; i < n_blobs; ++i)
+	{
+		GgitBlob *blob;
+		const guchar *raw;
+		gsize len;
+		GBytes *bytes;
+
+		blob = ggit_repository_lookup_blob (repo, g_ptr_array_index (oids, i), &err);
+		g_assert_no_error (err);
+
+		raw = ggit_blob_get_raw_content (blob, &len);
+		bytes = g_bytes_new (raw, len);
+		g_object_unref (blob);
+
+		total += g_bytes_get_size (bytes);
+		g_bytes_unref (bytes);
+	}
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "served %u blobs of %" G_GSIZE_FORMAT " bytes by copy in %f seconds",
+	                         n_blobs,
+	                         size,
+	                         g_test_timer_last ());
+
+	g_assert_cmpuint (total, ==, n_blobs * size);
+
+	/* Sharing the blob buffer */
+	total = 0;
+	g_test_timer_start ();
+
+	for (i = 0; i < n_blobs; ++i)
+	{
+		GgitBlob *blob;
+		GBytes *bytes;
+
+		blob = ggit_repository_lookup_blob (repo, g_ptr_array_index (oids, i), &err);
+		g_assert_no_error (err);
+
+		bytes = ggit_blob_get_content_bytes (blob);
+		g_object_unref (blob);
+
+		total += g_bytes_get_size (bytes);
+		g_bytes_unref (bytes);
+	}
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "served %u blobs of %" G_GSIZE_FORMAT " bytes without copying in %f seconds",
+	                         n_blobs,
+	                         size,
+	                         g_test_timer_last ());
+
+	g_assert_cmpuint (total, ==, n_blobs * size);
+
+	g_free (contents);
+	g_ptr_array_unref (oids);
+	g_object_unref (repo);
+}
+
 static void
 test_repository_encoding (const gchar *git_dir)
 {
@@ -360,6 +471,3859 @@ test_repository_encoding (const gchar *git_dir)
 	g_object_unref (repo);
 }
 
+static GgitOId *
+create_commit (GgitRepository *repo,
+               GgitOId        *parent,
+               const gchar    *filename,
+               const gchar    *contents)
+{
+	GError *err = NULL;
+	GgitIndex *idx;
+	GFile *workdir;
+	GFile *afile;
+	GgitOId *toid;
+	GgitOId *cid;
+	GgitSignature *author;
+
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	workdir = ggit_repository_get_workdir (repo);
+	afile = g_file_get_child (workdir, filename);
+	g_object_unref (workdir);
+
+	g_file_replace_contents (afile,
+	                         contents,
+	                         strlen (contents),
+	                         NULL,
+	                         FALSE,
+	                         G_FILE_CREATE_NONE,
+	                         NULL,
+	                         NULL,
+	                         &err);
+	g_assert_no_error (err);
+
+	ggit_index_add_file (idx, afile, &err);
+	g_assert_no_error (err);
+	g_object_unref (afile);
+
+	ggit_index_write (idx, &err);
+	g_assert_no_error (err);
+
+	toid = ggit_index_write_tree (idx, &err);
+	g_assert_no_error (err);
+	g_object_unref (idx);
+
+	author = ggit_signature_new_now ("Jesse van den Kieboom",
+	                                 "jessevdk@gnome.org",
+	                                 &err);
+	g_assert_no_error (err);
+
+	cid = ggit_repository_create_commit_from_ids (repo,
+	                                              "HEAD",
+	                                              author,
+	                                              author,
+	                                              NULL,
+	                                              contents,
+	                                              toid,
+	                                              parent != NULL ? &parent : NULL,
+	                                              parent != NULL ? 1 : 0,
+	                                              &err);
+	g_assert_no_error (err);
+	g_assert (cid != NULL);
+
+	g_object_unref (author);
+	ggit_oid_free (toid);
+
+	return cid;
+}
+
+static void
+test_repository_walk_next_n (const gchar *git_dir)
+{
+	GFile *f;
+	GError *err = NULL;
+	GgitRepository *repo;
+	GgitRevisionWalker *walker;
+	GgitOId *cids[3];
+	GgitOId *oid;
+	GBytes *ids;
+	const guchar *raw;
+	gsize size;
+	gint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	cids[0] = create_commit (repo, NULL, "a", "first\n");
+	cids[1] = create_commit (repo, cids[0], "a", "second\n");
+	cids[2] = create_commit (repo, cids[1], "a", "third\n");
+
+	walker = ggit_revision_walker_new (repo, &err);
+	g_assert_no_error (err);
+
+	ggit_revision_walker_set_sort_mode (walker, GGIT_SORT_TOPOLOGICAL);
+	ggit_revision_walker_push (walker, cids[2], &err);
+	g_assert_no_error (err);
+
+	ids = ggit_revision_walker_next_n (walker, 2, &err);
+	g_assert_no_error (err);
+
+	raw = g_bytes_get_data (ids, &size);
+	g_assert_cmpuint (size, ==, 2 * 20);
+
+	for (i = 0; i < 2; ++i)
+	{
+		oid = ggit_oid_new_from_raw (raw + i * 20);
+		g_assert (ggit_oid_equal (oid, cids[2 - i]));
+		ggit_oid_free (oid);
+	}
+
+	g_bytes_unref (ids);
+
+	ids = ggit_revision_walker_next_n (walker, 2, &err);
+	g_assert_no_error (err);
+
+	raw = g_bytes_get_data (ids, &size);
+	g_assert_cmpuint (size, ==, 20);
+
+	oid = ggit_oid_new_from_raw (raw);
+	g_assert (ggit_oid_equal (oid, cids[0]));
+	ggit_oid_free (oid);
+
+	g_bytes_unref (ids);
+
+	ids = ggit_revision_walker_next_n (walker, 2, &err);
+	g_assert_no_error (err);
+	g_assert_cmpuint (g_bytes_get_size (ids), ==, 0);
+	g_bytes_unref (ids);
+
+	/* A large maximum does not allocate room for all of it upfront */
+	ggit_revision_walker_push (walker, cids[2], &err);
+	g_assert_no_error (err);
+
+	ids = ggit_revision_walker_next_n (walker, G_MAXUINT, &err);
+	g_assert_no_error (err);
+	g_assert_cmpuint (g_bytes_get_size (ids), ==, 3 * 20);
+	g_bytes_unref (ids);
+
+	for (i = 0; i < 3; ++i)
+	{
+		ggit_oid_free (cids[i]);
+	}
+
+	g_object_unref (walker);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_walk_next_n_perf (const gchar *git_dir)
+{
+	GFile *f;
+	GError *err = NULL;
+	GgitRepository *repo;
+	GgitRevisionWalker *walker;
+	GgitCommit *root;
+	GgitSignature *sig;
+	GgitOId *tree_id;
+	GgitOId *head;
+	GgitOId *oid;
+	GBytes *ids;
+	guint n = g_test_perf () ? 200000 : 2000;
+	guint n_walked;
+	guint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	head = create_commit (repo, NULL, "a", "first\n");
+
+	root = ggit_repository_lookup_commit (repo, head, &err);
+	g_assert_no_error (err);
+
+	tree_id = ggit_commit_get_tree_id (root);
+	g_object_unref (root);
+
+	sig = ggit_signature_new_now ("Jesse van den Kieboom",
+	                              "jessevdk@gnome.org",
+	                              &err);
+	g_assert_no_error (err);
+
+	/* A long linear history sharing a single tree */
+	for (i = 0; i < n; ++i)
+	{
+		oid = ggit_repository_create_commit_from_ids (repo, NULL, sig, sig, NULL,
+		                                              "commit\n", tree_id,
+		                                              &head, 1, &err);
+		g_assert_no_error (err);
+
+		ggit_oid_free (head);
+		head = oid;
+	}
+
+	walker = ggit_revision_walker_new (repo, &err);
+	g_assert_no_error (err);
+
+	/* One boxed id per commit */
+	ggit_revision_walker_push (walker, head, &err);
+	g_assert_no_error (err);
+
+	n_walked = 0;
+	g_test_timer_start ();
+
+	while ((oid = ggit_revision_walker_next (walker, &err)) != NULL)
+	{
+		ggit_oid_free (oid);
+		++n_walked;
+	}
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "walked %u commits one by one in %f seconds",
+	                         n_walked,
+	                         g_test_timer_last ());
+
+	g_assert_no_error (err);
+	g_assert_cmpuint (n_walked, ==, n + 1);
+
+	/* Packed ids in chunks */
+	ggit_revision_walker_push (walker, head, &err);
+	g_assert_no_error (err);
+
+	n_walked = 0;
+	g_test_timer_start ();
+
+	do
+	{
+		ids = ggit_revision_walker_next_n (walker, 1024, &err);
+		g_assert_no_error (err);
+
+		i = g_bytes_get_size (ids) / 20;
+		n_walked += i;
+		g_bytes_unref (ids);
+	} while (i > 0);
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "walked %u commits in chunks of 1024 in %f seconds",
+	                         n_walked,
+	                         g_test_timer_last ());
+
+	g_assert_cmpuint (n_walked, ==, n + 1);
+
+	ggit_oid_free (head);
+	ggit_oid_free (tree_id);
+	g_object_unref (sig);
+	g_object_unref (walker);
+	g_object_unref (repo);
+}
+
+typedef struct
+{
+	GMainLoop *loop;
+	GgitRepository *repo;
+	GError *error;
+} AsyncData;
+
+static void
+open_async_cb (GObject      *source,
+               GAsyncResult *result,
+               gpointer      user_data)
+{
+	AsyncData *data = user_data;
+
+	data->repo = ggit_repository_open_finish (result, &data->error);
+	g_main_loop_quit (data->loop);
+}
+
+static void
+clone_async_cb (GObject      *source,
+                GAsyncResult *result,
+                gpointer      user_data)
+{
+	AsyncData *data = user_data;
+
+	data->repo = ggit_repository_clone_finish (result, &data->error);
+	g_main_loop_quit (data->loop);
+}
+
+typedef struct
+{
+	GCancellable *cancellable;
+	gint n_progress;
+} CancelData;
+
+static void
+cancel_on_transfer_progress (GgitRemoteCallbacks  *callbacks,
+                             GgitTransferProgress *progress,
+                             CancelData           *data)
+{
+	/* Emitted on the worker thread while the transfer is running */
+	g_atomic_int_inc (&data->n_progress);
+	g_cancellable_cancel (data->cancellable);
+}
+
+static GgitFetchOptions *
+create_cancelling_fetch_options (CancelData *data)
+{
+	GgitFetchOptions *fetch_options;
+	GgitRemoteCallbacks *callbacks;
+
+	callbacks = g_object_new (GGIT_TYPE_REMOTE_CALLBACKS, NULL);
+
+	g_signal_connect (callbacks,
+	                  "transfer-progress",
+	                  G_CALLBACK (cancel_on_transfer_progress),
+	                  data);
+
+	fetch_options = ggit_fetch_options_new ();
+	ggit_fetch_options_set_remote_callbacks (fetch_options, callbacks);
+	g_object_unref (callbacks);
+
+	return fetch_options;
+}
+
+static void
+test_repository_open_async (const gchar *git_dir)
+{
+	GFile *f;
+	GFile *target;
+	GError *err = NULL;
+	GgitRepository *repo;
+	GFile *dotgit;
+	GCancellable *cancellable;
+	GgitCloneOptions *options;
+	GgitFetchOptions *fetch_options;
+	CancelData cancel_data = { NULL, };
+	AsyncData data = { NULL, };
+	gchar *url;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_assert_no_error (err);
+
+	ggit_oid_free (create_commit (repo, NULL, "a", "first\n"));
+	g_object_unref (repo);
+
+	data.loop = g_main_loop_new (NULL, FALSE);
+
+	ggit_repository_open_async (f,
+	                            G_PRIORITY_DEFAULT,
+	                            NULL,
+	                            open_async_cb,
+	                            &data);
+	g_main_loop_run (data.loop);
+
+	g_assert_no_error (data.error);
+	g_assert (GGIT_IS_REPOSITORY (data.repo));
+	g_assert (!ggit_repository_is_bare (data.repo));
+	g_clear_object (&data.repo);
+
+	/* A cancelled clone must not leave a repository behind */
+	cancellable = g_cancellable_new ();
+	g_cancellable_cancel (cancellable);
+
+	url = g_file_get_uri (f);
+	target = g_file_get_child (f, "clone");
+
+	ggit_repository_clone_async (url,
+	                             target,
+	                             NULL,
+	                             G_PRIORITY_DEFAULT,
+	                             cancellable,
+	                             clone_async_cb,
+	                             &data);
+	g_main_loop_run (data.loop);
+
+	g_assert_error (data.error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_assert (data.repo == NULL);
+	g_clear_error (&data.error);
+	g_assert (!g_file_query_exists (target, NULL));
+
+	g_object_unref (cancellable);
+
+	/* Cancel from within the transfer */
+	cancel_data.cancellable = g_cancellable_new ();
+
+	fetch_options = create_cancelling_fetch_options (&cancel_data);
+	options = ggit_clone_options_new ();
+	ggit_clone_options_set_fetch_options (options, fetch_options);
+	ggit_fetch_options_free (fetch_options);
+
+	ggit_repository_clone_async (url,
+	                             target,
+	                             options,
+	                             G_PRIORITY_DEFAULT,
+	                             cancel_data.cancellable,
+	                             clone_async_cb,
+	                             &data);
+	g_main_loop_run (data.loop);
+
+	g_assert_error (data.error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_assert (data.repo == NULL);
+	g_clear_error (&data.error);
+
+	/* The clone was interrupted, not skipped */
+	g_assert_cmpint (g_atomic_int_get (&cancel_data.n_progress), ==, 1);
+
+	dotgit = g_file_get_child (target, ".git");
+	g_assert (!g_file_query_exists (dotgit, NULL));
+	g_object_unref (dotgit);
+
+	repo = ggit_repository_open (target, &err);
+	g_assert (repo == NULL);
+	g_assert (err != NULL);
+	g_clear_error (&err);
+
+	g_free (url);
+	g_object_unref (options);
+	g_object_unref (target);
+	g_object_unref (cancel_data.cancellable);
+	g_object_unref (f);
+	g_main_loop_unref (data.loop);
+}
+
+typedef struct
+{
+	GMainLoop *loop;
+	GString *order;
+	GError *error;
+	gint pending;
+} RemoteAsyncData;
+
+static void
+remote_async_cb (GObject      *source,
+                 GAsyncResult *result,
+                 gpointer      user_data)
+{
+	RemoteAsyncData *data = user_data;
+	GgitRemote *remote = GGIT_REMOTE (source);
+	GError *error = NULL;
+	gboolean ret;
+
+	if (g_async_result_is_tagged (result, ggit_remote_connect_async))
+	{
+		ret = ggit_remote_connect_finish (remote, result, &error);
+		g_string_append_c (data->order, 'c');
+	}
+	else if (g_async_result_is_tagged (result, ggit_remote_download_async))
+	{
+		ret = ggit_remote_download_finish (remote, result, &error);
+		g_string_append_c (data->order, 'd');
+	}
+	else if (g_async_result_is_tagged (result, ggit_remote_update_tips_async))
+	{
+		ret = ggit_remote_update_tips_finish (remote, result, &error);
+		g_string_append_c (data->order, 'u');
+	}
+	else
+	{
+		ret = ggit_remote_push_finish (remote, result, &error);
+		g_string_append_c (data->order, 'p');
+	}
+
+	g_assert (ret == (error == NULL));
+
+	if (error != NULL && data->error == NULL)
+	{
+		data->error = error;
+		error = NULL;
+	}
+
+	g_clear_error (&error);
+
+	if (--data->pending == 0)
+	{
+		g_main_loop_quit (data->loop);
+	}
+}
+
+static void
+test_repository_remote_async (const gchar *git_dir)
+{
+	GFile *f;
+	GFile *location;
+	GError *err = NULL;
+	GgitRepository *repo;
+	GgitRepository *mirror;
+	GgitRemote *remote;
+	GgitFetchOptions *fetch_options;
+	GgitCommit *commit;
+	GgitRef *head;
+	GgitRef *ref;
+	GgitOId *target;
+	GgitOId *cids[2];
+	CancelData cancel_data = { NULL, };
+	RemoteAsyncData data = { NULL, };
+	gchar *url;
+	gchar *mirror_url;
+	gchar *tracking;
+	const gchar *fetch_specs[] = { "+refs/heads/*:refs/remotes/origin/*", NULL };
+	const gchar *push_specs[] = { "HEAD:refs/heads/pushed", NULL };
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_assert_no_error (err);
+
+	cids[0] = create_commit (repo, NULL, "a", "first\n");
+
+	location = g_file_get_child (f, "mirror.git");
+	mirror = ggit_repository_init_repository (location, TRUE, &err);
+	g_assert_no_error (err);
+
+	url = g_file_get_uri (f);
+	mirror_url = g_file_get_uri (location);
+	g_object_unref (location);
+
+	data.loop = g_main_loop_new (NULL, FALSE);
+	data.order = g_string_new (NULL);
+
+	/* Operations on the same repository run one after the other */
+	remote = ggit_remote_new_anonymous (mirror, url, &err);
+	g_assert_no_error (err);
+
+	ggit_remote_connect_async (remote,
+	                           GGIT_DIRECTION_FETCH,
+	                           NULL,
+	                           NULL,
+	                           NULL,
+	                           NULL,
+	                           remote_async_cb,
+	                           &data);
+
+	ggit_remote_download_async (remote,
+	                            fetch_specs,
+	                            NULL,
+	                            NULL,
+	                            remote_async_cb,
+	                            &data);
+
+	ggit_remote_update_tips_async (remote,
+	                               NULL,
+	                               TRUE,
+	                               GGIT_REMOTE_DOWNLOAD_TAGS_AUTO,
+	                               NULL,
+	                               NULL,
+	                               remote_async_cb,
+	                               &data);
+
+	data.pending = 3;
+	g_main_loop_run (data.loop);
+
+	g_assert_no_error (data.error);
+	g_assert_cmpstr (data.order->str, ==, "cdu");
+	g_object_unref (remote);
+
+	head = ggit_repository_get_head (repo, &err);
+	g_assert_no_error (err);
+
+	tracking = g_strconcat ("refs/remotes/origin/",
+	                        ggit_ref_get_shorthand (head),
+	                        NULL);
+	g_object_unref (head);
+
+	ref = ggit_repository_lookup_reference (mirror, tracking, &err);
+	g_assert_no_error (err);
+
+	target = ggit_ref_get_target (ref);
+	g_assert (ggit_oid_equal (target, cids[0]));
+	ggit_oid_free (target);
+	g_object_unref (ref);
+
+	/* Cancelling from within the transfer */
+	cids[1] = create_commit (repo, cids[0], "a", "second\n");
+
+	remote = ggit_remote_new_anonymous (mirror, url, &err);
+	g_assert_no_error (err);
+
+	cancel_data.cancellable = g_cancellable_new ();
+	fetch_options = create_cancelling_fetch_options (&cancel_data);
+
+	ggit_remote_download_async (remote,
+	                            fetch_specs,
+	                            fetch_options,
+	                            cancel_data.cancellable,
+	                            remote_async_cb,
+	                            &data);
+	ggit_fetch_options_free (fetch_options);
+
+	data.pending = 1;
+	g_main_loop_run (data.loop);
+
+	g_assert_error (data.error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_clear_error (&data.error);
+	g_assert_cmpint (g_atomic_int_get (&cancel_data.n_progress), ==, 1);
+
+	commit = ggit_repository_lookup_commit (mirror, cids[1], &err);
+	g_assert (commit == NULL);
+	g_assert (err != NULL);
+	g_clear_error (&err);
+
+	g_object_unref (cancel_data.cancellable);
+	g_object_unref (remote);
+
+	/* Errors are reported when finishing */
+	remote = ggit_remote_new_anonymous (mirror, "file:///nonexistent/ggit.git", &err);
+	g_assert_no_error (err);
+
+	ggit_remote_connect_async (remote,
+	                           GGIT_DIRECTION_FETCH,
+	                           NULL,
+	                           NULL,
+	                           NULL,
+	                           NULL,
+	                           remote_async_cb,
+	                           &data);
+
+	data.pending = 1;
+	g_main_loop_run (data.loop);
+
+	g_assert (data.error != NULL);
+	g_assert (!g_error_matches (data.error, G_IO_ERROR, G_IO_ERROR_CANCELLED));
+	g_clear_error (&data.error);
+	g_object_unref (remote);
+
+	/* Pushing */
+	remote = ggit_remote_new_anonymous (repo, mirror_url, &err);
+	g_assert_no_error (err);
+
+	ggit_remote_push_async (remote,
+	                        push_specs,
+	                        NULL,
+	                        NULL,
+	                        remote_async_cb,
+	                        &data);
+
+	data.pending = 1;
+	g_main_loop_run (data.loop);
+
+	g_assert_no_error (data.error);
+	g_object_unref (remote);
+
+	ref = ggit_repository_lookup_reference (mirror, "refs/heads/pushed", &err);
+	g_assert_no_error (err);
+
+	target = ggit_ref_get_target (ref);
+	g_assert (ggit_oid_equal (target, cids[1]));
+	ggit_oid_free (target);
+	g_object_unref (ref);
+
+	g_free (url);
+	g_free (mirror_url);
+	g_free (tracking);
+	ggit_oid_free (cids[0]);
+	ggit_oid_free (cids[1]);
+	g_string_free (data.order, TRUE);
+	g_main_loop_unref (data.loop);
+	g_object_unref (mirror);
+	g_object_unref (repo);
+	g_object_unref (f);
+}
+
+typedef struct
+{
+	GMutex mutex;
+
+	/* Labels of the jobs on the shared mirror, in the order in which
+	 * they reported progress */
+	GString *order;
+
+	guint n_emissions;
+	guint total_objects;
+	guint received_objects;
+
+	GPtrArray *finished;
+	guint n_cancelled;
+	guint n_failed;
+} SchedulerData;
+
+typedef struct
+{
+	SchedulerData *data;
+	gchar label;
+
+	/* Protected by SchedulerData.mutex */
+	GThread *thread;
+	guint n_progress;
+	guint total_objects;
+	guint received_objects;
+} SchedulerJob;
+
+static void
+scheduler_job_progress_cb (GgitRemoteCallbacks  *callbacks,
+                           GgitTransferProgress *progress,
+                           SchedulerJob         *job)
+{
+	/* Emitted on the worker thread fetching the job */
+	g_mutex_lock (&job->data->mutex);
+
+	job->thread = g_thread_self ();
+	++job->n_progress;
+	job->total_objects = ggit_transfer_progress_get_total_objects (progress);
+	job->received_objects = ggit_transfer_progress_get_received_objects (progress);
+
+	if (job->label != '\0')
+	{
+		g_string_append_c (job->data->order, job->label);
+	}
+
+	g_mutex_unlock (&job->data->mutex);
+}
+
+static GgitFetchOptions *
+create_scheduler_fetch_options (SchedulerJob *job)
+{
+	GgitFetchOptions *fetch_options;
+	GgitRemoteCallbacks *callbacks;
+
+	callbacks = g_object_new (GGIT_TYPE_REMOTE_CALLBACKS, NULL);
+
+	g_signal_connect (callbacks,
+	                  "transfer-progress",
+	                  G_CALLBACK (scheduler_job_progress_cb),
+	                  job);
+
+	fetch_options = ggit_fetch_options_new ();
+	ggit_fetch_options_set_remote_callbacks (fetch_options, callbacks);
+	g_object_unref (callbacks);
+
+	return fetch_options;
+}
+
+static void
+scheduler_transfer_progress_cb (GgitFetchScheduler   *scheduler,
+                                GgitTransferProgress *progress,
+                                SchedulerData        *data)
+{
+	++data->n_emissions;
+	data->total_objects = ggit_transfer_progress_get_total_objects (progress);
+	data->received_objects = ggit_transfer_progress_get_received_objects (progress);
+}
+
+static void
+scheduler_remote_finished_cb (GgitFetchScheduler *scheduler,
+                              GgitRemote         *remote,
+                              GError             *error,
+                              SchedulerData      *data)
+{
+	g_ptr_array_add (data->finished, g_object_ref (remote));
+
+	if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+	{
+		++data->n_cancelled;
+	}
+	else if (error != NULL)
+	{
+		++data->n_failed;
+	}
+}
+
+static void
+test_repository_fetch_scheduler (const gchar *git_dir)
+{
+	GFile *f;
+	GFile *location;
+	GError *err = NULL;
+	GgitRepository *repo;
+	GgitRepository *other;
+	GgitRepository *mirrors[2];
+	GgitRemote *remotes[3];
+	GgitFetchScheduler *scheduler;
+	GgitFetchOptions *fetch_options;
+	GgitCommit *commit;
+	GgitOId *cids[2];
+	GgitOId *other_cid;
+	SchedulerData data = { { 0, }, };
+	SchedulerJob jobs[3] = { { NULL, }, };
+	CancelData cancel_data = { NULL, };
+	gchar *url;
+	gchar *other_url;
+	const gchar *specs[] = { "+refs/heads/*:refs/remotes/origin/*", NULL };
+	const gchar *other_specs[] = { "+refs/heads/*:refs/remotes/other/*", NULL };
+	guint switches;
+	gint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_assert_no_error (err);
+
+	cids[0] = create_commit (repo, NULL, "a", "first\n");
+
+	location = g_file_get_child (f, "other");
+	other = ggit_repository_init_repository (location, FALSE, &err);
+	g_assert_no_error (err);
+
+	other_cid = create_commit (other, NULL, "b", "other\n");
+
+	url = g_file_get_uri (f);
+	other_url = g_file_get_uri (location);
+	g_object_unref (location);
+
+	for (i = 0; i < 2; ++i)
+	{
+		gchar *name;
+
+		name = g_strdup_printf ("mirror%d.git", i);
+		location = g_file_get_child (f, name);
+		g_free (name);
+
+		mirrors[i] = ggit_repository_init_repository (location, TRUE, &err);
+		g_assert_no_error (err);
+		g_object_unref (location);
+	}
+
+	g_mutex_init (&data.mutex);
+	data.order = g_string_new (NULL);
+	data.finished = g_ptr_array_new_with_free_func (g_object_unref);
+
+	scheduler = ggit_fetch_scheduler_new (2);
+
+	g_signal_connect (scheduler,
+	                  "transfer-progress",
+	                  G_CALLBACK (scheduler_transfer_progress_cb),
+	                  &data);
+
+	g_signal_connect (scheduler,
+	                  "remote-finished",
+	                  G_CALLBACK (scheduler_remote_finished_cb),
+	                  &data);
+
+	/* Two remotes on the first mirror, which must be fetched one after
+	 * the other, and one on the second mirror */
+	remotes[0] = ggit_remote_new_anonymous (mirrors[0], url, &err);
+	g_assert_no_error (err);
+
+	remotes[1] = ggit_remote_new_anonymous (mirrors[0], other_url, &err);
+	g_assert_no_error (err);
+
+	remotes[2] = ggit_remote_new_anonymous (mirrors[1], url, &err);
+	g_assert_no_error (err);
+
+	for (i = 0; i < 3; ++i)
+	{
+		jobs[i].data = &data;
+		jobs[i].label = i < 2 ? 'a' + i : '\0';
+
+		fetch_options = create_scheduler_fetch_options (&jobs[i]);
+
+		ggit_fetch_scheduler_add (scheduler,
+		                          remotes[i],
+		                          i == 1 ? other_specs : specs,
+		                          fetch_options,
+		                          NULL);
+
+		ggit_fetch_options_free (fetch_options);
+	}
+
+	g_assert_cmpuint (ggit_fetch_scheduler_get_n_pending (scheduler), ==, 3);
+
+	g_assert (ggit_fetch_scheduler_run (scheduler, NULL, &err));
+	g_assert_no_error (err);
+
+	g_assert_cmpuint (ggit_fetch_scheduler_get_n_pending (scheduler), ==, 0);
+
+	/* Every remote reports its completion once */
+	g_assert_cmpuint (data.finished->len, ==, 3);
+	g_assert_cmpuint (data.n_cancelled, ==, 0);
+	g_assert_cmpuint (data.n_failed, ==, 0);
+
+	for (i = 0; i < 3; ++i)
+	{
+		g_assert (g_ptr_array_remove (data.finished, remotes[i]));
+	}
+
+	/* The progress of the remotes is summed, and coalesced into at most
+	 * one emission per update of the workers */
+	g_assert_cmpuint (data.n_emissions, >=, 1);
+	g_assert_cmpuint (data.n_emissions, <=, jobs[0].n_progress + jobs[1].n_progress + jobs[2].n_progress);
+
+	g_assert_cmpuint (data.total_objects, >, 0);
+	g_assert_cmpuint (data.total_objects, ==, jobs[0].total_objects + jobs[1].total_objects + jobs[2].total_objects);
+	g_assert_cmpuint (data.received_objects, ==, jobs[0].received_objects + jobs[1].received_objects + jobs[2].received_objects);
+
+	/* The remotes of the first mirror ran on the same worker without
+	 * interleaving */
+	g_assert (jobs[0].thread != NULL);
+	g_assert (jobs[0].thread == jobs[1].thread);
+
+	g_assert (strchr (data.order->str, 'a') != NULL);
+	g_assert (strchr (data.order->str, 'b') != NULL);
+
+	switches = 0;
+
+	for (i = 1; i < (gint)data.order->len; ++i)
+	{
+		if (data.order->str[i] != data.order->str[i - 1])
+		{
+			++switches;
+		}
+	}
+
+	g_assert_cmpuint (switches, ==, 1);
+
+	commit = ggit_repository_lookup_commit (mirrors[0], cids[0], &err);
+	g_assert_no_error (err);
+	g_object_unref (commit);
+
+	commit = ggit_repository_lookup_commit (mirrors[0], other_cid, &err);
+	g_assert_no_error (err);
+	g_object_unref (commit);
+
+	commit = ggit_repository_lookup_commit (mirrors[1], cids[0], &err);
+	g_assert_no_error (err);
+	g_object_unref (commit);
+
+	for (i = 0; i < 3; ++i)
+	{
+		g_object_unref (remotes[i]);
+	}
+
+	/* Cancelling aborts the running transfer and skips the remotes
+	 * queued behind it */
+	cids[1] = create_commit (repo, cids[0], "a", "second\n");
+
+	remotes[0] = ggit_remote_new_anonymous (mirrors[1], url, &err);
+	g_assert_no_error (err);
+
+	remotes[1] = ggit_remote_new_anonymous (mirrors[1], url, &err);
+	g_assert_no_error (err);
+
+	cancel_data.cancellable = g_cancellable_new ();
+	fetch_options = create_cancelling_fetch_options (&cancel_data);
+
+	ggit_fetch_scheduler_add (scheduler, remotes[0], specs, fetch_options, NULL);
+	ggit_fetch_scheduler_add (scheduler, remotes[1], specs, NULL, NULL);
+	ggit_fetch_options_free (fetch_options);
+
+	g_assert (!ggit_fetch_scheduler_run (scheduler, cancel_data.cancellable, &err));
+	g_assert_error (err, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_clear_error (&err);
+
+	g_assert_cmpint (g_atomic_int_get (&cancel_data.n_progress), ==, 1);
+	g_assert_cmpuint (data.finished->len, ==, 2);
+	g_assert_cmpuint (data.n_cancelled, ==, 2);
+	g_assert_cmpuint (data.n_failed, ==, 0);
+
+	commit = ggit_repository_lookup_commit (mirrors[1], cids[1], &err);
+	g_assert (commit == NULL);
+	g_assert (err != NULL);
+	g_clear_error (&err);
+
+	g_object_unref (cancel_data.cancellable);
+	g_object_unref (remotes[0]);
+	g_object_unref (remotes[1]);
+
+	g_object_unref (mirrors[0]);
+	g_object_unref (mirrors[1]);
+
+	g_free (url);
+	g_free (other_url);
+	ggit_oid_free (cids[0]);
+	ggit_oid_free (cids[1]);
+	ggit_oid_free (other_cid);
+	g_ptr_array_unref (data.finished);
+	g_string_free (data.order, TRUE);
+	g_mutex_clear (&data.mutex);
+	g_object_unref (scheduler);
+	g_object_unref (other);
+	g_object_unref (repo);
+	g_object_unref (f);
+}
+
+static void
+test_repository_object_cache (const gchar *git_dir)
+{
+	GFile *f;
+	GError *err = NULL;
+	GgitRepository *repo;
+	GgitOId *cid;
+	GgitCommit *a;
+	GgitCommit *b;
+	GgitObject *obj;
+	guint hits;
+	guint misses;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	cid = create_commit (repo, NULL, "a", "first\n");
+
+	g_assert (!ggit_repository_get_object_cache_enabled (repo));
+
+	a = ggit_repository_lookup_commit (repo, cid, &err);
+	g_assert_no_error (err);
+	b = ggit_repository_lookup_commit (repo, cid, &err);
+	g_assert_no_error (err);
+	g_assert (a != b);
+
+	g_object_unref (a);
+	g_object_unref (b);
+
+	ggit_repository_set_object_cache_enabled (repo, TRUE);
+
+	a = ggit_repository_lookup_commit (repo, cid, &err);
+	g_assert_no_error (err);
+	b = ggit_repository_lookup_commit (repo, cid, &err);
+	g_assert_no_error (err);
+	g_assert (a == b);
+
+	obj = ggit_repository_lookup (repo, cid, G_TYPE_NONE, &err);
+	g_assert_no_error (err);
+	g_assert ((gpointer)obj == (gpointer)a);
+
+	ggit_repository_get_object_cache_stats (repo, &hits, &misses);
+	g_assert_cmpuint (hits, ==, 2);
+	g_assert_cmpuint (misses, ==, 1);
+
+	/* Cache hits follow the same type rules as uncached lookups */
+	g_object_unref (obj);
+
+	obj = ggit_repository_lookup (repo, cid, GGIT_TYPE_TREE, &err);
+	g_assert (obj == NULL);
+	g_assert (err != NULL);
+	g_clear_error (&err);
+
+	obj = ggit_repository_lookup (repo, cid, GGIT_TYPE_OBJECT, &err);
+	g_assert (obj == NULL);
+	g_assert (err != NULL);
+	g_clear_error (&err);
+
+	g_object_unref (b);
+	g_object_unref (a);
+
+	/* Wrappers are not kept alive by the cache */
+	ggit_repository_reset_object_cache_stats (repo);
+
+	a = ggit_repository_lookup_commit (repo, cid, &err);
+	g_assert_no_error (err);
+	g_object_unref (a);
+
+	ggit_repository_get_object_cache_stats (repo, &hits, &misses);
+	g_assert_cmpuint (hits, ==, 0);
+	g_assert_cmpuint (misses, ==, 1);
+
+	ggit_oid_free (cid);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_object_cache_perf (const gchar *git_dir)
+{
+	GFile *f;
+	GError *err = NULL;
+	GgitRepository *repo;
+	GgitOId *cid;
+	GgitCommit *keep;
+	GgitCommit *commit;
+	guint n = g_test_perf () ? 1000000 : 10000;
+	guint hits;
+	guint misses;
+	guint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	cid = create_commit (repo, NULL, "a", "first\n");
+
+	/* Keep one wrapper alive, as a log view would */
+	keep = ggit_repository_lookup_commit (repo, cid, &err);
+	g_assert_no_error (err);
+
+	g_test_timer_start ();
+
+	for (i = 0; i < n; ++i)
+	{
+		commit = ggit_repository_lookup_commit (repo, cid, &err);
+		g_assert_no_error (err);
+		g_object_unref (commit);
+	}
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "%u uncached lookups in %f seconds",
+	                         n,
+	                         g_test_timer_last ());
+
+	g_object_unref (keep);
+
+	ggit_repository_set_object_cache_enabled (repo, TRUE);
+
+	keep = ggit_repository_lookup_commit (repo, cid, &err);
+	g_assert_no_error (err);
+
+	g_test_timer_start ();
+
+	for (i = 0; i < n; ++i)
+	{
+		commit = ggit_repository_lookup_commit (repo, cid, &err);
+		g_assert_no_error (err);
+		g_object_unref (commit);
+	}
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "%u cached lookups in %f seconds",
+	                         n,
+	                         g_test_timer_last ());
+
+	ggit_repository_get_object_cache_stats (repo, &hits, &misses);
+	g_assert_cmpuint (hits, ==, n);
+	g_assert_cmpuint (misses, ==, 1);
+
+	g_object_unref (keep);
+	ggit_oid_free (cid);
+	g_object_unref (repo);
+}
+
+typedef struct
+{
+	GgitCommit parent_instance;
+} TestCommit;
+
+typedef struct
+{
+	GgitCommitClass parent_class;
+} TestCommitClass;
+
+static GType test_commit_get_type (void);
+
+G_DEFINE_TYPE (TestCommit, test_commit, GGIT_TYPE_COMMIT)
+
+static void
+test_commit_class_init (TestCommitClass *klass)
+{
+}
+
+static void
+test_commit_init (TestCommit *commit)
+{
+}
+
+static void
+test_repository_object_factory (const gchar *git_dir)
+{
+	GFile *f;
+	GError *err = NULL;
+	GgitRepository *repo;
+	GgitObjectFactory *factory;
+	GgitOId *cid;
+	GgitCommit *commit;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	cid = create_commit (repo, NULL, "a", "first\n");
+
+	/* Construction without overrides takes the fast path */
+	commit = ggit_repository_lookup_commit (repo, cid, &err);
+	g_assert_no_error (err);
+	g_assert (G_OBJECT_TYPE (commit) == GGIT_TYPE_COMMIT);
+	g_object_unref (commit);
+
+	factory = ggit_object_factory_get_default ();
+	ggit_object_factory_register (factory, GGIT_TYPE_COMMIT, test_commit_get_type ());
+
+	commit = ggit_repository_lookup_commit (repo, cid, &err);
+	g_assert_no_error (err);
+	g_assert (G_OBJECT_TYPE (commit) == test_commit_get_type ());
+	g_assert_cmpstr (ggit_commit_get_message (commit), ==, "first\n");
+	g_object_unref (commit);
+
+	ggit_object_factory_unregister (factory, GGIT_TYPE_COMMIT, test_commit_get_type ());
+
+	ggit_oid_free (cid);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_object_factory_perf (const gchar *git_dir)
+{
+	GFile *f;
+	GError *err = NULL;
+	GgitRepository *repo;
+	GgitObjectFactory *factory;
+	GgitOId *cid;
+	GgitCommit *commit;
+	guint n = g_test_perf () ? 1000000 : 10000;
+	guint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	cid = create_commit (repo, NULL, "a", "first\n");
+
+	/* Every lookup constructs a new wrapper, without overrides */
+	g_test_timer_start ();
+
+	for (i = 0; i < n; ++i)
+	{
+		commit = ggit_repository_lookup_commit (repo, cid, &err);
+		g_assert_no_error (err);
+		g_object_unref (commit);
+	}
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "created %u commit wrappers without overrides in %f seconds",
+	                         n,
+	                         g_test_timer_last ());
+
+	/* And through the factory once an override is registered */
+	factory = ggit_object_factory_get_default ();
+	ggit_object_factory_register (factory, GGIT_TYPE_COMMIT, test_commit_get_type ());
+
+	g_test_timer_start ();
+
+	for (i = 0; i < n; ++i)
+	{
+		commit = ggit_repository_lookup_commit (repo, cid, &err);
+		g_assert_no_error (err);
+		g_object_unref (commit);
+	}
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "created %u commit wrappers with an override in %f seconds",
+	                         n,
+	                         g_test_timer_last ());
+
+	ggit_object_factory_unregister (factory, GGIT_TYPE_COMMIT, test_commit_get_type ());
+
+	ggit_oid_free (cid);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_lookup_many (const gchar *git_dir)
+{
+	GFile *f;
+	GError *err = NULL;
+	GgitRepository *repo;
+	GgitOId *cids[3];
+	GgitOId *oids[4];
+	GgitOId **many;
+	GgitOId *missing;
+	GPtrArray *objects;
+	gint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	cids[0] = create_commit (repo, NULL, "a", "first\n");
+	cids[1] = create_commit (repo, cids[0], "a", "second\n");
+	cids[2] = create_commit (repo, cids[1], "a", "third\n");
+
+	oids[0] = cids[2];
+	oids[1] = cids[0];
+	oids[2] = cids[1];
+	oids[3] = cids[0];
+
+	objects = ggit_repository_lookup_many (repo, oids, 4, GGIT_TYPE_COMMIT, &err);
+	g_assert_no_error (err);
+	g_assert_cmpuint (objects->len, ==, 4);
+
+	for (i = 0; i < 4; ++i)
+	{
+		GgitOId *id;
+
+		id = ggit_object_get_id (g_ptr_array_index (objects, i));
+		g_assert (ggit_oid_equal (id, oids[i]));
+		ggit_oid_free (id);
+	}
+
+	g_assert (g_ptr_array_index (objects, 1) == g_ptr_array_index (objects, 3));
+	g_ptr_array_unref (objects);
+
+	/* Long runs of equal ids */
+	many = g_new (GgitOId *, 300);
+
+	for (i = 0; i < 300; ++i)
+	{
+		many[i] = cids[i % 3];
+	}
+
+	objects = ggit_repository_lookup_many (repo, many, 300, GGIT_TYPE_COMMIT, &err);
+	g_assert_no_error (err);
+	g_assert_cmpuint (objects->len, ==, 300);
+
+	for (i = 3; i < 300; ++i)
+	{
+		g_assert (g_ptr_array_index (objects, i) == g_ptr_array_index (objects, i % 3));
+	}
+
+	g_ptr_array_unref (objects);
+	g_free (many);
+
+	missing = ggit_oid_new_from_string ("0123456789012345678901234567890123456789");
+	oids[1] = missing;
+
+	objects = ggit_repository_lookup_many (repo, oids, 4, G_TYPE_NONE, &err);
+	g_assert (objects == NULL);
+	g_assert (err != NULL);
+	g_clear_error (&err);
+
+	ggit_oid_free (missing);
+
+	for (i = 0; i < 3; ++i)
+	{
+		ggit_oid_free (cids[i]);
+	}
+
+	g_object_unref (repo);
+}
+
+static void
+test_repository_read_object_header (const gchar *git_dir)
+{
+	GFile *f;
+	GError *err = NULL;
+	GgitRepository *repo;
+	GgitOId *cid;
+	GgitOId *bid;
+	GgitOId *oids[2];
+	GType gtypes[2];
+	gsize sizes[2];
+	GType gtype;
+	gsize size;
+	const gchar *contents = "hello world\n";
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	cid = create_commit (repo, NULL, "a", "first\n");
+	bid = ggit_repository_create_blob_from_buffer (repo,
+	                                               contents,
+	                                               strlen (contents),
+	                                               &err);
+	g_assert_no_error (err);
+
+	g_assert (ggit_repository_read_object_header (repo, bid, &gtype, &size, &err));
+	g_assert_no_error (err);
+	g_assert (gtype == GGIT_TYPE_BLOB);
+	g_assert_cmpuint (size, ==, strlen (contents));
+
+	oids[0] = cid;
+	oids[1] = bid;
+
+	g_assert (ggit_repository_read_object_headers (repo, oids, 2, gtypes, sizes, &err));
+	g_assert_no_error (err);
+	g_assert (gtypes[0] == GGIT_TYPE_COMMIT);
+	g_assert (gtypes[1] == GGIT_TYPE_BLOB);
+	g_assert_cmpuint (sizes[1], ==, strlen (contents));
+
+	ggit_oid_free (bid);
+	ggit_oid_free (cid);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_blob_input_stream (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitBlobInputStream *stream;
+	GgitOId *oid;
+	GString *contents;
+	guchar buffer[7];
+	gssize n;
+	gint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	contents = g_string_new (NULL);
+
+	for (i = 0; i < 1000; ++i)
+	{
+		g_string_append_printf (contents, "line %d\n", i);
+	}
+
+	oid = ggit_repository_create_blob_from_buffer (repo,
+	                                               contents->str,
+	                                               contents->len,
+	                                               &err);
+	g_assert_no_error (err);
+
+	stream = ggit_repository_open_blob_stream (repo, oid, NULL, &err);
+	g_assert_no_error (err);
+	g_assert (stream != NULL);
+
+	g_assert_cmpuint (ggit_blob_input_stream_get_size (stream), ==, contents->len);
+	g_assert (!ggit_blob_input_stream_is_filtered (stream));
+
+	/* Read in small chunks to exercise partial reads */
+	i = 0;
+
+	while ((n = g_input_stream_read (G_INPUT_STREAM (stream),
+	                                 buffer,
+	                                 sizeof (buffer),
+	                                 NULL,
+	                                 &err)) > 0)
+	{
+		g_assert_cmpint (i + n, <=, contents->len);
+		g_assert_cmpint (memcmp (buffer, contents->str + i, n), ==, 0);
+		i += n;
+	}
+
+	g_assert_no_error (err);
+	g_assert_cmpint (i, ==, contents->len);
+
+	g_input_stream_close (G_INPUT_STREAM (stream), NULL, &err);
+	g_assert_no_error (err);
+	g_object_unref (stream);
+
+	stream = ggit_repository_open_blob_stream (repo, oid, "a.txt", &err);
+	g_assert_no_error (err);
+	g_assert_cmpuint (ggit_blob_input_stream_get_size (stream), ==, contents->len);
+	g_object_unref (stream);
+
+	g_string_free (contents, TRUE);
+	ggit_oid_free (oid);
+	g_object_unref (repo);
+}
+
+static void
+create_blobs_progress (guint    n_done,
+                       guint    n_total,
+                       guint64  bytes_done,
+                       gpointer user_data)
+{
+	guint *last = user_data;
+
+	g_assert_cmpuint (n_done, ==, *last + 1);
+	g_assert_cmpuint (n_total, ==, 8);
+
+	*last = n_done;
+}
+
+static void
+test_repository_create_blobs_from_files (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GFile *files[8];
+	GPtrArray *oids;
+	GCancellable *cancellable;
+	guint last = 0;
+	gint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+
+	g_assert_no_error (err);
+
+	for (i = 0; i < 8; ++i)
+	{
+		gchar *name;
+		gchar *contents;
+
+		name = g_strdup_printf ("file%d", i);
+		files[i] = g_file_get_child (f, name);
+		g_free (name);
+
+		/* Leave the first file empty */
+		contents = g_strnfill (i * 1000, 'a' + i);
+
+		g_file_replace_contents (files[i],
+		                         contents,
+		                         strlen (contents),
+		                         NULL,
+		                         FALSE,
+		                         G_FILE_CREATE_NONE,
+		                         NULL,
+		                         NULL,
+		                         &err);
+		g_assert_no_error (err);
+		g_free (contents);
+	}
+
+	oids = ggit_repository_create_blobs_from_files (repo,
+	                                                files,
+	                                                8,
+	                                                3,
+	                                                NULL,
+	                                                create_blobs_progress,
+	                                                &last,
+	                                                &err);
+	g_assert_no_error (err);
+	g_assert_cmpuint (oids->len, ==, 8);
+	g_assert_cmpuint (last, ==, 8);
+
+	for (i = 0; i < 8; ++i)
+	{
+		GgitOId *oid;
+
+		oid = ggit_repository_create_blob_from_file (repo, files[i], &err);
+		g_assert_no_error (err);
+		g_assert (ggit_oid_equal (oid, g_ptr_array_index (oids, i)));
+		ggit_oid_free (oid);
+	}
+
+	g_ptr_array_unref (oids);
+
+	cancellable = g_cancellable_new ();
+	g_cancellable_cancel (cancellable);
+
+	oids = ggit_repository_create_blobs_from_files (repo,
+	                                                files,
+	                                                8,
+	                                                0,
+	                                                cancellable,
+	                                                NULL,
+	                                                NULL,
+	                                                &err);
+	g_assert (oids == NULL);
+	g_assert_error (err, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_clear_error (&err);
+
+	g_object_unref (cancellable);
+
+	for (i = 0; i < 8; ++i)
+	{
+		g_object_unref (files[i]);
+	}
+
+	g_object_unref (f);
+	g_object_unref (repo);
+}
+
+static void
+close_async_cb (GObject      *source,
+                GAsyncResult *result,
+                gpointer      user_data)
+{
+	AsyncData *data = user_data;
+
+	g_output_stream_close_finish (G_OUTPUT_STREAM (source), result, &data->error);
+	g_main_loop_quit (data->loop);
+}
+
+static void
+test_repository_blob_stream_buffered (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitBlobOutputStream *stream;
+	GgitOId *expected;
+	GgitOId *oid;
+	AsyncData data = { 0, };
+	gsize sizes[] = { 1, 4096, 65536, 1024 * 1024 };
+	guint8 *contents;
+	gsize total = 0;
+	gsize offset = 0;
+	gsize i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	for (i = 0; i < G_N_ELEMENTS (sizes); ++i)
+	{
+		total += sizes[i] * 2;
+	}
+
+	contents = g_malloc (total);
+
+	for (i = 0; i < total; ++i)
+	{
+		contents[i] = i % 251;
+	}
+
+	expected = ggit_repository_create_blob_from_buffer (repo, contents, total, &err);
+	g_assert_no_error (err);
+
+	stream = ggit_repository_create_blob (repo);
+	g_assert_cmpuint (ggit_blob_output_stream_get_buffer_size (stream), >, 0);
+
+	for (i = 0; i < G_N_ELEMENTS (sizes); ++i)
+	{
+		g_output_stream_write_all (G_OUTPUT_STREAM (stream),
+		                           contents + offset,
+		                           sizes[i],
+		                           NULL,
+		                           NULL,
+		                           &err);
+		g_assert_no_error (err);
+		offset += sizes[i];
+	}
+
+#if GLIB_CHECK_VERSION (2, 60, 0)
+	{
+		GOutputVector vectors[G_N_ELEMENTS (sizes)];
+
+		for (i = 0; i < G_N_ELEMENTS (sizes); ++i)
+		{
+			vectors[i].buffer = contents + offset;
+			vectors[i].size = sizes[i];
+			offset += sizes[i];
+		}
+
+		g_output_stream_writev_all (G_OUTPUT_STREAM (stream),
+		                            vectors,
+		                            G_N_ELEMENTS (vectors),
+		                            NULL,
+		                            NULL,
+		                            &err);
+		g_assert_no_error (err);
+	}
+#else
+	g_output_stream_write_all (G_OUTPUT_STREAM (stream),
+	                           contents + offset,
+	                           total - offset,
+	                           NULL,
+	                           NULL,
+	                           &err);
+	g_assert_no_error (err);
+#endif
+
+	data.loop = g_main_loop_new (NULL, FALSE);
+
+	g_output_stream_close_async (G_OUTPUT_STREAM (stream),
+	                             G_PRIORITY_DEFAULT,
+	                             NULL,
+	                             close_async_cb,
+	                             &data);
+
+	g_main_loop_run (data.loop);
+	g_main_loop_unref (data.loop);
+
+	g_assert_no_error (data.error);
+
+	oid = ggit_blob_output_stream_get_id (stream, &err);
+	g_assert_no_error (err);
+	g_assert (ggit_oid_equal (oid, expected));
+
+	ggit_oid_free (oid);
+	ggit_oid_free (expected);
+	g_free (contents);
+
+	g_object_unref (stream);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_blob_stream_perf (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitOId *expected;
+	gsize chunk_sizes[] = { 4096, 65536, 1024 * 1024 };
+	guint buffer_sizes[] = { 0, 64 * 1024 };
+	gsize total = (g_test_perf () ? 64 : 4) * 1024 * 1024;
+	guint8 *contents;
+	gsize i;
+	gsize j;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	contents = g_malloc (total);
+
+	for (i = 0; i < total; ++i)
+	{
+		contents[i] = (i * 7) % 251;
+	}
+
+	expected = ggit_repository_create_blob_from_buffer (repo, contents, total, &err);
+	g_assert_no_error (err);
+
+	for (i = 0; i < G_N_ELEMENTS (chunk_sizes); ++i)
+	{
+		for (j = 0; j < G_N_ELEMENTS (buffer_sizes); ++j)
+		{
+			GgitBlobOutputStream *stream;
+			GgitOId *oid;
+			gsize offset;
+
+			stream = ggit_repository_create_blob (repo);
+			ggit_blob_output_stream_set_buffer_size (stream, buffer_sizes[j]);
+
+			g_test_timer_start ();
+
+			for (offset = 0; offset < total; offset += chunk_sizes[i])
+			{
+				g_output_stream_write_all (G_OUTPUT_STREAM (stream),
+				                           contents + offset,
+				                           MIN (chunk_sizes[i], total - offset),
+				                           NULL,
+				                           NULL,
+				                           &err);
+				g_assert_no_error (err);
+			}
+
+			g_output_stream_close (G_OUTPUT_STREAM (stream), NULL, &err);
+			g_assert_no_error (err);
+
+			g_test_minimized_result (g_test_timer_elapsed (),
+			                         "wrote %" G_GSIZE_FORMAT " bytes in chunks of %" G_GSIZE_FORMAT " with a %u byte buffer in %f seconds",
+			                         total,
+			                         chunk_sizes[i],
+			                         buffer_sizes[j],
+			                         g_test_timer_last ());
+
+			oid = ggit_blob_output_stream_get_id (stream, &err);
+			g_assert_no_error (err);
+			g_assert (ggit_oid_equal (oid, expected));
+
+			ggit_oid_free (oid);
+			g_object_unref (stream);
+		}
+	}
+
+	ggit_oid_free (expected);
+	g_free (contents);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_hash_file (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GFile *files[4];
+	GPtrArray *oids;
+	GgitOId *oid;
+	gint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+
+	g_assert_no_error (err);
+
+	for (i = 0; i < 4; ++i)
+	{
+		gchar *name;
+		gchar *contents;
+
+		name = g_strdup_printf ("hash%d", i);
+		files[i] = g_file_get_child (f, name);
+		g_free (name);
+
+		contents = g_strdup_printf ("contents %d\n", i);
+
+		g_file_replace_contents (files[i],
+		                         contents,
+		                         strlen (contents),
+		                         NULL,
+		                         FALSE,
+		                         G_FILE_CREATE_NONE,
+		                         NULL,
+		                         NULL,
+		                         &err);
+		g_assert_no_error (err);
+		g_free (contents);
+	}
+
+	oids = ggit_repository_hash_files (repo, files, 4, 2, NULL, &err);
+	g_assert_no_error (err);
+	g_assert_cmpuint (oids->len, ==, 4);
+
+	for (i = 0; i < 4; ++i)
+	{
+		GgitOId *hashed;
+		GgitOId *buffered;
+		GgitOId *written;
+		gchar *contents;
+		gsize len;
+		GgitObject *obj;
+
+		hashed = ggit_repository_hash_file (repo, files[i], NULL, &err);
+		g_assert_no_error (err);
+		g_assert (ggit_oid_equal (hashed, g_ptr_array_index (oids, i)));
+
+		/* Hashing does not write the object */
+		obj = ggit_repository_lookup (repo, hashed, GGIT_TYPE_BLOB, &err);
+		g_assert (obj == NULL);
+		g_clear_error (&err);
+
+		g_file_load_contents (files[i], NULL, &contents, &len, NULL, &err);
+		g_assert_no_error (err);
+
+		buffered = ggit_repository_hash_buffer (repo, contents, len, &err);
+		g_assert_no_error (err);
+		g_assert (ggit_oid_equal (hashed, buffered));
+
+		written = ggit_repository_create_blob_from_buffer (repo, contents, len, &err);
+		g_assert_no_error (err);
+		g_assert (ggit_oid_equal (hashed, written));
+
+		g_free (contents);
+		ggit_oid_free (written);
+		ggit_oid_free (buffered);
+		ggit_oid_free (hashed);
+	}
+
+	g_ptr_array_unref (oids);
+
+	/* Files without a local path cannot be hashed */
+	g_object_unref (files[3]);
+	files[3] = g_file_new_for_uri ("resource:///org/gnome/libgit2-glib/none");
+
+	oid = ggit_repository_hash_file (repo, files[3], NULL, &err);
+	g_assert (oid == NULL);
+	g_assert_error (err, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED);
+	g_clear_error (&err);
+
+	oids = ggit_repository_hash_files (repo, files, 4, 2, NULL, &err);
+	g_assert (oids == NULL);
+	g_assert_error (err, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED);
+	g_clear_error (&err);
+
+	for (i = 0; i < 4; ++i)
+	{
+		g_object_unref (files[i]);
+	}
+
+	g_object_unref (f);
+	g_object_unref (repo);
+}
+
+static GgitTree *
+create_nested_tree (GgitRepository *repo,
+                    const gchar    *git_dir)
+{
+	GError *err = NULL;
+	GgitOId *cids[3];
+	GgitCommit *commit;
+	GgitTree *tree;
+	gchar *path;
+	gint i;
+
+	path = g_build_filename (git_dir, "d", "e", NULL);
+	g_assert_cmpint (g_mkdir_with_parents (path, 0755), ==, 0);
+	g_free (path);
+
+	cids[0] = create_commit (repo, NULL, "a", "a\n");
+	cids[1] = create_commit (repo, cids[0], "d/b", "b\n");
+	cids[2] = create_commit (repo, cids[1], "d/e/c", "c\n");
+
+	commit = ggit_repository_lookup_commit (repo, cids[2], &err);
+	g_assert_no_error (err);
+
+	tree = ggit_commit_get_tree (commit);
+	g_object_unref (commit);
+
+	for (i = 0; i < 3; ++i)
+	{
+		ggit_oid_free (cids[i]);
+	}
+
+	return tree;
+}
+
+static gchar *
+iterate_tree (GgitTree         *tree,
+              GgitTreeWalkMode  mode,
+              const gchar      *skip)
+{
+	GgitTreeIterator *iter;
+	GError *err = NULL;
+	GString *ret;
+
+	ret = g_string_new (NULL);
+	iter = ggit_tree_iterator_new (tree, mode);
+
+	while (ggit_tree_iterator_next (iter, &err))
+	{
+		g_assert (ggit_tree_iterator_get_raw_id (iter) != NULL);
+
+		g_string_append_printf (ret, "%s%s:%u ",
+		                        ggit_tree_iterator_get_root (iter),
+		                        ggit_tree_iterator_get_name (iter),
+		                        ggit_tree_iterator_get_depth (iter));
+
+		if (g_strcmp0 (ggit_tree_iterator_get_name (iter), skip) == 0)
+		{
+			ggit_tree_iterator_skip_subtree (iter);
+		}
+	}
+
+	g_assert_no_error (err);
+	ggit_tree_iterator_unref (iter);
+
+	return g_string_free (ret, FALSE);
+}
+
+static void
+test_repository_tree_iterator (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitTree *tree;
+	gchar *order;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	tree = create_nested_tree (repo, git_dir);
+
+	order = iterate_tree (tree, GGIT_TREE_WALK_MODE_PRE, NULL);
+	g_assert_cmpstr (order, ==, "a:0 d:0 d/b:1 d/e:1 d/e/c:2 ");
+	g_free (order);
+
+	order = iterate_tree (tree, GGIT_TREE_WALK_MODE_PRE, "e");
+	g_assert_cmpstr (order, ==, "a:0 d:0 d/b:1 d/e:1 ");
+	g_free (order);
+
+	order = iterate_tree (tree, GGIT_TREE_WALK_MODE_POST, NULL);
+	g_assert_cmpstr (order, ==, "a:0 d/b:1 d/e/c:2 d/e:1 d:0 ");
+	g_free (order);
+
+	g_object_unref (tree);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_tree_get_by_paths (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitTree *tree;
+	GPtrArray *entries;
+	const gchar *paths[] = { "d/e/c", "a", "missing", "d/b", "d/x/y", "d/e", "a/b", "d/", "d/e/", "a/", NULL };
+	const gchar *names[] = { "c", "a", NULL, "b", NULL, "e", NULL, "d", "e", NULL };
+	guint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	tree = create_nested_tree (repo, git_dir);
+
+	entries = ggit_tree_get_by_paths (tree, paths, &err);
+	g_assert_no_error (err);
+	g_assert_cmpuint (entries->len, ==, G_N_ELEMENTS (names));
+
+	for (i = 0; i < entries->len; ++i)
+	{
+		GgitTreeEntry *entry = g_ptr_array_index (entries, i);
+
+		if (names[i] == NULL)
+		{
+			g_assert (entry == NULL);
+		}
+		else
+		{
+			GgitTreeEntry *expected;
+			GgitOId *a;
+			GgitOId *b;
+
+			g_assert (entry != NULL);
+			g_assert_cmpstr (ggit_tree_entry_get_name (entry), ==, names[i]);
+
+			expected = ggit_tree_get_by_path (tree, paths[i], &err);
+			g_assert_no_error (err);
+
+			a = ggit_tree_entry_get_id (entry);
+			b = ggit_tree_entry_get_id (expected);
+			g_assert (ggit_oid_equal (a, b));
+
+			ggit_oid_free (a);
+			ggit_oid_free (b);
+			ggit_tree_entry_unref (expected);
+		}
+	}
+
+	g_ptr_array_unref (entries);
+	g_object_unref (tree);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_tree_create_updated (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitTree *tree;
+	GgitTree *updated;
+	GgitTreeUpdates *updates;
+	GgitTreeEntry *entry;
+	GgitOId *blob;
+	GgitOId *oid;
+	GgitOId *id;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	tree = create_nested_tree (repo, git_dir);
+
+	blob = ggit_repository_create_blob_from_buffer (repo, "new\n", 4, &err);
+	g_assert_no_error (err);
+
+	updates = ggit_tree_updates_new ();
+	ggit_tree_updates_upsert (updates, "d/e/new", blob, GGIT_FILE_MODE_BLOB);
+	ggit_tree_updates_upsert (updates, "x/y/z", blob, GGIT_FILE_MODE_BLOB_EXECUTABLE);
+	ggit_tree_updates_remove (updates, "a");
+	g_assert_cmpuint (ggit_tree_updates_get_size (updates), ==, 3);
+
+	oid = ggit_tree_create_updated (tree, updates, &err);
+	g_assert_no_error (err);
+	ggit_tree_updates_unref (updates);
+
+	updated = ggit_repository_lookup_tree (repo, oid, &err);
+	g_assert_no_error (err);
+
+	entry = ggit_tree_get_by_path (updated, "d/e/new", &err);
+	g_assert_no_error (err);
+	id = ggit_tree_entry_get_id (entry);
+	g_assert (ggit_oid_equal (id, blob));
+	ggit_oid_free (id);
+	ggit_tree_entry_unref (entry);
+
+	entry = ggit_tree_get_by_path (updated, "x/y/z", &err);
+	g_assert_no_error (err);
+	g_assert_cmpint (ggit_tree_entry_get_file_mode (entry), ==, GGIT_FILE_MODE_BLOB_EXECUTABLE);
+	ggit_tree_entry_unref (entry);
+
+	entry = ggit_tree_get_by_path (updated, "d/e/c", &err);
+	g_assert_no_error (err);
+	ggit_tree_entry_unref (entry);
+
+	entry = ggit_tree_get_by_path (updated, "a", &err);
+	g_assert (entry == NULL);
+	g_clear_error (&err);
+
+	ggit_oid_free (oid);
+	ggit_oid_free (blob);
+	g_object_unref (updated);
+	g_object_unref (tree);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_index_snapshot (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitIndex *idx;
+	GgitIndexEntries *entries;
+	GgitIndexSnapshot *snapshot;
+	GgitTree *tree;
+	guint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	tree = create_nested_tree (repo, git_dir);
+	g_object_unref (tree);
+
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	entries = ggit_index_get_entries (idx);
+	snapshot = ggit_index_get_snapshot (idx);
+
+	g_assert_cmpuint (ggit_index_snapshot_size (snapshot), ==, 3);
+	g_assert_cmpuint (ggit_index_snapshot_size (snapshot), ==, ggit_index_entries_size (entries));
+
+	for (i = 0; i < ggit_index_snapshot_size (snapshot); ++i)
+	{
+		GgitIndexEntry *entry;
+		GgitOId *a;
+		GgitOId *b;
+		const gchar *path;
+
+		entry = ggit_index_entries_get_by_index (entries, i);
+		path = ggit_index_snapshot_get_path (snapshot, i);
+
+		g_assert_cmpstr (path, ==, ggit_index_entry_get_path (entry));
+		g_assert_cmpuint (ggit_index_snapshot_get_mode (snapshot, i), ==, ggit_index_entry_get_mode (entry));
+		g_assert_cmpint (ggit_index_snapshot_get_file_size (snapshot, i), ==, ggit_index_entry_get_file_size (entry));
+		g_assert_cmpint (ggit_index_snapshot_get_stage (snapshot, i), ==, 0);
+
+		a = ggit_index_snapshot_get_id (snapshot, i);
+		b = ggit_index_entry_get_id (entry);
+		g_assert (ggit_oid_equal (a, b));
+		ggit_oid_free (a);
+
+		a = ggit_oid_new_from_raw (ggit_index_snapshot_get_raw_id (snapshot, i));
+		g_assert (ggit_oid_equal (a, b));
+
+		g_assert_cmpint (ggit_index_snapshot_find (snapshot, path, 0), ==, i);
+		g_assert_cmpint (ggit_index_snapshot_find (snapshot, path, -1), ==, i);
+		g_assert_cmpint (ggit_index_snapshot_find (snapshot, path, 1), ==, -1);
+
+		ggit_oid_free (a);
+		ggit_oid_free (b);
+		ggit_index_entry_unref (entry);
+	}
+
+	g_assert_cmpint (ggit_index_snapshot_find (snapshot, "d", -1), ==, -1);
+	g_assert_cmpint (ggit_index_snapshot_find (snapshot, "zzz", -1), ==, -1);
+
+	ggit_index_snapshot_unref (snapshot);
+	ggit_index_entries_unref (entries);
+	g_object_unref (idx);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_index_snapshot_perf (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitIndex *idx;
+	GgitIndexEntries *entries;
+	GgitIndexSnapshot *snapshot;
+	GgitOId *blob_id;
+	guint n = g_test_perf () ? 400000 : 10000;
+	gsize path_bytes;
+	guint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	blob_id = ggit_repository_create_blob_from_buffer (repo, "x\n", 2, &err);
+	g_assert_no_error (err);
+
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	/* Added in sorted order so every insertion appends */
+	for (i = 0; i < n; ++i)
+	{
+		GgitIndexEntry *entry;
+		gchar *path;
+
+		path = g_strdup_printf ("dir%04u/file%07u.txt", i / 1000, i);
+
+		entry = ggit_repository_create_index_entry_for_path (repo, path, blob_id, &err);
+		g_assert_no_error (err);
+
+		ggit_index_entry_set_mode (entry, 0100644);
+
+		ggit_index_add (idx, entry, &err);
+		g_assert_no_error (err);
+
+		ggit_index_entry_unref (entry);
+		g_free (path);
+	}
+
+	/* One wrapper per entry through the enumerator */
+	path_bytes = 0;
+	g_test_timer_start ();
+
+	entries = ggit_index_get_entries (idx);
+
+	for (i = 0; i < ggit_index_entries_size (entries); ++i)
+	{
+		GgitIndexEntry *entry;
+		GgitOId *id;
+
+		entry = ggit_index_entries_get_by_index (entries, i);
+		id = ggit_index_entry_get_id (entry);
+
+		path_bytes += strlen (ggit_index_entry_get_path (entry));
+
+		ggit_oid_free (id);
+		ggit_index_entry_unref (entry);
+	}
+
+	ggit_index_entries_unref (entries);
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "enumerated %u index entries in %f seconds",
+	                         n,
+	                         g_test_timer_last ());
+
+	g_assert_cmpuint (path_bytes, >, 0);
+
+	/* Taking a snapshot and reading its columns */
+	g_test_timer_start ();
+
+	snapshot = ggit_index_get_snapshot (idx);
+
+	for (i = 0; i < ggit_index_snapshot_size (snapshot); ++i)
+	{
+		g_assert (ggit_index_snapshot_get_raw_id (snapshot, i) != NULL);
+		path_bytes -= strlen (ggit_index_snapshot_get_path (snapshot, i));
+	}
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "snapshotted and read %u index entries in %f seconds",
+	                         n,
+	                         g_test_timer_last ());
+
+	g_assert_cmpuint (ggit_index_snapshot_size (snapshot), ==, n);
+	g_assert_cmpuint (path_bytes, ==, 0);
+
+	ggit_index_snapshot_unref (snapshot);
+	ggit_oid_free (blob_id);
+	g_object_unref (idx);
+	g_object_unref (repo);
+}
+
+static gint
+index_matched_path_cb (const gchar *path,
+                       const gchar *matched_pathspec,
+                       gpointer     user_data)
+{
+	guint *n_matched = user_data;
+
+	++*n_matched;
+
+	/* skip b.txt */
+	return g_strcmp0 (path, "b.txt") == 0 ? 1 : 0;
+}
+
+typedef struct
+{
+	GgitRepository *repo;
+	GPtrArray *oids;
+	guint n_calls;
+	gboolean written_before_callback;
+} PrehashCheckData;
+
+static gint
+prehash_check_cb (const gchar *path,
+                  const gchar *matched_pathspec,
+                  gpointer     user_data)
+{
+	PrehashCheckData *data = user_data;
+	guint i;
+
+	++data->n_calls;
+
+	for (i = 0; i < data->oids->len; ++i)
+	{
+		if (ggit_repository_read_object_header (data->repo,
+		                                        g_ptr_array_index (data->oids, i),
+		                                        NULL,
+		                                        NULL,
+		                                        NULL))
+		{
+			data->written_before_callback = TRUE;
+		}
+	}
+
+	return g_strcmp0 (path, "skip.dat") == 0 ? 1 : 0;
+}
+
+static void
+write_workdir_file (const gchar *git_dir,
+                    const gchar *name,
+                    const gchar *contents)
+{
+	GError *err = NULL;
+	gchar *path;
+
+	path = g_build_filename (git_dir, name, NULL);
+	g_file_set_contents (path, contents, -1, &err);
+	g_assert_no_error (err);
+	g_free (path);
+}
+
+static void
+test_repository_index_add_all (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitIndex *idx;
+	GgitIndexSnapshot *snapshot;
+	GgitOId *expected;
+	GgitOId *oid;
+	GFile *file;
+	gchar *path;
+	const gchar *txt[] = { "*.txt", NULL };
+	const gchar *bin[] = { "*.bin", NULL };
+	PrehashCheckData check = { NULL, };
+	guint n_matched = 0;
+	gint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	write_workdir_file (git_dir, "a.txt", "a\n");
+	write_workdir_file (git_dir, "b.txt", "b\n");
+	write_workdir_file (git_dir, "c.dat", "c\n");
+
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	ggit_index_add_all (idx, txt, GGIT_INDEX_ADD_DEFAULT, index_matched_path_cb, &n_matched, &err);
+	g_assert_no_error (err);
+	g_assert_cmpuint (n_matched, ==, 2);
+
+	snapshot = ggit_index_get_snapshot (idx);
+	g_assert_cmpuint (ggit_index_snapshot_size (snapshot), ==, 1);
+	g_assert_cmpint (ggit_index_snapshot_find (snapshot, "a.txt", 0), ==, 0);
+	ggit_index_snapshot_unref (snapshot);
+
+	/* Without the pre-pass, each file is written right after it matched */
+	write_workdir_file (git_dir, "x1.bin", "x1\n");
+	write_workdir_file (git_dir, "x2.bin", "x2\n");
+
+	check.repo = repo;
+	check.oids = g_ptr_array_new_with_free_func ((GDestroyNotify)ggit_oid_free);
+	g_ptr_array_add (check.oids, ggit_repository_hash_buffer (repo, "x1\n", 3, NULL));
+	g_ptr_array_add (check.oids, ggit_repository_hash_buffer (repo, "x2\n", 3, NULL));
+
+	ggit_index_add_all (idx, bin, GGIT_INDEX_ADD_DEFAULT, prehash_check_cb, &check, &err);
+	g_assert_no_error (err);
+	g_assert_cmpuint (check.n_calls, ==, 2);
+	g_assert (check.written_before_callback);
+
+	/* With it, all the files are matched before the pool writes them,
+	 * and files skipped by the callback are not written at all */
+	write_workdir_file (git_dir, "skip.dat", "skip\n");
+
+	check.n_calls = 0;
+	check.written_before_callback = FALSE;
+	g_ptr_array_set_size (check.oids, 0);
+	g_ptr_array_add (check.oids, ggit_repository_hash_buffer (repo, "b\n", 2, NULL));
+	g_ptr_array_add (check.oids, ggit_repository_hash_buffer (repo, "c\n", 2, NULL));
+	g_ptr_array_add (check.oids, ggit_repository_hash_buffer (repo, "skip\n", 5, NULL));
+
+	ggit_index_add_all (idx, NULL, GGIT_INDEX_ADD_PARALLEL_HASH, prehash_check_cb, &check, &err);
+	g_assert_no_error (err);
+	g_assert_cmpuint (check.n_calls, ==, 3);
+	g_assert (!check.written_before_callback);
+
+	for (i = 0; i < 3; ++i)
+	{
+		gboolean exists;
+
+		exists = ggit_repository_read_object_header (repo,
+		                                             g_ptr_array_index (check.oids, i),
+		                                             NULL,
+		                                             NULL,
+		                                             &err);
+
+		/* skip.dat */
+		g_assert (exists == (i != 2));
+		g_clear_error (&err);
+	}
+
+	snapshot = ggit_index_get_snapshot (idx);
+	g_assert_cmpuint (ggit_index_snapshot_size (snapshot), ==, 5);
+	g_assert_cmpint (ggit_index_snapshot_find (snapshot, "skip.dat", 0), ==, -1);
+
+	i = ggit_index_snapshot_find (snapshot, "c.dat", 0);
+	g_assert_cmpint (i, >=, 0);
+
+	oid = ggit_index_snapshot_get_id (snapshot, i);
+	g_assert (ggit_oid_equal (oid, g_ptr_array_index (check.oids, 1)));
+	ggit_oid_free (oid);
+	ggit_index_snapshot_unref (snapshot);
+
+	/* The entries carry the stat data of the files */
+	ggit_index_write (idx, &err);
+	g_assert_no_error (err);
+
+	f = g_file_new_for_path (git_dir);
+	file = g_file_get_child (f, "c.dat");
+	g_object_unref (f);
+
+	g_assert_cmpuint (ggit_repository_file_status (repo, file, &err), ==, GGIT_STATUS_INDEX_NEW);
+	g_assert_no_error (err);
+	g_object_unref (file);
+
+	/* Deleted files are removed, as without the flag */
+	path = g_build_filename (git_dir, "x1.bin", NULL);
+	g_assert_cmpint (g_unlink (path), ==, 0);
+	g_free (path);
+
+	ggit_index_add_all (idx, bin, GGIT_INDEX_ADD_PARALLEL_HASH, NULL, NULL, &err);
+	g_assert_no_error (err);
+
+	snapshot = ggit_index_get_snapshot (idx);
+	g_assert_cmpuint (ggit_index_snapshot_size (snapshot), ==, 4);
+	g_assert_cmpint (ggit_index_snapshot_find (snapshot, "x1.bin", 0), ==, -1);
+	g_assert_cmpint (ggit_index_snapshot_find (snapshot, "x2.bin", 0), >=, 0);
+	ggit_index_snapshot_unref (snapshot);
+
+	g_ptr_array_unref (check.oids);
+
+	write_workdir_file (git_dir, "a.txt", "aa\n");
+
+	ggit_index_update_all (idx, NULL, NULL, NULL, &err);
+	g_assert_no_error (err);
+
+	expected = ggit_repository_hash_buffer (repo, "aa\n", 3, &err);
+	g_assert_no_error (err);
+
+	snapshot = ggit_index_get_snapshot (idx);
+	i = ggit_index_snapshot_find (snapshot, "a.txt", 0);
+	g_assert_cmpint (i, >=, 0);
+
+	oid = ggit_index_snapshot_get_id (snapshot, i);
+	g_assert (ggit_oid_equal (oid, expected));
+	ggit_oid_free (oid);
+	ggit_oid_free (expected);
+	ggit_index_snapshot_unref (snapshot);
+
+	n_matched = 0;
+	ggit_index_remove_all (idx, txt, index_matched_path_cb, &n_matched, &err);
+	g_assert_no_error (err);
+	g_assert_cmpuint (n_matched, ==, 2);
+
+	snapshot = ggit_index_get_snapshot (idx);
+	g_assert_cmpuint (ggit_index_snapshot_size (snapshot), ==, 3);
+	g_assert_cmpint (ggit_index_snapshot_find (snapshot, "a.txt", 0), ==, -1);
+	g_assert_cmpint (ggit_index_snapshot_find (snapshot, "b.txt", 0), >=, 0);
+	ggit_index_snapshot_unref (snapshot);
+
+	g_object_unref (idx);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_index_add_all_perf (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitIndex *idx;
+	GgitIndexEntries *entries;
+	gchar *dir;
+	const gchar *serial[] = { "serial", NULL };
+	const gchar *parallel[] = { "parallel", NULL };
+	guint n = g_test_perf () ? 20000 : 1000;
+	guint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	dir = g_build_filename (git_dir, "serial", NULL);
+	g_assert_cmpint (g_mkdir (dir, 0755), ==, 0);
+	g_free (dir);
+
+	dir = g_build_filename (git_dir, "parallel", NULL);
+	g_assert_cmpint (g_mkdir (dir, 0755), ==, 0);
+	g_free (dir);
+
+	/* Different contents in both directories, so that neither run finds
+	 * the blobs of the other in the object database */
+	for (i = 0; i < n; ++i)
+	{
+		gchar *name;
+		gchar *contents;
+
+		contents = g_strdup_printf ("serial %u\n", i);
+		name = g_strdup_printf ("serial/file%u.txt", i);
+		write_workdir_file (git_dir, name, contents);
+		g_free (name);
+		g_free (contents);
+
+		contents = g_strdup_printf ("parallel %u\n", i);
+		name = g_strdup_printf ("parallel/file%u.txt", i);
+		write_workdir_file (git_dir, name, contents);
+		g_free (name);
+		g_free (contents);
+	}
+
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	g_test_timer_start ();
+
+	ggit_index_add_all (idx, serial, GGIT_INDEX_ADD_DEFAULT, NULL, NULL, &err);
+	g_assert_no_error (err);
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "added %u files in %f seconds",
+	                         n,
+	                         g_test_timer_last ());
+
+	g_test_timer_start ();
+
+	ggit_index_add_all (idx, parallel, GGIT_INDEX_ADD_PARALLEL_HASH, NULL, NULL, &err);
+	g_assert_no_error (err);
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "added %u files with parallel hashing in %f seconds",
+	                         n,
+	                         g_test_timer_last ());
+
+	entries = ggit_index_get_entries (idx);
+	g_assert_cmpuint (ggit_index_entries_size (entries), ==, 2 * n);
+	ggit_index_entries_unref (entries);
+
+	g_object_unref (idx);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_index_reload (const gchar *git_dir)
+{
+	GFile *f;
+	GFile *index_file;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitIndex *idx;
+	GgitIndex *other;
+	GgitIndexSnapshot *snapshot;
+	GgitIndexEntry *entry;
+	GgitOId *blob_id;
+	gchar *path;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	write_workdir_file (git_dir, "a.txt", "a\n");
+	write_workdir_file (git_dir, "b.txt", "b\n");
+
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	ggit_index_add_path (idx, "a.txt", &err);
+	g_assert_no_error (err);
+
+	ggit_index_write (idx, &err);
+	g_assert_no_error (err);
+
+	g_assert (!ggit_index_has_changed (idx));
+
+	ggit_index_reload (idx, &err);
+	g_assert_no_error (err);
+
+	ggit_index_reload (idx, &err);
+	g_assert_no_error (err);
+
+	g_assert_cmpuint (ggit_index_get_reloads_avoided (idx), ==, 2);
+
+	/* Change the index file behind the back of idx */
+	path = g_build_filename (git_dir, ".git", "index", NULL);
+	index_file = g_file_new_for_path (path);
+	g_free (path);
+
+	other = ggit_index_open (index_file, &err);
+	g_assert_no_error (err);
+
+	snapshot = ggit_index_get_snapshot (idx);
+	g_assert_cmpuint (ggit_index_snapshot_size (snapshot), ==, 1);
+	ggit_index_snapshot_unref (snapshot);
+
+	ggit_index_remove_all (other, NULL, NULL, NULL, &err);
+	g_assert_no_error (err);
+
+	ggit_index_write (other, &err);
+	g_assert_no_error (err);
+	g_object_unref (other);
+
+	g_assert (ggit_index_has_changed (idx));
+
+	ggit_index_reload (idx, &err);
+	g_assert_no_error (err);
+
+	g_assert (!ggit_index_has_changed (idx));
+	g_assert_cmpuint (ggit_index_get_reloads_avoided (idx), ==, 2);
+
+	snapshot = ggit_index_get_snapshot (idx);
+	g_assert_cmpuint (ggit_index_snapshot_size (snapshot), ==, 0);
+	ggit_index_snapshot_unref (snapshot);
+
+	g_object_unref (idx);
+
+	/* The repository index is stamped when it is handed out */
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	g_assert (!ggit_index_has_changed (idx));
+
+	ggit_index_reload (idx, &err);
+	g_assert_no_error (err);
+
+	g_assert_cmpuint (ggit_index_get_reloads_avoided (idx), ==, 1);
+
+	g_object_unref (idx);
+
+	/* libgit2 keeps the repository index loaded, an external write in
+	 * the meantime is picked up when it is handed out again */
+	other = ggit_index_open (index_file, &err);
+	g_assert_no_error (err);
+
+	blob_id = ggit_repository_create_blob_from_buffer (repo, "b\n", 2, &err);
+	g_assert_no_error (err);
+
+	entry = ggit_repository_create_index_entry_for_path (repo, "b.txt", blob_id, &err);
+	g_assert_no_error (err);
+
+	ggit_index_add (other, entry, &err);
+	g_assert_no_error (err);
+
+	ggit_index_write (other, &err);
+	g_assert_no_error (err);
+
+	ggit_index_entry_unref (entry);
+	ggit_oid_free (blob_id);
+	g_object_unref (other);
+
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	g_assert (!ggit_index_has_changed (idx));
+
+	snapshot = ggit_index_get_snapshot (idx);
+	g_assert_cmpuint (ggit_index_snapshot_size (snapshot), ==, 1);
+	g_assert_cmpint (ggit_index_snapshot_find (snapshot, "b.txt", 0), ==, 0);
+	ggit_index_snapshot_unref (snapshot);
+
+	g_object_unref (idx);
+	g_object_unref (index_file);
+	g_object_unref (repo);
+}
+
+static void
+test_repository_status_list (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitIndex *idx;
+	GgitOId *parent;
+	GgitOId *oid;
+	GgitStatusOptions *options;
+	GgitStatusList *list;
+	const gchar *a[] = { "a.txt", NULL };
+	const gchar *contents = "the contents of a file which is going to be renamed\n";
+	gboolean seen_b = FALSE;
+	gboolean seen_c = FALSE;
+	gboolean seen_moved = FALSE;
+	gsize i;
+	gchar *path;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	parent = create_commit (repo, NULL, "a.txt", contents);
+	oid = create_commit (repo, parent, "b.txt", "b\n");
+	ggit_oid_free (parent);
+	ggit_oid_free (oid);
+
+	/* Stage a rename of a.txt to moved.txt */
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	path = g_build_filename (git_dir, "a.txt", NULL);
+	g_unlink (path);
+	g_free (path);
+
+	write_workdir_file (git_dir, "moved.txt", contents);
+
+	ggit_index_remove_all (idx, a, NULL, NULL, &err);
+	g_assert_no_error (err);
+
+	ggit_index_add_path (idx, "moved.txt", &err);
+	g_assert_no_error (err);
+
+	ggit_index_write (idx, &err);
+	g_assert_no_error (err);
+	g_object_unref (idx);
+
+	write_workdir_file (git_dir, "b.txt", "bb\n");
+	write_workdir_file (git_dir, "c.txt", "c\n");
+
+	options = ggit_status_options_new (GGIT_STATUS_OPTION_DEFAULT |
+	                                   GGIT_STATUS_OPTION_RENAMES_HEAD_TO_INDEX,
+	                                   GGIT_STATUS_SHOW_INDEX_AND_WORKDIR,
+	                                   NULL);
+
+	list = ggit_repository_get_status_list (repo, options, &err);
+	g_assert_no_error (err);
+	ggit_status_options_free (options);
+
+	g_assert_cmpuint (ggit_status_list_get_size (list), ==, 3);
+	g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (list)), ==, 3);
+	g_assert (g_list_model_get_item_type (G_LIST_MODEL (list)) == GGIT_TYPE_STATUS_ENTRY);
+	g_assert (g_list_model_get_item (G_LIST_MODEL (list), 3) == NULL);
+
+	for (i = 0; i < ggit_status_list_get_size (list); ++i)
+	{
+		GgitStatusEntry *entry;
+		GgitDiffDelta *delta;
+		const gchar *entry_path;
+
+		entry = g_list_model_get_item (G_LIST_MODEL (list), i);
+		entry_path = ggit_status_entry_get_path (entry);
+
+		g_assert_cmpstr (entry_path, ==, ggit_status_list_get_path (list, i));
+		g_assert_cmpuint (ggit_status_entry_get_index (entry), ==, i);
+
+		if (g_strcmp0 (entry_path, "b.txt") == 0)
+		{
+			seen_b = TRUE;
+
+			g_assert_cmpuint (ggit_status_entry_get_status (entry), ==, GGIT_STATUS_WORKING_TREE_MODIFIED);
+			g_assert (ggit_status_entry_get_head_to_index (entry) == NULL);
+			g_assert (ggit_status_entry_get_renamed_from (entry) == NULL);
+
+			delta = ggit_status_entry_get_index_to_workdir (entry);
+			g_assert (delta != NULL);
+			g_assert_cmpint (ggit_diff_delta_get_status (delta), ==, GGIT_DELTA_MODIFIED);
+			ggit_diff_delta_unref (delta);
+		}
+		else if (g_strcmp0 (entry_path, "c.txt") == 0)
+		{
+			seen_c = TRUE;
+
+			g_assert_cmpuint (ggit_status_entry_get_status (entry), ==, GGIT_STATUS_WORKING_TREE_NEW);
+		}
+		else if (g_strcmp0 (entry_path, "moved.txt") == 0)
+		{
+			seen_moved = TRUE;
+
+			g_assert_cmpuint (ggit_status_entry_get_status (entry), ==, GGIT_STATUS_INDEX_RENAMED);
+			g_assert_cmpstr (ggit_status_entry_get_renamed_from (entry), ==, "a.txt");
+
+			delta = ggit_status_list_get_head_to_index (list, i);
+			g_assert (delta != NULL);
+			g_assert_cmpint (ggit_diff_delta_get_status (delta), ==, GGIT_DELTA_RENAMED);
+			g_assert_cmpuint (ggit_diff_delta_get_similarity (delta), ==, 100);
+			ggit_diff_delta_unref (delta);
+		}
+
+		g_object_unref (entry);
+	}
+
+	g_assert (seen_b && seen_c && seen_moved);
+
+	g_object_unref (list);
+	g_object_unref (repo);
+}
+
+static void
+status_monitor_changed_cb (GgitStatusMonitor  *monitor,
+                           gchar             **paths,
+                           GgitStatusList     *status_list,
+                           GPtrArray          *changed)
+{
+	for (; *paths != NULL; ++paths)
+	{
+		g_ptr_array_add (changed, g_strdup (*paths));
+	}
+}
+
+static gboolean
+str_ptr_array_contains (GPtrArray   *array,
+                        const gchar *str)
+{
+	guint i;
+
+	for (i = 0; i < array->len; ++i)
+	{
+		if (g_strcmp0 (g_ptr_array_index (array, i), str) == 0)
+		{
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static void
+assert_status_monitor_matches_rescan (GgitStatusMonitor *monitor)
+{
+	GError *err = NULL;
+	GgitStatusList *list;
+	gsize i;
+
+	list = ggit_repository_get_status_list (ggit_status_monitor_get_repository (monitor),
+	                                        NULL,
+	                                        &err);
+	g_assert_no_error (err);
+
+	for (i = 0; i < ggit_status_list_get_size (list); ++i)
+	{
+		g_assert_cmpuint (ggit_status_monitor_get_status (monitor, ggit_status_list_get_path (list, i)),
+		                  ==,
+		                  ggit_status_list_get_status (list, i));
+	}
+
+	g_object_unref (list);
+}
+
+static void
+test_repository_status_monitor (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitStatusMonitor *monitor;
+	GgitOId *oid;
+	GPtrArray *changed;
+	gchar *path;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	oid = create_commit (repo, NULL, "a.txt", "a\n");
+	ggit_oid_free (oid);
+
+	write_workdir_file (git_dir, "u.txt", "u\n");
+
+	monitor = ggit_status_monitor_new (repo, &err);
+	g_assert_no_error (err);
+
+	g_assert_cmpuint (ggit_status_monitor_get_status (monitor, "a.txt"), ==, GGIT_STATUS_CURRENT);
+	g_assert_cmpuint (ggit_status_monitor_get_status (monitor, "u.txt"), ==, GGIT_STATUS_WORKING_TREE_NEW);
+
+	changed = g_ptr_array_new_with_free_func (g_free);
+	g_signal_connect (monitor, "changed", G_CALLBACK (status_monitor_changed_cb), changed);
+
+	/* Only the dirty paths are refreshed */
+	write_workdir_file (git_dir, "a.txt", "aa\n");
+	write_workdir_file (git_dir, "b.txt", "b\n");
+
+	ggit_status_monitor_mark_dirty (monitor, "a.txt");
+	ggit_status_monitor_refresh (monitor, &err);
+	g_assert_no_error (err);
+
+	g_assert_cmpuint (changed->len, ==, 1);
+	g_assert (str_ptr_array_contains (changed, "a.txt"));
+	g_assert_cmpuint (ggit_status_monitor_get_status (monitor, "a.txt"), ==, GGIT_STATUS_WORKING_TREE_MODIFIED);
+	g_assert_cmpuint (ggit_status_monitor_get_status (monitor, "b.txt"), ==, GGIT_STATUS_CURRENT);
+
+	ggit_status_monitor_mark_dirty (monitor, "b.txt");
+	ggit_status_monitor_refresh (monitor, &err);
+	g_assert_no_error (err);
+
+	g_assert (str_ptr_array_contains (changed, "b.txt"));
+	assert_status_monitor_matches_rescan (monitor);
+
+	/* Files becoming current are reported too */
+	path = g_build_filename (git_dir, "u.txt", NULL);
+	g_unlink (path);
+	g_free (path);
+
+	g_ptr_array_set_size (changed, 0);
+
+	ggit_status_monitor_mark_dirty (monitor, "u.txt");
+	ggit_status_monitor_refresh (monitor, &err);
+	g_assert_no_error (err);
+
+	g_assert_cmpuint (changed->len, ==, 1);
+	g_assert (str_ptr_array_contains (changed, "u.txt"));
+	g_assert_cmpuint (ggit_status_monitor_get_status (monitor, "u.txt"), ==, GGIT_STATUS_CURRENT);
+
+	/* Directories */
+	path = g_build_filename (git_dir, "d", NULL);
+	g_mkdir (path, 0755);
+	g_free (path);
+
+	write_workdir_file (git_dir, "d/x.txt", "x\n");
+
+	ggit_status_monitor_mark_dirty (monitor, "d");
+	ggit_status_monitor_refresh (monitor, &err);
+	g_assert_no_error (err);
+
+	g_assert_cmpuint (ggit_status_monitor_get_status (monitor, "d/x.txt"), ==, GGIT_STATUS_WORKING_TREE_NEW);
+
+	path = g_build_filename (git_dir, "d", "x.txt", NULL);
+	g_unlink (path);
+	g_free (path);
+
+	path = g_build_filename (git_dir, "d", NULL);
+	g_rmdir (path);
+	g_free (path);
+
+	g_ptr_array_set_size (changed, 0);
+
+	ggit_status_monitor_mark_dirty (monitor, "d");
+	ggit_status_monitor_refresh (monitor, &err);
+	g_assert_no_error (err);
+
+	g_assert (str_ptr_array_contains (changed, "d/x.txt"));
+	g_assert_cmpuint (ggit_status_monitor_get_status (monitor, "d/x.txt"), ==, GGIT_STATUS_CURRENT);
+
+	assert_status_monitor_matches_rescan (monitor);
+
+	g_ptr_array_unref (changed);
+	g_object_unref (monitor);
+	g_object_unref (repo);
+}
+
+static void
+status_monitor_count_cb (GgitStatusMonitor  *monitor,
+                         gchar             **paths,
+                         GgitStatusList     *status_list,
+                         guint              *n_emissions)
+{
+	++*n_emissions;
+}
+
+static gboolean
+wake_up_cb (gpointer user_data)
+{
+	return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+wait_for_status (GgitStatusMonitor *monitor,
+                 const gchar       *path,
+                 GgitStatusFlags    status)
+{
+	gint64 deadline;
+	guint wake_up;
+	gboolean ret = TRUE;
+
+	/* File monitor events arrive asynchronously, give them some time */
+	deadline = g_get_monotonic_time () + 10 * G_USEC_PER_SEC;
+	wake_up = g_timeout_add (100, wake_up_cb, NULL);
+
+	while (ggit_status_monitor_get_status (monitor, path) != status)
+	{
+		if (g_get_monotonic_time () > deadline)
+		{
+			ret = FALSE;
+			break;
+		}
+
+		g_main_context_iteration (NULL, TRUE);
+	}
+
+	g_source_remove (wake_up);
+
+	return ret;
+}
+
+/* Commit the index on top of HEAD with ggit_repository_create_commit() */
+static void
+commit_index (GgitRepository *repo,
+              gboolean        with_parent)
+{
+	GError *err = NULL;
+	GgitIndex *idx;
+	GgitOId *toid;
+	GgitOId *cid;
+	GgitTree *tree;
+	GgitRef *head;
+	GgitCommit *parent = NULL;
+	GgitSignature *author;
+
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	toid = ggit_index_write_tree (idx, &err);
+	g_assert_no_error (err);
+	g_object_unref (idx);
+
+	tree = ggit_repository_lookup_tree (repo, toid, &err);
+	g_assert_no_error (err);
+	ggit_oid_free (toid);
+
+	if (with_parent)
+	{
+		head = ggit_repository_get_head (repo, &err);
+		g_assert_no_error (err);
+
+		parent = GGIT_COMMIT (ggit_ref_lookup (head, &err));
+		g_assert_no_error (err);
+		g_object_unref (head);
+	}
+
+	author = ggit_signature_new_now ("Jesse van den Kieboom",
+	                                 "jessevdk@gnome.org",
+	                                 &err);
+	g_assert_no_error (err);
+
+	cid = ggit_repository_create_commit (repo,
+	                                     "HEAD",
+	                                     author,
+	                                     author,
+	                                     NULL,
+	                                     "commit",
+	                                     tree,
+	                                     parent != NULL ? &parent : NULL,
+	                                     parent != NULL ? 1 : 0,
+	                                     &err);
+	g_assert_no_error (err);
+	g_assert (cid != NULL);
+
+	ggit_oid_free (cid);
+	g_object_unref (author);
+	g_object_unref (tree);
+	g_clear_object (&parent);
+}
+
+static void
+test_repository_status_monitor_events (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitStatusMonitor *monitor;
+	GgitIndex *idx;
+	GFile *file;
+	GgitOId *oid;
+	GPtrArray *changed;
+	guint n_emissions = 0;
+	gchar *path;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+
+	g_assert_no_error (err);
+
+	oid = create_commit (repo, NULL, "a.txt", "a\n");
+	ggit_oid_free (oid);
+
+	path = g_build_filename (git_dir, "d", NULL);
+	g_mkdir (path, 0755);
+	g_free (path);
+
+	monitor = ggit_status_monitor_new (repo, &err);
+	g_assert_no_error (err);
+
+	changed = g_ptr_array_new_with_free_func (g_free);
+	g_signal_connect (monitor, "changed", G_CALLBACK (status_monitor_changed_cb), changed);
+	g_signal_connect (monitor, "changed", G_CALLBACK (status_monitor_count_cb), &n_emissions);
+
+	/* Changes close together are refreshed at once, from the main loop */
+	write_workdir_file (git_dir, "b.txt", "b\n");
+	write_workdir_file (git_dir, "c.txt", "c\n");
+
+	ggit_status_monitor_mark_dirty (monitor, "b.txt");
+	ggit_status_monitor_mark_dirty (monitor, "c.txt");
+
+	g_assert_cmpuint (n_emissions, ==, 0);
+
+	g_assert (wait_for_status (monitor, "b.txt", GGIT_STATUS_WORKING_TREE_NEW));
+	g_assert (wait_for_status (monitor, "c.txt", GGIT_STATUS_WORKING_TREE_NEW));
+
+	g_assert_cmpuint (n_emissions, ==, 1);
+	g_assert (str_ptr_array_contains (changed, "b.txt"));
+	g_assert (str_ptr_array_contains (changed, "c.txt"));
+
+	/* Changes reported by the file monitors, including in directories
+	 * which were watched when creating the monitor */
+	g_ptr_array_set_size (changed, 0);
+	write_workdir_file (git_dir, "a.txt", "aa\n");
+
+	g_assert (wait_for_status (monitor, "a.txt", GGIT_STATUS_WORKING_TREE_MODIFIED));
+	g_assert (str_ptr_array_contains (changed, "a.txt"));
+
+	write_workdir_file (git_dir, "d/x.txt", "x\n");
+	g_assert (wait_for_status (monitor, "d/x.txt", GGIT_STATUS_WORKING_TREE_NEW));
+
+	/* and in directories created afterwards */
+	path = g_build_filename (git_dir, "d", "e", NULL);
+	g_mkdir (path, 0755);
+	g_free (path);
+
+	write_workdir_file (git_dir, "d/e/y.txt", "y\n");
+	g_assert (wait_for_status (monitor, "d/e/y.txt", GGIT_STATUS_WORKING_TREE_NEW));
+
+	/* Staging only changes the index, which causes a full refresh */
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	file = g_file_get_child (f, "b.txt");
+	ggit_index_add_file (idx, file, &err);
+	g_assert_no_error (err);
+	g_object_unref (file);
+
+	ggit_index_write (idx, &err);
+	g_assert_no_error (err);
+	g_object_unref (idx);
+
+	g_assert (wait_for_status (monitor, "b.txt", GGIT_STATUS_INDEX_NEW));
+
+	/* Committing only changes the branch HEAD points to */
+	commit_index (repo, TRUE);
+	g_assert (wait_for_status (monitor, "b.txt", GGIT_STATUS_CURRENT));
+
+	/* Moving HEAD to an unborn branch causes a full refresh too */
+	ggit_repository_set_head (repo, "refs/heads/unborn", &err);
+	g_assert_no_error (err);
+
+	g_assert (wait_for_status (monitor, "a.txt", GGIT_STATUS_INDEX_NEW | GGIT_STATUS_WORKING_TREE_MODIFIED));
+
+	/* and the new branch is watched from then on */
+	commit_index (repo, FALSE);
+	g_assert (wait_for_status (monitor, "a.txt", GGIT_STATUS_WORKING_TREE_MODIFIED));
+
+	assert_status_monitor_matches_rescan (monitor);
+
+	g_ptr_array_unref (changed);
+	g_object_unref (monitor);
+	g_object_unref (repo);
+	g_object_unref (f);
+}
+
+static void
+test_repository_status_monitor_perf (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitStatusMonitor *monitor;
+	GgitStatusList *list;
+	GgitIndex *idx;
+	GgitOId *tree_id;
+	GgitOId *oid;
+	GgitSignature *sig;
+	const gchar *all[] = { "*", NULL };
+	guint n_dirs = g_test_perf () ? 200 : 20;
+	guint i;
+	guint j;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	for (i = 0; i < n_dirs; ++i)
+	{
+		gchar *dir;
+
+		dir = g_strdup_printf ("%s/dir%u", git_dir, i);
+		g_mkdir (dir, 0755);
+		g_free (dir);
+
+		for (j = 0; j < 100; ++j)
+		{
+			gchar *name;
+
+			name = g_strdup_printf ("dir%u/file%u.txt", i, j);
+			write_workdir_file (git_dir, name, name);
+			g_free (name);
+		}
+	}
+
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	ggit_index_add_all (idx, all, GGIT_INDEX_ADD_DEFAULT, NULL, NULL, &err);
+	g_assert_no_error (err);
+
+	ggit_index_write (idx, &err);
+	g_assert_no_error (err);
+
+	tree_id = ggit_index_write_tree (idx, &err);
+	g_assert_no_error (err);
+	g_object_unref (idx);
+
+	sig = ggit_signature_new_now ("Jesse van den Kieboom",
+	                              "jessevdk@gnome.org",
+	                              &err);
+	g_assert_no_error (err);
+
+	oid = ggit_repository_create_commit_from_ids (repo, "HEAD", sig, sig, NULL,
+	                                              "many files\n", tree_id,
+	                                              NULL, 0, &err);
+	g_assert_no_error (err);
+
+	ggit_oid_free (oid);
+	ggit_oid_free (tree_id);
+	g_object_unref (sig);
+
+	monitor = ggit_status_monitor_new (repo, &err);
+	g_assert_no_error (err);
+
+	write_workdir_file (git_dir, "dir0/file0.txt", "changed");
+
+	/* Refreshing a single changed file */
+	g_test_timer_start ();
+
+	ggit_status_monitor_mark_dirty (monitor, "dir0/file0.txt");
+	ggit_status_monitor_refresh (monitor, &err);
+	g_assert_no_error (err);
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "incremental refresh of 1 out of %u files in %f seconds",
+	                         n_dirs * 100,
+	                         g_test_timer_last ());
+
+	g_assert_cmpuint (ggit_status_monitor_get_status (monitor, "dir0/file0.txt"),
+	                  ==,
+	                  GGIT_STATUS_WORKING_TREE_MODIFIED);
+
+	/* Compared to rescanning the whole working directory */
+	g_test_timer_start ();
+
+	list = ggit_repository_get_status_list (repo, NULL, &err);
+	g_assert_no_error (err);
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "full rescan of %u files in %f seconds",
+	                         n_dirs * 100,
+	                         g_test_timer_last ());
+
+	g_assert_cmpuint (ggit_status_list_get_size (list), ==, 1);
+
+	g_object_unref (list);
+	g_object_unref (monitor);
+	g_object_unref (repo);
+}
+
+static gint
+collect_status_cb (const gchar     *path,
+                   GgitStatusFlags  status_flags,
+                   gpointer         user_data)
+{
+	GPtrArray *array = user_data;
+
+	g_ptr_array_add (array, g_strdup_printf ("%s:%u", path, status_flags));
+	return 0;
+}
+
+static void
+assert_str_ptr_arrays_equal (GPtrArray *a,
+                             GPtrArray *b)
+{
+	guint i;
+
+	g_assert_cmpuint (a->len, ==, b->len);
+
+	for (i = 0; i < a->len; ++i)
+	{
+		g_assert_cmpstr (g_ptr_array_index (a, i), ==, g_ptr_array_index (b, i));
+	}
+}
+
+static void
+status_parallel_compare (GgitRepository *repo,
+                         GPtrArray      *serial,
+                         GPtrArray      *parallel)
+{
+	GError *err = NULL;
+
+	g_ptr_array_set_size (serial, 0);
+	g_ptr_array_set_size (parallel, 0);
+
+	ggit_repository_file_status_foreach (repo, NULL, collect_status_cb, serial, &err);
+	g_assert_no_error (err);
+
+	ggit_repository_file_status_foreach_parallel (repo, NULL, 4, collect_status_cb, parallel, &err);
+	g_assert_no_error (err);
+
+	assert_str_ptr_arrays_equal (parallel, serial);
+}
+
+static void
+test_repository_status_parallel (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitOId *parent;
+	GgitOId *oid;
+	GgitIndex *idx;
+	GgitConfig *config;
+	GFile *file;
+	GPtrArray *serial;
+	GPtrArray *parallel;
+	const gchar *dirs[] = { "a", "c", "d", "e" };
+	gchar *path;
+	gchar *other;
+	guint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+
+	g_assert_no_error (err);
+
+	for (i = 0; i < G_N_ELEMENTS (dirs); ++i)
+	{
+		path = g_build_filename (git_dir, dirs[i], NULL);
+		g_mkdir (path, 0755);
+		g_free (path);
+	}
+
+	parent = create_commit (repo, NULL, "a/x", "x\n");
+	oid = create_commit (repo, parent, "c/y", "y\n");
+	ggit_oid_free (parent);
+	parent = oid;
+	oid = create_commit (repo, parent, "b", "b\n");
+	ggit_oid_free (parent);
+	parent = oid;
+	oid = create_commit (repo, parent, "d/z", "z\n");
+	ggit_oid_free (parent);
+	ggit_oid_free (oid);
+
+	/* modified, new, deleted and untracked files across the shards */
+	write_workdir_file (git_dir, "a/x", "xx\n");
+	write_workdir_file (git_dir, "a/w", "w\n");
+	write_workdir_file (git_dir, "b", "bb\n");
+	write_workdir_file (git_dir, "bb", "bb\n");
+	write_workdir_file (git_dir, "e/new", "new\n");
+
+	path = g_build_filename (git_dir, "d", "z", NULL);
+	g_unlink (path);
+	g_free (path);
+
+	path = g_build_filename (git_dir, "d", NULL);
+	g_rmdir (path);
+	g_free (path);
+
+	serial = g_ptr_array_new_with_free_func (g_free);
+	parallel = g_ptr_array_new_with_free_func (g_free);
+
+	ggit_repository_file_status_foreach (repo, NULL, collect_status_cb, serial, &err);
+	g_assert_no_error (err);
+
+	ggit_repository_file_status_foreach_parallel (repo, NULL, 4, collect_status_cb, parallel, &err);
+	g_assert_no_error (err);
+
+	g_assert_cmpuint (serial->len, ==, 6);
+	g_assert_cmpuint (parallel->len, ==, serial->len);
+
+	assert_str_ptr_arrays_equal (parallel, serial);
+
+	/* Changes to the index which were not written yet are taken into
+	 * account */
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	file = g_file_get_child (f, "bb");
+	ggit_index_add_file (idx, file, &err);
+	g_assert_no_error (err);
+	g_object_unref (file);
+
+	status_parallel_compare (repo, serial, parallel);
+	g_assert (str_ptr_array_contains (serial, "bb:1"));
+
+	ggit_index_write (idx, &err);
+	g_assert_no_error (err);
+	g_object_unref (idx);
+	g_object_unref (repo);
+
+	/* Top-level names differing only in case are a single shard */
+	repo = ggit_repository_open (f, &err);
+	g_assert_no_error (err);
+
+	config = ggit_repository_get_config (repo, &err);
+	g_assert_no_error (err);
+
+	ggit_config_set_bool (config, "core.ignorecase", TRUE, &err);
+	g_assert_no_error (err);
+	g_object_unref (config);
+	g_object_unref (repo);
+
+	path = g_build_filename (git_dir, "a", NULL);
+	other = g_build_filename (git_dir, "A", NULL);
+	g_assert_cmpint (g_rename (path, other), ==, 0);
+	g_free (path);
+	g_free (other);
+
+	repo = ggit_repository_open (f, &err);
+	g_assert_no_error (err);
+
+	status_parallel_compare (repo, serial, parallel);
+
+	g_ptr_array_unref (serial);
+	g_ptr_array_unref (parallel);
+	g_object_unref (repo);
+	g_object_unref (f);
+}
+
+static void
+test_repository_is_dirty (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitIndex *idx;
+	GgitOId *oid;
+	GgitIndexEntry *entry;
+	const gchar *b[] = { "b.txt", NULL };
+	gchar *path;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	/* Empty repository on an unborn branch */
+	g_assert (!ggit_repository_is_dirty (repo, GGIT_DIRTY_DEFAULT, &err));
+	g_assert_no_error (err);
+
+	oid = create_commit (repo, NULL, "a.txt", "a\n");
+	ggit_oid_free (oid);
+
+	g_assert (!ggit_repository_is_dirty (repo, GGIT_DIRTY_DEFAULT, &err));
+	g_assert_no_error (err);
+
+	/* Untracked */
+	write_workdir_file (git_dir, "b.txt", "b\n");
+
+	g_assert (ggit_repository_is_dirty (repo, GGIT_DIRTY_DEFAULT, &err));
+	g_assert_no_error (err);
+
+	g_assert (!ggit_repository_is_dirty (repo, GGIT_DIRTY_IGNORE_UNTRACKED, &err));
+	g_assert_no_error (err);
+
+	/* Staged */
+	idx = ggit_repository_get_index (repo, &err);
+	g_assert_no_error (err);
+
+	ggit_index_add_all (idx, b, GGIT_INDEX_ADD_DEFAULT, NULL, NULL, &err);
+	g_assert_no_error (err);
+
+	ggit_index_write (idx, &err);
+	g_assert_no_error (err);
+
+	g_assert (ggit_repository_is_dirty (repo, GGIT_DIRTY_IGNORE_UNTRACKED, &err));
+	g_assert_no_error (err);
+
+	ggit_index_remove_all (idx, b, NULL, NULL, &err);
+	g_assert_no_error (err);
+
+	ggit_index_write (idx, &err);
+	g_assert_no_error (err);
+	g_object_unref (idx);
+
+	path = g_build_filename (git_dir, "b.txt", NULL);
+	g_unlink (path);
+	g_free (path);
+
+	g_assert (!ggit_repository_is_dirty (repo, GGIT_DIRTY_DEFAULT, &err));
+	g_assert_no_error (err);
+
+	/* Staged through a second handle on the index file */
+	path = g_build_filename (git_dir, ".git", "index", NULL);
+	f = g_file_new_for_path (path);
+	g_free (path);
+
+	idx = ggit_index_open (f, &err);
+	g_assert_no_error (err);
+
+	oid = ggit_repository_create_blob_from_buffer (repo, "b\n", 2, &err);
+	g_assert_no_error (err);
+
+	entry = ggit_repository_create_index_entry_for_path (repo, "b.txt", oid, &err);
+	g_assert_no_error (err);
+	ggit_oid_free (oid);
+
+	ggit_index_add (idx, entry, &err);
+	g_assert_no_error (err);
+	ggit_index_entry_unref (entry);
+
+	ggit_index_write (idx, &err);
+	g_assert_no_error (err);
+
+	g_assert (ggit_repository_is_dirty (repo, GGIT_DIRTY_IGNORE_UNTRACKED, &err));
+	g_assert_no_error (err);
+
+	ggit_index_remove_all (idx, b, NULL, NULL, &err);
+	g_assert_no_error (err);
+
+	ggit_index_write (idx, &err);
+	g_assert_no_error (err);
+
+	g_object_unref (idx);
+	g_object_unref (f);
+
+	g_assert (!ggit_repository_is_dirty (repo, GGIT_DIRTY_DEFAULT, &err));
+	g_assert_no_error (err);
+
+	/* Modified */
+	write_workdir_file (git_dir, "a.txt", "aa\n");
+
+	g_assert (ggit_repository_is_dirty (repo, GGIT_DIRTY_IGNORE_UNTRACKED, &err));
+	g_assert_no_error (err);
+
+	g_object_unref (repo);
+}
+
+typedef struct
+{
+	GgitDiffDelta *delta;
+	GgitDiffHunk *hunk;
+	guint n_deltas;
+	guint n_hunks;
+	guint n_additions;
+	guint n_lines;
+} DiffIterationData;
+
+static gint
+diff_iteration_file_cb (GgitDiffDelta *delta,
+                        gfloat         progress,
+                        gpointer       user_data)
+{
+	DiffIterationData *data = user_data;
+
+	g_assert (delta != data->delta);
+
+	data->delta = delta;
+	data->n_deltas++;
+
+	return 0;
+}
+
+static gint
+diff_iteration_hunk_cb (GgitDiffDelta *delta,
+                        GgitDiffHunk  *hunk,
+                        gpointer       user_data)
+{
+	DiffIterationData *data = user_data;
+
+	g_assert (delta == data->delta);
+	g_assert (hunk != data->hunk);
+
+	data->hunk = hunk;
+	data->n_hunks++;
+
+	return 0;
+}
+
+static gint
+diff_iteration_line_cb (GgitDiffDelta *delta,
+                        GgitDiffHunk  *hunk,
+                        GgitDiffLine  *line,
+                        gpointer       user_data)
+{
+	DiffIterationData *data = user_data;
+
+	/* The wrappers are reused for all the lines */
+	g_assert (delta == data->delta);
+	g_assert (hunk == data->hunk);
+
+	if (ggit_diff_line_get_origin (line) == GGIT_DIFF_LINE_ADDITION)
+	{
+		gint lineno = ggit_diff_line_get_new_lineno (line);
+
+		/* The line must belong to the hunk it is reported with */
+		g_assert_cmpint (lineno, >=, ggit_diff_hunk_get_new_start (hunk));
+		g_assert_cmpint (lineno, <, ggit_diff_hunk_get_new_start (hunk) + ggit_diff_hunk_get_new_lines (hunk));
+
+		data->n_additions++;
+	}
+
+	data->n_lines++;
+	return 0;
+}
+
+static void
+test_repository_diff_iteration (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GString *old_contents;
+	GString *new_contents;
+	GgitOId *old_id;
+	GgitOId *new_id;
+	GgitBlob *old_blob;
+	GgitBlob *new_blob;
+	GgitTreeBuilder *old_builder;
+	GgitTreeBuilder *new_builder;
+	GgitTree *old_tree;
+	GgitTree *new_tree;
+	GgitDiff *diff;
+	DiffIterationData data = { 0, };
+	guint n = g_test_perf () ? 200000 : 20000;
+	guint n_files = g_test_perf () ? 200 : 20;
+	guint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	old_contents = g_string_new (NULL);
+	new_contents = g_string_new (NULL);
+
+	/* One changed line every 100 lines, each in its own hunk */
+	for (i = 0; i < n; ++i)
+	{
+		g_string_append_printf (old_contents, "line %u\n", i);
+		g_string_append_printf (new_contents, i % 100 == 50 ? "changed %u\n" : "line %u\n", i);
+	}
+
+	old_id = ggit_repository_create_blob_from_buffer (repo, old_contents->str, old_contents->len, &err);
+	g_assert_no_error (err);
+
+	new_id = ggit_repository_create_blob_from_buffer (repo, new_contents->str, new_contents->len, &err);
+	g_assert_no_error (err);
+
+	old_blob = ggit_repository_lookup_blob (repo, old_id, &err);
+	g_assert_no_error (err);
+
+	new_blob = ggit_repository_lookup_blob (repo, new_id, &err);
+	g_assert_no_error (err);
+
+	g_test_timer_start ();
+
+	ggit_diff_blobs (old_blob, "file",
+	                 new_blob, "file",
+	                 NULL,
+	                 diff_iteration_file_cb,
+	                 NULL,
+	                 diff_iteration_hunk_cb,
+	                 diff_iteration_line_cb,
+	                 &data,
+	                 &err);
+	g_assert_no_error (err);
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "iterated %u diff lines in %f seconds",
+	                         data.n_lines,
+	                         g_test_timer_last ());
+
+	g_assert_cmpuint (data.n_deltas, ==, 1);
+	g_assert_cmpuint (data.n_hunks, ==, n / 100);
+	g_assert_cmpuint (data.n_additions, ==, n / 100);
+	g_assert_cmpuint (data.n_lines, ==, n / 100 * 8);
+
+	g_object_unref (old_blob);
+	g_object_unref (new_blob);
+	ggit_oid_free (old_id);
+	ggit_oid_free (new_id);
+
+	/* The same changes spread over the files of a repository diff, so
+	 * the hunk wrappers also have to be replaced for every new delta.
+	 */
+	old_builder = ggit_repository_create_tree_builder (repo, &err);
+	g_assert_no_error (err);
+
+	new_builder = ggit_repository_create_tree_builder (repo, &err);
+	g_assert_no_error (err);
+
+	for (i = 0; i < n_files; ++i)
+	{
+		GgitTreeEntry *entry;
+		gchar *name;
+		guint j;
+
+		g_string_truncate (old_contents, 0);
+		g_string_truncate (new_contents, 0);
+
+		for (j = 0; j < 1000; ++j)
+		{
+			g_string_append_printf (old_contents, "line %u\n", j);
+			g_string_append_printf (new_contents, j % 100 == 50 ? "changed %u\n" : "line %u\n", j);
+		}
+
+		name = g_strdup_printf ("file%04u.txt", i);
+
+		old_id = ggit_repository_create_blob_from_buffer (repo, old_contents->str, old_contents->len, &err);
+		g_assert_no_error (err);
+
+		new_id = ggit_repository_create_blob_from_buffer (repo, new_contents->str, new_contents->len, &err);
+		g_assert_no_error (err);
+
+		entry = ggit_tree_builder_insert (old_builder, name, old_id, GGIT_FILE_MODE_BLOB, &err);
+		g_assert_no_error (err);
+		ggit_tree_entry_unref (entry);
+
+		entry = ggit_tree_builder_insert (new_builder, name, new_id, GGIT_FILE_MODE_BLOB, &err);
+		g_assert_no_error (err);
+		ggit_tree_entry_unref (entry);
+
+		ggit_oid_free (old_id);
+		ggit_oid_free (new_id);
+		g_free (name);
+	}
+
+	old_id = ggit_tree_builder_write (old_builder, &err);
+	g_assert_no_error (err);
+
+	new_id = ggit_tree_builder_write (new_builder, &err);
+	g_assert_no_error (err);
+
+	old_tree = ggit_repository_lookup_tree (repo, old_id, &err);
+	g_assert_no_error (err);
+
+	new_tree = ggit_repository_lookup_tree (repo, new_id, &err);
+	g_assert_no_error (err);
+
+	diff = ggit_diff_new_tree_to_tree (repo, old_tree, new_tree, NULL, &err);
+	g_assert_no_error (err);
+
+	memset (&data, 0, sizeof (data));
+	g_test_timer_start ();
+
+	ggit_diff_foreach (diff,
+	                   diff_iteration_file_cb,
+	                   NULL,
+	                   diff_iteration_hunk_cb,
+	                   diff_iteration_line_cb,
+	                   &data,
+	                   &err);
+	g_assert_no_error (err);
+
+	g_test_minimized_result (g_test_timer_elapsed (),
+	                         "iterated %u diff lines in %u files in %f seconds",
+	                         data.n_lines,
+	                         data.n_deltas,
+	                         g_test_timer_last ());
+
+	g_assert_cmpuint (data.n_deltas, ==, n_files);
+	g_assert_cmpuint (data.n_hunks, ==, n_files * 10);
+	g_assert_cmpuint (data.n_additions, ==, n_files * 10);
+	g_assert_cmpuint (data.n_lines, ==, n_files * 10 * 8);
+
+	g_string_free (old_contents, TRUE);
+	g_string_free (new_contents, TRUE);
+	g_object_unref (diff);
+	g_object_unref (old_tree);
+	g_object_unref (new_tree);
+	g_object_unref (old_builder);
+	g_object_unref (new_builder);
+	ggit_oid_free (old_id);
+	ggit_oid_free (new_id);
+	g_object_unref (repo);
+}
+
+typedef struct
+{
+	GPtrArray *texts;
+	GPtrArray *kept;
+} BorrowedLinesData;
+
+static gint
+borrowed_lines_cb (GgitDiffDelta *delta,
+                   GgitDiffHunk  *hunk,
+                   GgitDiffLine  *line,
+                   gpointer       user_data)
+{
+	BorrowedLinesData *data = user_data;
+
+	g_ptr_array_add (data->texts, g_strdup (ggit_diff_line_get_text (line)));
+
+	/* Keep some lines both by copying and by taking a reference */
+	if (data->kept != NULL && data->texts->len % 2 == 0)
+	{
+		g_ptr_array_add (data->kept, ggit_diff_line_copy (line));
+	}
+	else if (data->kept != NULL)
+	{
+		g_ptr_array_add (data->kept, ggit_diff_line_ref (line));
+	}
+
+	return 0;
+}
+
+static void
+test_repository_diff_borrowed_lines (const gchar *git_dir)
+{
+	GFile *f;
+	GgitRepository *repo;
+	GError *err = NULL;
+	GgitDiff *diff;
+	GgitOId *oid;
+	BorrowedLinesData copied = { 0, };
+	BorrowedLinesData borrowed = { 0, };
+	guint i;
+
+	f = g_file_new_for_path (git_dir);
+	repo = ggit_repository_init_repository (f, FALSE, &err);
+	g_object_unref (f);
+
+	g_assert_no_error (err);
+
+	oid = create_commit (repo, NULL, "a.txt", "one\ntwo\nthree\nfour\n");
+	ggit_oid_free (oid);
+
+	write_workdir_file (git_dir, "a.txt", "one\n2\nthree\nfour\nfive\n");
+
+	diff = ggit_diff_new_index_to_workdir (repo, NULL, NULL, &err);
+	g_assert_no_error (err);
+
+	copied.texts = g_ptr_array_new_with_free_func (g_free);
+	borrowed.texts = g_ptr_array_new_with_free_func (g_free);
+	borrowed.kept = g_ptr_array_new_with_free_func ((GDestroyNotify)ggit_diff_line_unref);
+
+	ggit_diff_foreach (diff, NULL, NULL, NULL, borrowed_lines_cb, &copied, &err);
+	g_assert_no_error (err);
+
+	ggit_diff_foreach_full (diff,
+	                        GGIT_DIFF_FOREACH_BORROW_LINES,
+	                        NULL, NULL, NULL,
+	                        borrowed_lines_cb,
+	                        &borrowed,
+	                        &err);
+	g_assert_no_error (err);
+
+	g_assert_cmpuint (copied.texts->len, >, 0);
+	g_assert_cmpuint (borrowed.texts->len, ==, copied.texts->len);
+	g_assert_cmpuint (borrowed.kept->len, ==, copied.texts->len);
+
+	/* Copied and referenced lines outlive the iteration */
+	for (i = 0; i < copied.texts->len; ++i)
+	{
+		GgitDiffLine *line;
+		const guint8 *content;
+		gsize len;
+
+		g_assert_cmpstr (g_ptr_array_index (borrowed.texts, i), ==, g_ptr_array_index (copied.texts, i));
+
+		line = g_ptr_array_index (borrowed.kept, i);
+		g_assert_cmpstr (ggit_diff_line_get_text (line), ==, g_ptr_array_index (copied.texts, i));
+
+		content = ggit_diff_line_get_content (line, &len);
+		g_assert_cmpuint (len, ==, strlen (g_ptr_array_index (copied.texts, i)));
+		g_assert (memcmp (content, g_ptr_array_index (copied.texts, i), len) == 0);
+	}
+
+	g_ptr_array_unref (copied.texts);
+	g_ptr_array_unref (borrowed.texts);
+	g_ptr_array_unref (borrowed.kept);
+	g_object_unref (diff);
+	g_object_unref (repo);
+}
+
 int
 main (int    argc,
       char **argv)
@@ -376,7 +4340,40 @@ main (int    argc,
 	TEST ("init", init);
 	TEST ("init-bare", init_bare);
 	TEST ("blob-stream", blob_stream);
+	TEST ("blob-content-bytes-perf", blob_content_bytes_perf);
 	TEST ("encoding", encoding);
+	TEST ("walk-next-n", walk_next_n);
+	TEST ("walk-next-n-perf", walk_next_n_perf);
+	TEST ("open-async", open_async);
+	TEST ("remote-async", remote_async);
+	TEST ("fetch-scheduler", fetch_scheduler);
+	TEST ("object-cache", object_cache);
+	TEST ("object-cache-perf", object_cache_perf);
+	TEST ("object-factory", object_factory);
+	TEST ("object-factory-perf", object_factory_perf);
+	TEST ("lookup-many", lookup_many);
+	TEST ("read-object-header", read_object_header);
+	TEST ("blob-input-stream", blob_input_stream);
+	TEST ("create-blobs-from-files", create_blobs_from_files);
+	TEST ("blob-stream-buffered", blob_stream_buffered);
+	TEST ("blob-stream-perf", blob_stream_perf);
+	TEST ("hash-file", hash_file);
+	TEST ("tree-iterator", tree_iterator);
+	TEST ("tree-get-by-paths", tree_get_by_paths);
+	TEST ("tree-create-updated", tree_create_updated);
+	TEST ("index-snapshot", index_snapshot);
+	TEST ("index-snapshot-perf", index_snapshot_perf);
+	TEST ("index-add-all", index_add_all);
+	TEST ("index-add-all-perf", index_add_all_perf);
+	TEST ("index-reload", index_reload);
+	TEST ("status-list", status_list);
+	TEST ("status-monitor", status_monitor);
+	TEST ("status-monitor-events", status_monitor_events);
+	TEST ("status-monitor-perf", status_monitor_perf);
+	TEST ("status-parallel", status_parallel);
+	TEST ("is-dirty", is_dirty);
+	TEST ("diff-iteration", diff_iteration);
+	TEST ("diff-borrowed-lines", diff_borrowed_lines);
 
 	return g_test_run ();
 }